@@ -9,6 +9,7 @@
 #include "RenderingSettings.hpp"
 #include "AssetDatabase.hpp"
 #include "ECSSettings.hpp"
+#include "EventBus.hpp"
 #include "ShaderParserSettings.hpp"
 #include "ECS/Registry.hpp"
 #include "SplitEngine/Audio/Manager.hpp"
@@ -33,6 +34,7 @@ namespace SplitEngine
 			[[nodiscard]] Window& GetWindow();
 
 			AssetDatabase& GetAssetDatabase();
+			EventBus&      GetEventBus();
 			ECS::Registry& GetECSRegistry();
 
 		private:
@@ -41,6 +43,7 @@ namespace SplitEngine
 
 			Rendering::Renderer _renderer;
 			Audio::Manager      _audioManager;
+			EventBus            _eventBus;
 			ECS::Registry       _ecsRegistry;
 
 			AssetDatabase _assetDatabase;
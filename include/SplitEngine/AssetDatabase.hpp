@@ -7,6 +7,8 @@
 #include <functional>
 #include <ranges>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace SplitEngine
 {
@@ -46,16 +48,30 @@ namespace SplitEngine
 			}
 
 			template<typename T, typename TKey>
-			[[nodiscard]] AssetHandle<T> CreateAsset(TKey key, typename T::CreateInfo&& createInfo)
+			[[nodiscard]] AssetHandle<T> CreateAsset(TKey key, typename T::CreateInfo&& createInfo) { return RegisterAsset<T>(key, new T(std::move(createInfo))); }
+
+			/**
+			 * Creates multiple assets of the same type at once.
+			 * If the asset type provides a static CreateBatch function (like Shader) it's used so the assets can be created in parallel, otherwise they're created one after another.
+			 */
+			template<typename T, typename TKey>
+			[[nodiscard]] std::vector<AssetHandle<T>> CreateAssets(std::vector<std::pair<TKey, typename T::CreateInfo>>&& entries)
 			{
-				T* pointer                                 = new T(std::move(createInfo));
-				GetAssets<T>()[static_cast<uint64_t>(key)] = pointer;
+				std::vector<AssetHandle<T>> handles{};
+				handles.reserve(entries.size());
 
-				_assetDeletionList.push_back([pointer] {
-					delete pointer;
-				});
+				if constexpr (requires(std::vector<typename T::CreateInfo>&& createInfos) { T::CreateBatch(std::move(createInfos)); })
+				{
+					std::vector<typename T::CreateInfo> createInfos{};
+					createInfos.reserve(entries.size());
+					for (auto& createInfo: entries | std::views::values) { createInfos.push_back(std::move(createInfo)); }
 
-				return AssetHandle<T>(pointer, static_cast<uint64_t>(key));
+					auto assets = T::CreateBatch(std::move(createInfos));
+					for (size_t i = 0; i < entries.size(); ++i) { handles.push_back(RegisterAsset<T>(entries[i].first, assets[i].release())); }
+				}
+				else { for (auto& [key, createInfo]: entries) { handles.push_back(CreateAsset<T>(key, std::move(createInfo))); } }
+
+				return handles;
 			}
 
 			template<typename T>
@@ -73,6 +89,18 @@ namespace SplitEngine
 
 		private:
 			std::vector<std::function<void()>> _assetDeletionList;
+
+			template<typename T, typename TKey>
+			AssetHandle<T> RegisterAsset(TKey key, T* pointer)
+			{
+				GetAssets<T>()[static_cast<uint64_t>(key)] = pointer;
+
+				_assetDeletionList.push_back([pointer] {
+					delete pointer;
+				});
+
+				return AssetHandle<T>(pointer, static_cast<uint64_t>(key));
+			}
 	};
 
 }
@@ -1,14 +1,45 @@
 #pragma once
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace SplitEngine
 {
+	struct GpuPipelineStatistics
+	{
+		uint64_t InputAssemblyVertices     = 0;
+		uint64_t InputAssemblyPrimitives   = 0;
+		uint64_t VertexShaderInvocations   = 0;
+		uint64_t ClippingPrimitives        = 0;
+		uint64_t FragmentShaderInvocations = 0;
+		uint64_t ComputeShaderInvocations  = 0;
+	};
+
+	struct GpuMemoryHeapStatistics
+	{
+		uint64_t UsageInBytes     = 0; // Used by this process, as reported by the driver if VK_EXT_memory_budget is available and estimated otherwise
+		uint64_t BudgetInBytes    = 0; // What this process can use before allocations start to fail or get slow
+		uint64_t ReservedInBytes  = 0; // Device memory blocks VMA allocated from this heap
+		uint64_t AllocatedInBytes = 0; // Part of the reserved blocks that is actually in use, the rest is free space or fragmentation
+		bool     DeviceLocal      = false;
+	};
+
 	struct Statistics
 	{
-		uint64_t           AverageFPS            = 0;
-		float              AverageDeltaTime      = 0.0f;
-		std::vector<float> AverageECSStageTimeMs = std::vector<float>(UINT8_MAX, 0); // numeric_limits not used because soloud overrides the max function by importing some fuckass windows library
+		uint64_t              AverageFPS            = 0;
+		float                 AverageDeltaTime      = 0.0f;
+		std::vector<float>    AverageECSStageTimeMs = std::vector<float>(UINT8_MAX, 0); // numeric_limits not used because soloud overrides the max function by importing some fuckass windows library
+		std::vector<uint64_t> ECSSystemBudgetOverruns{}; // Frames in the last statistics window in which a single slice of a budgeted system exceeded its time budget, indexed by system ID
+
+		// Gpu times are measured with timestamp queries and lag as many frames behind as there are frames in flight, if the cpu spends a good part of the frame waiting on the gpu the frame is gpu bound
+		float                                  AverageGpuFrameTimeMs      = 0.0f;
+		float                                  AverageGpuRenderPassTimeMs = 0.0f;
+		float                                  AverageGpuWaitTimeMs       = 0.0f;
+		std::unordered_map<std::string, float> AverageGpuZoneTimeMs{};
+		GpuPipelineStatistics                  AverageGpuPipelineStatistics{}; // Only filled if pipeline statistics are enabled in the rendering settings
+
+		std::vector<GpuMemoryHeapStatistics> GpuMemoryHeaps{}; // Indexed by memory heap, sampled once per statistics window
 	};
 
 	struct TimeContext
@@ -19,6 +50,7 @@ namespace SplitEngine
 	class Application;
 	class AssetDatabase;
 	class SDLEventSystem;
+	class EventBus;
 
 	struct EngineContext
 	{
@@ -26,6 +58,7 @@ namespace SplitEngine
 		AssetDatabase*  AssetDatabase = nullptr;
 		Statistics      Statistics{};
 		SDLEventSystem* EventSystem = nullptr;
+		EventBus*       EventBus    = nullptr;
 	};
 
 	namespace Rendering
@@ -3,10 +3,14 @@
 #include "SplitEngine/Debug/Log.hpp"
 #include <glm/exponential.hpp>
 
+#include <algorithm>
+#include <array>
 #include <vector>
 
-#define PRIVATE_COMPARE_SIZE(var) \
-	if (_numBits != var._numBits) { LOG_FATAL("can't compare 2 signatures that have different sizes"); }
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define PRIVATE_BITSET_USE_SSE2
+	#include <emmintrin.h>
+#endif
 
 namespace SplitEngine
 {
@@ -31,6 +35,11 @@ namespace SplitEngine
 	template<class T>
 	uint64_t TypeIDGenerator<T>::_count = 0;
 
+	/**
+	 * Bitsets with up to 256 bits are stored inline, bigger ones spill onto the heap.
+	 * Comparisons treat missing masks as zero, so bitsets of different sizes can be compared.
+	 * Setting a bit past the current size grows the bitset, so it never has to be sized up front.
+	 */
 	class DynamicBitSet
 	{
 		public:
@@ -41,13 +50,13 @@ namespace SplitEngine
 			void ExtendSizeTo(const uint64_t newSize)
 			{
 				_numBits = newSize;
-				while (_numBits > _masks.size() * MASK_SIZE) { _masks.push_back(0); }
+				Reserve((_numBits + MASK_SIZE - 1) / MASK_SIZE);
 			}
 
 			void ExtendSizeBy(const uint64_t amountToIncrease = 1)
 			{
 				_numBits += amountToIncrease;
-				while (_numBits > _masks.size() * MASK_SIZE) { _masks.push_back(0); }
+				Reserve((_numBits + MASK_SIZE - 1) / MASK_SIZE);
 			}
 
 			void SetBit(const uint64_t bitIndex)
@@ -55,7 +64,14 @@ namespace SplitEngine
 				const uint64_t index         = bitIndex / MASK_SIZE;
 				const uint64_t relativeIndex = bitIndex - (index * MASK_SIZE);
 
-				_masks[index] |= static_cast<uint64_t>(1) << relativeIndex;
+				if (index >= _numMasks) { ExtendSizeTo(bitIndex + 1); }
+
+				uint64_t&      mask    = GetMasks()[index];
+				const uint64_t oldMask = mask;
+
+				mask |= static_cast<uint64_t>(1) << relativeIndex;
+
+				_hash ^= HashMask(oldMask, index) ^ HashMask(mask, index);
 			}
 
 			void UnsetBit(const uint64_t bitIndex)
@@ -63,7 +79,22 @@ namespace SplitEngine
 				const uint64_t index         = bitIndex / MASK_SIZE;
 				const uint64_t relativeIndex = bitIndex - (index * MASK_SIZE);
 
-				_masks[index] &= ~(static_cast<uint64_t>(1) << relativeIndex);
+				if (index >= _numMasks) { return; }
+
+				uint64_t&      mask    = GetMasks()[index];
+				const uint64_t oldMask = mask;
+
+				mask &= ~(static_cast<uint64_t>(1) << relativeIndex);
+
+				_hash ^= HashMask(oldMask, index) ^ HashMask(mask, index);
+			}
+
+			[[nodiscard]] bool IsBitSet(const uint64_t bitIndex) const
+			{
+				const uint64_t index         = bitIndex / MASK_SIZE;
+				const uint64_t relativeIndex = bitIndex - (index * MASK_SIZE);
+
+				return index < _numMasks && (GetMasks()[index] & (static_cast<uint64_t>(1) << relativeIndex)) != 0;
 			}
 
 			/**
@@ -71,9 +102,15 @@ namespace SplitEngine
 			 */
 			[[nodiscard]] bool Matches(const DynamicBitSet& other) const
 			{
-				PRIVATE_COMPARE_SIZE(other)
+				if (_hash != other._hash) { return false; }
+
+				const uint64_t* masks          = GetMasks();
+				const uint64_t* otherMasks     = other.GetMasks();
+				const uint64_t  numCommonMasks = std::min(_numMasks, other._numMasks);
 
-				for (uint64_t i = 0; i < _masks.size(); ++i) { if (_masks[i] != other._masks[i]) { return false; } }
+				for (uint64_t i = 0; i < numCommonMasks; ++i) { if (masks[i] != otherMasks[i]) { return false; } }
+				for (uint64_t i = numCommonMasks; i < _numMasks; ++i) { if (masks[i] != 0) { return false; } }
+				for (uint64_t i = numCommonMasks; i < other._numMasks; ++i) { if (otherMasks[i] != 0) { return false; } }
 
 				return true;
 			}
@@ -86,18 +123,84 @@ namespace SplitEngine
 			 */
 			[[nodiscard]] bool FuzzyMatches(const DynamicBitSet& other) const
 			{
-				PRIVATE_COMPARE_SIZE(other)
+				const uint64_t* masks          = GetMasks();
+				const uint64_t* otherMasks     = other.GetMasks();
+				const uint64_t  numCommonMasks = std::min(_numMasks, other._numMasks);
+
+				uint64_t i = 0;
+
+#ifdef PRIVATE_BITSET_USE_SSE2
+				const __m128i zero = _mm_setzero_si128();
+				for (; i + 2 <= numCommonMasks; i += 2)
+				{
+					const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + i));
+					const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(otherMasks + i));
+
+					// Bits that are set in this bitset but not in the other one
+					const __m128i missing = _mm_andnot_si128(b, a);
+					if (_mm_movemask_epi8(_mm_cmpeq_epi8(missing, zero)) != 0xFFFF) { return false; }
+				}
+#endif
 
-				for (uint64_t i = 0; i < _masks.size(); ++i) { if ((_masks[i] & other._masks[i]) != _masks[i]) { return false; } }
+				for (; i < numCommonMasks; ++i) { if ((masks[i] & otherMasks[i]) != masks[i]) { return false; } }
+
+				// The other bitset is smaller so any bit set in the remaining masks can't match
+				for (; i < _numMasks; ++i) { if (masks[i] != 0) { return false; } }
 
 				return true;
 			}
 
+			/**
+			 * Hash that is kept up to date while setting bits, bitsets that match have the same hash regardless of their size.
+			 */
+			[[nodiscard]] uint64_t GetHash() const { return _hash; }
+
+			[[nodiscard]] bool operator==(const DynamicBitSet& other) const { return Matches(other); }
+
 		private:
-			static constexpr uint64_t MASK_SIZE = sizeof(uint64_t) * CHAR_BIT;
+			static constexpr uint64_t MASK_SIZE        = sizeof(uint64_t) * CHAR_BIT;
+			static constexpr uint64_t NUM_INLINE_MASKS = 4;
+
+			uint64_t _numBits  = 0;
+			uint64_t _numMasks = 0;
+			uint64_t _hash     = 0;
+
+			std::array<uint64_t, NUM_INLINE_MASKS> _inlineMasks{};
+			std::vector<uint64_t>                  _heapMasks{};
+
+			[[nodiscard]] uint64_t* GetMasks() { return _numMasks <= NUM_INLINE_MASKS ? _inlineMasks.data() : _heapMasks.data(); }
+
+			[[nodiscard]] const uint64_t* GetMasks() const { return _numMasks <= NUM_INLINE_MASKS ? _inlineMasks.data() : _heapMasks.data(); }
+
+			void Reserve(const uint64_t numMasks)
+			{
+				if (numMasks <= _numMasks) { return; }
+
+				if (numMasks > NUM_INLINE_MASKS)
+				{
+					if (_numMasks <= NUM_INLINE_MASKS) { _heapMasks.assign(_inlineMasks.begin(), _inlineMasks.end()); }
+					_heapMasks.resize(numMasks, 0);
+				}
+
+				_numMasks = numMasks;
+			}
+
+			/**
+			 * splitmix64 finalizer, empty masks hash to 0 so trailing empty masks don't change the hash
+			 */
+			static uint64_t HashMask(const uint64_t mask, const uint64_t index)
+			{
+				if (mask == 0) { return 0; }
 
-			uint64_t              _numBits = 0;
-			std::vector<uint64_t> _masks;
+				uint64_t x = mask ^ (index * 0x9E3779B97F4A7C15ull);
+				x ^= x >> 30;
+				x *= 0xBF58476D1CE4E5B9ull;
+				x ^= x >> 27;
+				x *= 0x94D049BB133111EBull;
+				x ^= x >> 31;
+
+				return x;
+			}
 	};
 
 	template<typename T>
@@ -262,4 +365,4 @@ namespace SplitEngine
 	};
 }
 
-#undef PRIVATE_COMPARE_SIZE
+#undef PRIVATE_BITSET_USE_SSE2
@@ -25,6 +25,7 @@ namespace SplitEngine::ECS
 			          std::vector<Component>&   sparseComponentLookup,
 			          std::vector<Archetype*>&  archetypeLookup,
 			          AvailableStack<uint64_t>& entityGraveyard,
+			          std::vector<Archetype*>&  dirtyArchetypes,
 			          std::vector<uint64_t>&&   componentIDs);
 
 			template<typename T>
@@ -46,6 +47,7 @@ namespace SplitEngine::ECS
 			uint64_t AddEntity(uint64_t entityID, TArgs&&... components)
 			{
 				_entitiesToAdd.push_back(entityID);
+				MarkDirty();
 
 				AddComponents(std::forward<TArgs>(components)...);
 
@@ -54,6 +56,8 @@ namespace SplitEngine::ECS
 
 			void DestroyEntity(uint64_t entityID);
 
+			[[nodiscard]] bool HasComponent(const uint64_t componentID) const { return Signature.IsBitSet(componentID); }
+
 			template<typename... TArgs>
 			Archetype* FindArchetype()
 			{
@@ -78,7 +82,7 @@ namespace SplitEngine::ECS
 				{
 					std::vector<uint64_t> componentIds = std::vector<uint64_t>(ComponentIDs);
 					componentIds.push_back(componentIDToAdd);
-					const Archetype* archetype = new Archetype(_sparseEntityLookup, _sparseComponentLookup, _archetypeLookup, _entityGraveyard, std::move(componentIds));
+					const Archetype* archetype = new Archetype(_sparseEntityLookup, _sparseComponentLookup, _archetypeLookup, _entityGraveyard, _dirtyArchetypes, std::move(componentIds));
 					_sparseAddComponentArchetypes[componentIDToAdd] = archetype->ID;
 					return archetype->ID;
 				}
@@ -96,7 +100,7 @@ namespace SplitEngine::ECS
 
 					for (uint64_t& componentID: ComponentIDs) { if (componentID != componentIDToRemove) { componentIds.push_back(componentID); } }
 
-					Archetype* archetype = new Archetype(_sparseEntityLookup, _sparseComponentLookup, _archetypeLookup, _entityGraveyard, std::move(componentIds));
+					Archetype* archetype = new Archetype(_sparseEntityLookup, _sparseComponentLookup, _archetypeLookup, _entityGraveyard, _dirtyArchetypes, std::move(componentIds));
 					_sparseRemoveComponentArchetypes[componentIDToRemove] = archetype->ID;
 					archetype->_sparseAddComponentArchetypes[componentIDToRemove] = ID;
 					return archetype->ID;
@@ -118,13 +122,18 @@ namespace SplitEngine::ECS
 					else { entity.moveArchetypeIndex = GetRemoveArchetypeID<TArgs>(); }
 				}(), ...);
 
-				if (oldArchetypeMoveIndex == -1ull) { _entitiesToMove.push_back(entityID); }
+				if (oldArchetypeMoveIndex == -1ull)
+				{
+					_entitiesToMove.push_back(entityID);
+					MarkDirty();
+				}
 				else if (entity.moveComponentIndex != -1ull)
 				{
 					Archetype* newArchetype = _archetypeLookup[entity.moveArchetypeIndex];
 					Archetype* oldArchetype = _archetypeLookup[oldArchetypeMoveIndex];
 
 					newArchetype->_entitiesToAdd.push_back(entityID);
+					newArchetype->MarkDirty();
 
 					newArchetype->ResizeAddComponentsForNewEntity();
 
@@ -162,15 +171,21 @@ namespace SplitEngine::ECS
 
 				Archetype* newArchetype = _archetypeLookup[entity.moveArchetypeIndex];
 
-				if (oldArchetypeMoveIndex == -1ull) { _entitiesToMove.push_back(entityID); }
+				if (oldArchetypeMoveIndex == -1ull)
+				{
+					_entitiesToMove.push_back(entityID);
+					MarkDirty();
+				}
 
 				else if (entity.archetypeIndex == -1ull)
 				{
 					_entitiesToMove.push_back(entityID);
+					MarkDirty();
 					entity.archetypeIndex = ID;
 				}
 
 				newArchetype->_entitiesToAdd.push_back(entityID);
+				newArchetype->MarkDirty();
 
 				newArchetype->ResizeAddComponentsForNewEntity();
 
@@ -225,6 +240,22 @@ namespace SplitEngine::ECS
 			std::vector<Component>&   _sparseComponentLookup;
 			std::vector<Archetype*>&  _archetypeLookup;
 			AvailableStack<uint64_t>& _entityGraveyard;
+			std::vector<Archetype*>&  _dirtyArchetypes;
+
+			// Whether this archetype is already on the registries dirty list for this frame
+			bool _isDirty = false;
+
+			/**
+			 * Puts this archetype on the dirty list so the registry only processes archetypes with queued operations.
+			 * Needs to be called whenever something gets pushed into one of the queues.
+			 */
+			inline void MarkDirty()
+			{
+				if (_isDirty) { return; }
+
+				_isDirty = true;
+				_dirtyArchetypes.push_back(this);
+			}
 
 			template<typename T>
 			inline std::vector<std::byte>& GetComponentsToAddRaw() { return _componentDataToAdd[TypeIDGenerator<Component>::GetID<T>()]; }
@@ -10,6 +10,8 @@
 #include "Entity.hpp"
 #include "SystemBase.hpp"
 
+#include <functional>
+#include <span>
 #include <vector>
 
 namespace SplitEngine::ECS
@@ -36,6 +38,11 @@ namespace SplitEngine::ECS
 				Inclusion,
 			};
 
+			template<typename T>
+			using ComponentObserver = std::function<void(std::span<uint64_t> entities, std::span<T*> components, ContextProvider& contextProvider)>;
+
+			using EntityObserver = std::function<void(std::span<uint64_t> entities, ContextProvider& contextProvider)>;
+
 		public:
 			Registry();
 
@@ -125,6 +132,29 @@ namespace SplitEngine::ECS
 				_archetypeRoot->Resize();
 			}
 
+			/**
+			 * Gets called once per frame after the queued operations are executed with all entities that gained a component of type T.
+			 * Each entity is reported at most once, regardless of how many archetypes it passed through this frame.
+			 * Entities that already had the component before being moved to another archetype are not included.
+			 * The component pointers are valid until the next time pending operations are executed.
+			 */
+			template<typename T>
+			void OnAdd(ComponentObserver<T>&& observer) { AddComponentObserver<T>(_addObservers, std::move(observer)); }
+
+			/**
+			 * Gets called once per frame before the queued operations are executed with all entities that are about to lose a component of type T.
+			 * This includes entities that get destroyed, so the components can still be read before they get destructed.
+			 * Each entity is reported at most once per component, even if it got moved and destroyed in the same frame.
+			 * Operations queued from inside the observer are executed in the same frame but are not reported to remove observers.
+			 */
+			template<typename T>
+			void OnRemove(ComponentObserver<T>&& observer) { AddComponentObserver<T>(_removeObservers, std::move(observer)); }
+
+			/**
+			 * Gets called once per frame after the queued operations are executed with the IDs of all destroyed entities.
+			 */
+			void OnDestroy(EntityObserver&& observer);
+
 			template<typename T>
 			void RegisterContext(T&& context) { _contextProvider.RegisterContext<T>(std::forward<T>(context)); }
 
@@ -149,6 +179,11 @@ namespace SplitEngine::ECS
 
 			std::vector<float>& GetAccumulatedStageTimeMs();
 
+			/**
+			 * Amount of frames in which the first slice of a system alone exceeded its time budget since the last reset, indexed by system ID.
+			 */
+			std::vector<uint64_t>& GetAccumulatedBudgetOverruns();
+
 			std::vector<uint8_t>& GetActiveStages();
 
 			[[nodiscard]] uint8_t GetPrimaryGroup() const;
@@ -157,6 +192,12 @@ namespace SplitEngine::ECS
 
 			void RemoveSystem(uint64_t systemID);
 
+			/**
+			 * Assigns an execution budget to a system, see SystemBase::ExecutionBudget.
+			 * The sweep cursor is reset, passing a default constructed budget makes the system run unbudgeted again.
+			 */
+			void SetSystemExecutionBudget(uint64_t systemID, const SystemBase::ExecutionBudget& budget);
+
 			template<typename... T>
 			[[nodiscard]] Archetype* GetArchetype() const
 			{
@@ -190,6 +231,7 @@ namespace SplitEngine::ECS
 					SystemBase*                 System = nullptr;
 					std::vector<SystemLocation> Locations{};
 					bool                        Added = false;
+					SystemBase::ExecutionState  ExecutionState{};
 			};
 
 			struct SystemExecutionEntry
@@ -198,6 +240,21 @@ namespace SplitEngine::ECS
 				uint64_t SystemLocationIndex = -1;
 			};
 
+			struct ObserverBatch
+			{
+				uint64_t ComponentID = -1;
+				size_t   End         = 0;
+			};
+
+			struct AddedEntity
+			{
+				uint64_t EntityID            = -1;
+				uint64_t ArchetypeID         = -1;
+				uint64_t PreviousArchetypeID = -1;
+			};
+
+			using RawComponentObserver = std::function<void(std::span<uint64_t> entities, std::span<std::byte*> components, ContextProvider& contextProvider)>;
+
 		private:
 			std::vector<uint8_t> _emptyStageVector = std::vector<uint8_t>();
 
@@ -231,14 +288,62 @@ namespace SplitEngine::ECS
 			bool               _collectStatistics      = false;
 			std::vector<float> _accumulatedStageTimeMs = std::vector<float>(std::numeric_limits<uint8_t>::max(), 0);
 
-			bool _hasPendingEntityMoves     = false;
-			bool _hasPendingEntityAdds      = false;
-			bool _hasPendingEntityDeletions = false;
+			std::vector<uint64_t> _accumulatedBudgetOverruns{};
+
+			// Archetypes that have queued operations, archetypes register themselves on first enqueue
+			std::vector<Archetype*> _dirtyArchetypes{};
+
+			// Number of archetypes the systems cached their archetype lists against
+			size_t _numCachedArchetypes = 0;
+
+			// Observers are indexed by component ID
+			std::vector<std::vector<RawComponentObserver>> _addObservers{};
+			std::vector<std::vector<RawComponentObserver>> _removeObservers{};
+			std::vector<EntityObserver>                    _destroyObservers{};
+
+			// Only filled while observers of the matching kind are registered
+			std::vector<AddedEntity> _addedEntities{};
+			std::vector<uint64_t>    _destroyedEntities{};
+
+			// Scratch buffers the observer batches get gathered into
+			std::vector<uint64_t>   _observedEntities{};
+			std::vector<std::byte*> _observedComponents{};
+
+			// Each batch covers the scratch buffer range of one component, starting where the previous batch ended
+			std::vector<ObserverBatch> _observerBatches{};
+
+			// Entities that are both alive and queued for destruction while remove observers get gathered
+			DynamicBitSet _entitiesPendingDestroy{};
+
+			template<typename T>
+			void AddComponentObserver(std::vector<std::vector<RawComponentObserver>>& observers, ComponentObserver<T>&& observer)
+			{
+				const uint64_t componentID = TypeIDGenerator<Component>::GetID<T>();
+
+				if (observers.size() <= componentID) { observers.resize(componentID + 1); }
+
+				observers[componentID].push_back([observer = std::move(observer)](std::span<uint64_t> entities, std::span<std::byte*> components, ContextProvider& contextProvider)
+				{
+					observer(entities, std::span<T*>(reinterpret_cast<T**>(components.data()), components.size()), contextProvider);
+				});
+			}
+
+			[[nodiscard]] static bool HasComponentObservers(const std::vector<std::vector<RawComponentObserver>>& observers, uint64_t componentID);
+
+			void NotifyRemoveObservers();
+
+			void NotifyAddObservers();
+
+			void NotifyDestroyObservers();
+
+			void DispatchComponentObservers(std::vector<std::vector<RawComponentObserver>>& observers);
 
 			void AddQueuedSystems();
 
 			void RemoveQueuedSystems();
 
+			void RunSystemBudgeted(SystemEntry& systemEntry, uint8_t stage);
+
 			SystemLocation& GetSystemLocationOfExecutionEntry(const SystemExecutionEntry& executionEntry);
 	};
 }
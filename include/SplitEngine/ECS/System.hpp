@@ -3,6 +3,10 @@
 #include "Archetype.hpp"
 #include "Registry.hpp"
 #include "SystemBase.hpp"
+#include "SplitEngine/ErrorHandler.hpp"
+
+#include <span>
+#include <SDL_timer.h>
 
 namespace SplitEngine::ECS
 {
@@ -10,11 +14,7 @@ namespace SplitEngine::ECS
 	class System : public SystemBase
 	{
 		public:
-			System()
-			{
-				_signature.ExtendSizeBy(TypeIDGenerator<Component>::GetCount());
-				(_signature.SetBit(TypeIDGenerator<Component>::GetID<T>()), ...);
-			}
+			System() { (_signature.SetBit(TypeIDGenerator<Component>::GetID<T>()), ...); }
 
 		protected:
 			void RunExecute(ContextProvider& contextProvider, uint8_t stage) final
@@ -25,7 +25,8 @@ namespace SplitEngine::ECS
 					_cachedArchetypes = true;
 				}
 
-				ExecuteArchetypes(_archetypes, contextProvider, stage);
+				if (_executionState != nullptr) { ExecuteArchetypesBudgeted(_archetypes, contextProvider, stage); }
+				else { ExecuteArchetypes(_archetypes, contextProvider, stage); }
 			}
 
 			virtual void ExecuteArchetypes(std::vector<Archetype*>& archetypes, ContextProvider& contextProvider, uint8_t stage)
@@ -37,10 +38,75 @@ namespace SplitEngine::ECS
 				}
 			}
 
-			virtual void Execute(T*..., std::vector<uint64_t>& entities, ContextProvider& context, uint8_t stage) {}
+			/**
+			 * Runs instead of ExecuteArchetypes when the system has an execution budget.
+			 * Continues the sweep at the stored cursor and hands out slices until the budget is used up.
+			 * Entities that get moved or destroyed between frames can shift the sweep, so each entity is visited roughly once per sweep.
+			 */
+			virtual void ExecuteArchetypesBudgeted(std::vector<Archetype*>& archetypes, ContextProvider& contextProvider, uint8_t stage)
+			{
+				ExecutionCursor&       cursor = _executionState->Cursor;
+				const ExecutionBudget& budget = _executionState->Budget;
+
+				if (cursor.ArchetypeIndex >= archetypes.size()) { cursor = {}; }
+
+				while (cursor.ArchetypeIndex < archetypes.size())
+				{
+					Archetype*     archetype   = archetypes[cursor.ArchetypeIndex];
+					const uint64_t numEntities = archetype->Entities.size();
+
+					while (cursor.EntityIndex < numEntities)
+					{
+						uint64_t sliceSize = budget.SliceSize == 0 ? numEntities : budget.SliceSize;
+						if (budget.EntityQuota > 0)
+						{
+							if (_executionState->EntitiesProcessed >= budget.EntityQuota) { return; }
+							sliceSize = std::min(sliceSize, budget.EntityQuota - _executionState->EntitiesProcessed);
+						}
+
+						if (SDL_GetPerformanceCounter() >= _executionState->DeadlineCounter) { return; }
+
+						sliceSize = std::min(sliceSize, numEntities - cursor.EntityIndex);
+
+						std::span<uint64_t> entities = std::span<uint64_t>(archetype->Entities).subspan(cursor.EntityIndex, sliceSize);
+
+						std::apply([this, &entities, &contextProvider, stage](T*... components) { ExecuteSlice(components..., entities, contextProvider, stage); },
+						           std::make_tuple(reinterpret_cast<T*>(archetype->GetComponentsRaw<T>().data()) + cursor.EntityIndex...));
+
+						// Systems that only override ExecuteArchetypes would silently do nothing otherwise
+						if (!_isExecuteImplemented) { ErrorHandler::ThrowRuntimeError("System has an execution budget but overrides neither ExecuteSlice nor Execute"); }
+
+						if (_executionState->FirstSliceEndCounter == 0) { _executionState->FirstSliceEndCounter = SDL_GetPerformanceCounter(); }
+
+						cursor.EntityIndex += sliceSize;
+						_executionState->EntitiesProcessed += sliceSize;
+					}
+
+					cursor.ArchetypeIndex++;
+					cursor.EntityIndex = 0;
+				}
+
+				// Sweep is complete, start over next frame
+				cursor = {};
+			}
+
+			virtual void Execute(T*..., std::vector<uint64_t>& entities, ContextProvider& context, uint8_t stage) { _isExecuteImplemented = false; }
+
+			/**
+			 * Budgeted counterpart of Execute, the component pointers already point at the first entity of the slice.
+			 * By default the slice is handed to Execute with a copy of its entities, so changes to that vector don't affect the archetype.
+			 */
+			virtual void ExecuteSlice(T*... components, std::span<uint64_t> entities, ContextProvider& context, uint8_t stage)
+			{
+				_sliceEntities.assign(entities.begin(), entities.end());
+				Execute(components..., _sliceEntities, context, stage);
+			}
 
 		private:
 			std::vector<Archetype*> _archetypes;
+			std::vector<uint64_t>   _sliceEntities{};
+
+			bool _isExecuteImplemented = true;
 
 			DynamicBitSet _signature{};
 	};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 namespace SplitEngine::ECS
 {
 	class Registry;
@@ -9,6 +11,41 @@ namespace SplitEngine::ECS
 		friend class Registry;
 
 		public:
+			/**
+			 * Opting into a budget makes the system amortize its archetype sweep over multiple frames.
+			 * Each frame it only processes entities until the time budget or the entity quota is used up and continues where it stopped on the next frame.
+			 * Leaving both TimeBudgetMs and EntityQuota on 0 disables budgeting.
+			 */
+			struct ExecutionBudget
+			{
+				float    TimeBudgetMs = 0.0f;
+				uint64_t EntityQuota  = 0;
+
+				/**
+				 * Amount of entities that get processed between time budget checks
+				 */
+				uint64_t SliceSize = 64;
+
+				[[nodiscard]] bool IsEnabled() const { return TimeBudgetMs > 0.0f || EntityQuota > 0; }
+			};
+
+			struct ExecutionCursor
+			{
+				uint64_t ArchetypeIndex = 0;
+				uint64_t EntityIndex    = 0;
+			};
+
+			struct ExecutionState
+			{
+				ExecutionBudget Budget{};
+				ExecutionCursor Cursor{};
+				uint64_t        DeadlineCounter   = 0;
+				uint64_t        EntitiesProcessed = 0;
+
+				// Set once the first slice of the frame is done, 0 if no slice ran
+				uint64_t FirstSliceEndCounter = 0;
+			};
+
 			virtual ~SystemBase() = default;
 
 		protected:
@@ -16,5 +53,8 @@ namespace SplitEngine::ECS
 			virtual void RunExecute(ContextProvider& context, uint8_t stage) = 0;
 
 			bool _cachedArchetypes = false;
+
+			// Only valid during RunExecute and only if the system has a budget assigned
+			ExecutionState* _executionState = nullptr;
 	};
 }
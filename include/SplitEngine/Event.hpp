@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <vector>
 
@@ -14,11 +16,29 @@ namespace SplitEngine
 				for (const std::function<void(TArgs...)>& function : _functions) { function(args...); }
 			}
 
-			void Add(std::function<void(TArgs...)> function) { _functions.push_back(function); }
+			/**
+			 * Returns a handle that can be used to remove the function again
+			 */
+			uint64_t Add(std::function<void(TArgs...)> function)
+			{
+				_handles.push_back(_nextHandle);
+				_functions.push_back(std::move(function));
+				return _nextHandle++;
+			}
+
+			void Remove(const uint64_t handle)
+			{
+				const auto it = std::ranges::find(_handles, handle);
+				if (it == _handles.end()) { return; }
 
-			void Remove(std::function<void(TArgs...)> function) { std::remove(_functions.begin(), _functions.end(), function); }
+				_functions.erase(_functions.begin() + std::distance(_handles.begin(), it));
+				_handles.erase(it);
+			}
 
 		private:
 			std::vector<std::function<void(TArgs...)>> _functions;
+			std::vector<uint64_t>                      _handles;
+
+			uint64_t _nextHandle = 0;
 	};
 }
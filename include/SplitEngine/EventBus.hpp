@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <format>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#include "DataStructures.hpp"
+#include "ErrorHandler.hpp"
+
+namespace SplitEngine
+{
+	class EventBus;
+
+	class EventChannelBase
+	{
+		friend class EventBus;
+
+		public:
+			virtual ~EventChannelBase() = default;
+
+		protected:
+			virtual void Flush() = 0;
+
+			virtual void Unsubscribe(uint64_t subscriptionID) = 0;
+	};
+
+	/**
+	 * Double buffered queue for events of a single type.
+	 * Publishing is lock free as long as the amount of events stays below the capacity of the previous frames, otherwise events spill into a mutex guarded overflow buffer.
+	 * The capacity grows on flush, so this only happens on frames with more events than ever before.
+	 */
+	template<typename T>
+	class EventChannel final : public EventChannelBase
+	{
+		static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>, "Events need to be plain data types");
+
+		friend class EventBus;
+
+		public:
+			using Callback = std::function<void(std::span<const T> events)>;
+
+			/**
+			 * Can be called from any thread as long as no flush is happening at the same time
+			 */
+			void Publish(const T& event)
+			{
+				const size_t index = _writeCount.fetch_add(1, std::memory_order_relaxed);
+
+				if (index < _writeBuffer.size())
+				{
+					_writeBuffer[index] = event;
+					return;
+				}
+
+				std::lock_guard lock(_overflowMutex);
+				_overflowBuffer.push_back(event);
+			}
+
+			/**
+			 * Returns all events that were published during the previous frame
+			 */
+			[[nodiscard]] std::span<const T> Read() const { return _readBuffer; }
+
+		protected:
+			void Flush() override
+			{
+				const size_t numEvents = std::min(_writeCount.load(std::memory_order_acquire), _writeBuffer.size());
+
+				std::swap(_readBuffer, _writeBuffer);
+				_readBuffer.resize(numEvents);
+				_readBuffer.insert(_readBuffer.end(), _overflowBuffer.begin(), _overflowBuffer.end());
+
+				_overflowBuffer.clear();
+				_writeCount.store(0, std::memory_order_relaxed);
+
+				_capacity = std::max(_capacity, std::bit_ceil(_readBuffer.size()));
+				_writeBuffer.resize(_capacity);
+
+				if (_readBuffer.empty()) { return; }
+
+				for (Subscription& subscription: _subscriptions) { subscription.Function(_readBuffer); }
+			}
+
+			void Unsubscribe(const uint64_t subscriptionID) override
+			{
+				std::erase_if(_subscriptions, [subscriptionID](const Subscription& subscription) { return subscription.ID == subscriptionID; });
+			}
+
+		private:
+			struct Subscription
+			{
+				uint64_t ID = -1;
+				Callback Function;
+			};
+
+			size_t         _capacity    = 64;
+			std::vector<T> _writeBuffer = std::vector<T>(64);
+			std::vector<T> _readBuffer{};
+
+			std::atomic<size_t> _writeCount = 0;
+
+			std::mutex     _overflowMutex{};
+			std::vector<T> _overflowBuffer{};
+
+			std::vector<Subscription> _subscriptions{};
+	};
+
+	/**
+	 * Owns one EventChannel per event type.
+	 * Events published during a frame become readable after the next flush and stay readable until the flush after that,
+	 * so systems in any stage can consume them as one contiguous span.
+	 */
+	class EventBus
+	{
+		public:
+			struct SubscriptionHandle
+			{
+				uint64_t ChannelID      = -1;
+				uint64_t SubscriptionID = -1;
+			};
+
+			/**
+			 * Channels need to be registered from the main thread before events can be published to them.
+			 */
+			template<typename T>
+			void RegisterChannel()
+			{
+				const uint64_t id = TypeIDGenerator<EventBus>::GetID<T>();
+
+				if (_channels.size() <= id) { _channels.resize(id + 1); }
+				if (_channels[id] == nullptr) { _channels[id] = std::make_unique<EventChannel<T>>(); }
+			}
+
+			template<typename T>
+			EventChannel<T>& GetChannel()
+			{
+				const uint64_t id = TypeIDGenerator<EventBus>::GetID<T>();
+
+				if (id >= _channels.size() || _channels[id] == nullptr)
+				{
+					ErrorHandler::ThrowRuntimeError(std::format("No event channel registered for event type {0} ({1}), call RegisterChannel first", id, typeid(T).name()));
+				}
+
+				return *static_cast<EventChannel<T>*>(_channels[id].get());
+			}
+
+			template<typename T>
+			void Publish(const T& event) { GetChannel<T>().Publish(event); }
+
+			template<typename T>
+			[[nodiscard]] std::span<const T> Read() { return GetChannel<T>().Read(); }
+
+			/**
+			 * The callback gets invoked once per flush with all events of the previous frame, it's not called if there were none.
+			 */
+			template<typename T>
+			SubscriptionHandle Subscribe(typename EventChannel<T>::Callback&& callback)
+			{
+				const uint64_t channelID = TypeIDGenerator<EventBus>::GetID<T>();
+
+				GetChannel<T>()._subscriptions.push_back({ _subscriptionID, std::move(callback) });
+
+				return { channelID, _subscriptionID++ };
+			}
+
+			void Unsubscribe(const SubscriptionHandle& handle);
+
+			/**
+			 * Swaps the buffers of all channels and notifies subscribers, no events may be published while this is running.
+			 */
+			void Flush();
+
+		private:
+			std::vector<std::unique_ptr<EventChannelBase>> _channels{};
+
+			uint64_t _subscriptionID = 0;
+	};
+}
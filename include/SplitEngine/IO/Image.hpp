@@ -1,16 +1,59 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 namespace SplitEngine::IO
 {
 	struct Image
 	{
+		public:
+			/**
+			 * Compressed images store 4x4 pixel blocks instead of pixels and always have 4 channels
+			 */
+			enum class BlockCompression
+			{
+				None,
+				BC1,
+				BC7,
+				ASTC4x4,
+			};
+
 		public:
 			std::vector<std::byte> Pixels{};
 
 			uint32_t Width             = 0;
 			uint32_t Height            = 0;
 			uint32_t Channels          = 4;
+
+			/**
+			 * If bigger than one the pixels contain that many mip levels tightly packed, starting with the full size one
+			 */
+			uint32_t MipLevels = 1;
+
+			BlockCompression Compression = BlockCompression::None;
+
+			/**
+			 * Color data like albedo is stored sRGB encoded, linear data like normal maps or masks must not be decoded when sampled.
+			 * Only applies to 4 channel and compressed images.
+			 */
+			bool Srgb = true;
+
+			[[nodiscard]] size_t GetMipLevelSizeInBytes(const uint32_t mipLevel) const
+			{
+				const size_t width  = std::max(Width >> mipLevel, 1u);
+				const size_t height = std::max(Height >> mipLevel, 1u);
+
+				switch (Compression)
+				{
+					case BlockCompression::BC1:
+						return ((width + 3) / 4) * ((height + 3) / 4) * 8;
+					case BlockCompression::BC7:
+					case BlockCompression::ASTC4x4:
+						return ((width + 3) / 4) * ((height + 3) / 4) * 16;
+					default:
+						return width * height * Channels;
+				}
+			}
 	};
 }
@@ -28,6 +28,19 @@ namespace SplitEngine::IO
 				RGB = RGBA,
 			};
 
+			/**
+			 * KTX2 and DDS files are loaded as is with all of their mip levels, they need to contain a single 2D BC1, BC7 or ASTC 4x4 image.
+			 * The channel setup only applies to the formats decoded by stb_image.
+			 */
 			static Image Load(const std::filesystem::path& filePath, ChannelSetup channelSetup = ChannelSetup::RGBA);
+
+			/**
+			 * Only reads the header of KTX2 and DDS files, everything else is uncompressed
+			 */
+			static Image::BlockCompression ReadBlockCompression(const std::filesystem::path& filePath);
+
+		private:
+			static Image LoadKtx2(const std::filesystem::path& filePath, bool headerOnly);
+			static Image LoadDds(const std::filesystem::path& filePath, bool headerOnly);
 	};
 }
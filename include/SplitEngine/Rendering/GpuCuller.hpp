@@ -0,0 +1,138 @@
+#pragma once
+
+#include "SplitEngine/AssetDatabase.hpp"
+#include "Vulkan/Buffer.hpp"
+#include "Vulkan/InFlightResource.hpp"
+
+#include <array>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering
+{
+	class Shader;
+
+	/**
+	 * Frustum culls instances on the gpu and turns the survivors into indexed indirect draws, so the cpu never touches per instance visibility.
+	 *
+	 * The cull compute shader is supplied by the user and dispatched with one workgroup per draw, its shader descriptor set (set 1) needs these storage buffers with the NoAllocation modifier:
+	 * 0: InstanceBounds[] (read), 1: DrawInfo[] (read), 2: VkDrawIndexedIndirectCommand[] (write), 3: uint draw count (atomic), 4: uint visible instances[] (write).
+	 * The first compute push constant is CullConstants.
+	 * Each workgroup writes the indices of its visible instances to visibleInstances[draw.FirstInstance + n] and, if any survived, appends a command with that first instance at atomicAdd(drawCount, 1).
+	 * Vertex shaders look their instance up with visibleInstances[gl_InstanceIndex].
+	 *
+	 * Culling is recorded into the renderers compute command buffer, the draws can be recorded anywhere in the main render pass of the same frame.
+	 *
+	 * The device needs drawIndirectFirstInstance, check IsSupported and cull on the cpu otherwise.
+	 * Without drawIndirectCount all maxDraws commands are drawn with the unused ones cleared, without multiDrawIndirect every command gets a draw call of its own.
+	 */
+	class GpuCuller
+	{
+		public:
+			/**
+			 * Bounding sphere in world space, std430 layout
+			 */
+			struct InstanceBounds
+			{
+				glm::vec3 Center = glm::vec3(0.0f);
+				float     Radius = 0.0f;
+			};
+
+			/**
+			 * One draw with its range of instances, std430 layout
+			 */
+			struct DrawInfo
+			{
+				uint32_t IndexCount    = 0;
+				uint32_t FirstIndex    = 0;
+				int32_t  VertexOffset  = 0;
+				uint32_t FirstInstance = 0;
+				uint32_t NumInstances  = 0;
+			};
+
+			struct CullConstants
+			{
+				std::array<glm::vec4, 6> FrustumPlanes{};
+				uint32_t                 NumDraws = 0;
+			};
+
+			/**
+			 * Binding points of the buffers in the shader descriptor set of the cull shader
+			 */
+			enum Binding : uint32_t
+			{
+				Bounds           = 0,
+				Draws            = 1,
+				Commands         = 2,
+				DrawCount        = 3,
+				VisibleInstances = 4,
+			};
+
+		public:
+			GpuCuller() = default;
+
+			GpuCuller(AssetHandle<Shader> cullShader, uint32_t maxInstances, uint32_t maxDraws);
+
+			/**
+			 * True if the device supports the features the culler can't do without
+			 */
+			[[nodiscard]] static bool IsSupported();
+
+			/**
+			 * Mapped bounds of the current frame, there's room for maxInstances entries
+			 */
+			[[nodiscard]] InstanceBounds* GetInstanceBounds();
+
+			/**
+			 * Mapped draw infos of the current frame, there's room for maxDraws entries
+			 */
+			[[nodiscard]] DrawInfo* GetDrawInfos();
+
+			/**
+			 * Records the cull dispatch for the first numDraws draw infos of the current frame
+			 */
+			void Cull(const vk::CommandBuffer& computeCommandBuffer, const std::array<glm::vec4, 6>& frustumPlanes, uint32_t numDraws);
+
+			/**
+			 * Records the draws that survived culling, the graphics pipeline and vertex and index buffers need to be bound already
+			 */
+			void Draw(const vk::CommandBuffer& commandBuffer) const;
+
+			/**
+			 * Needs to be bound to the vertex shader of the culled draws
+			 */
+			[[nodiscard]] const Vulkan::Buffer& GetVisibleInstanceBuffer(uint32_t frameInFlight = -1);
+
+			/**
+			 * Planes point inwards and are normalized, a sphere is visible if dot(plane.xyz, center) + plane.w >= -radius for all of them
+			 */
+			[[nodiscard]] static std::array<glm::vec4, 6> ExtractFrustumPlanes(const glm::mat4& viewProjection);
+
+			/**
+			 * None of the frames in flight may still be using the buffers
+			 */
+			void Destroy();
+
+		private:
+			struct FrameBuffers
+			{
+				Vulkan::Buffer Bounds{};
+				Vulkan::Buffer Draws{};
+				Vulkan::Buffer Commands{};
+				Vulkan::Buffer DrawCount{};
+				Vulkan::Buffer VisibleInstances{};
+
+				uint32_t NumDraws = 0;
+			};
+
+			AssetHandle<Shader> _cullShader{};
+
+			uint32_t _maxInstances = 0;
+			uint32_t _maxDraws     = 0;
+
+			bool _supportsDrawIndirectCount = false;
+			bool _supportsMultiDrawIndirect = false;
+
+			Vulkan::InFlightResource<FrameBuffers> _frameBuffers{};
+	};
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "SplitEngine/Contexts.hpp"
+#include "Vulkan/InFlightResource.hpp"
+
+#include <atomic>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering
+{
+	namespace Vulkan
+	{
+		class Device;
+	}
+
+	/**
+	 * Measures frames on the gpu with timestamp and pipeline statistics queries, every frame in flight has its own query pools.
+	 * A pool is read back once the in flight fence of its frame has been waited on, so the results never stall and are as many frames late as there are frames in flight.
+	 *
+	 * Zones can be recorded into any command buffer of the frame, also from the threads of the parallel command recorder.
+	 */
+	class GpuProfiler
+	{
+		public:
+			struct ZoneResult
+			{
+				const char* Name   = nullptr;
+				float       TimeMs = 0.0f;
+			};
+
+			struct FrameResults
+			{
+				/**
+				 * Increases with every frame that has been read back, so the same results don't get counted twice
+				 */
+				uint64_t FrameNumber = 0;
+
+				float                   FrameTimeMs      = 0.0f;
+				float                   RenderPassTimeMs = 0.0f;
+				std::vector<ZoneResult> Zones{};
+
+				GpuPipelineStatistics PipelineStatistics{};
+			};
+
+		public:
+			GpuProfiler(Vulkan::Device* device, bool timestamps, bool pipelineStatistics, uint32_t maxZones);
+
+			GpuProfiler(const GpuProfiler&)            = delete;
+			GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+			/**
+			 * Reads back the results of the last time the current frame in flight was recorded and resets its queries.
+			 * Needs to be called after the in flight fence has been waited on, with the compute command buffer since it's the first one submitted.
+			 */
+			void BeginFrame(const vk::CommandBuffer& computeCommandBuffer);
+
+			void BeginRenderPass(const vk::CommandBuffer& commandBuffer);
+			void EndRenderPass(const vk::CommandBuffer& commandBuffer);
+
+			void EndFrame(const vk::CommandBuffer& computeCommandBuffer, const vk::CommandBuffer& commandBuffer);
+
+			/**
+			 * Starts a zone and returns its id, the name needs to stay alive until the results have been read back (string literals are the easiest).
+			 * Returns -1 if there are no zones left this frame or timestamps aren't supported, EndZone ignores that id.
+			 */
+			uint32_t BeginZone(const vk::CommandBuffer& commandBuffer, const char* name);
+			void     EndZone(const vk::CommandBuffer& commandBuffer, uint32_t zone);
+
+			/**
+			 * Secondary command buffers inside the render pass need to inherit these while the pipeline statistics query is active
+			 */
+			[[nodiscard]] vk::QueryPipelineStatisticFlags GetInheritedPipelineStatistics() const;
+
+			[[nodiscard]] const FrameResults& GetResults() const;
+
+			void Destroy();
+
+		private:
+			enum Timestamp : uint32_t
+			{
+				FrameBegin,
+				RenderPassBegin,
+				RenderPassEnd,
+				FrameEnd,
+				MAX_VALUE,
+			};
+
+			enum StatisticsQuery : uint32_t
+			{
+				Compute,
+				RenderPass,
+			};
+
+			struct Frame
+			{
+				vk::QueryPool TimestampPool  = VK_NULL_HANDLE;
+				vk::QueryPool StatisticsPool = VK_NULL_HANDLE;
+
+				std::vector<const char*> ZoneNames{};
+				uint32_t                 NumZones   = 0;
+				bool                     HasResults = false;
+			};
+
+			static constexpr vk::QueryPipelineStatisticFlags PIPELINE_STATISTICS = vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices |
+			                                                                       vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives |
+			                                                                       vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+			                                                                       vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+			                                                                       vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations |
+			                                                                       vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+
+			Vulkan::Device* _device = nullptr;
+
+			bool     _timestampsEnabled         = false;
+			bool     _pipelineStatisticsEnabled = false;
+			uint32_t _maxZones                  = 0;
+			uint64_t _timestampMask             = 0;
+			float    _timestampPeriod           = 0.0f;
+
+			std::atomic<uint32_t> _numZones = 0;
+
+			Vulkan::InFlightResource<Frame> _frames{};
+
+			FrameResults _results{};
+
+			void ReadResults(Frame& frame);
+
+			[[nodiscard]] float GetTimeMs(uint64_t begin, uint64_t end) const;
+	};
+}
@@ -22,8 +22,17 @@ namespace SplitEngine::Rendering
 
 			~Material();
 
+			/**
+			 * Materials using the same shader get their descriptor sets from a single bulk allocation.
+			 * The returned materials are in the same order as the create infos.
+			 */
+			[[nodiscard]] static std::vector<std::unique_ptr<Material>> CreateBatch(std::vector<CreateInfo>&& createInfos);
+
 			Shader::Properties& GetProperties();
 
+			/**
+			 * Applies pending descriptor writes right away, they're otherwise batched with those of every other material and applied before the next bind
+			 */
 			void Update();
 
 			void Bind(vk::CommandBuffer& commandBuffer, uint32_t frameInFlight = -1);
@@ -36,5 +45,7 @@ namespace SplitEngine::Rendering
 			Vulkan::DescriptorSetAllocator::Allocation _instanceDescriptorSetAllocation;
 
 			Shader::Properties _instanceProperties{};
+
+			Material(const CreateInfo& createInfo, Vulkan::DescriptorSetAllocator::Allocation&& instanceDescriptorSetAllocation);
 	};
 }
@@ -1,10 +1,15 @@
 #pragma once
 
-#include "SplitEngine/Rendering/Vulkan/BufferFactory.hpp"
-#include "SplitEngine/Rendering/Vulkan/Instance.hpp"
+#include "SplitEngine/Rendering/Vulkan/MeshArena.hpp"
+
+#include <vector>
 
 namespace SplitEngine::Rendering
 {
+	/**
+	 * Vertices and indices of a model live in the shared buffers of the Vulkan::MeshArena,
+	 * so models can be drawn one after another with a single bind as long as they share the same blocks and index type.
+	 */
 	class Model
 	{
 		public:
@@ -13,6 +18,16 @@ namespace SplitEngine::Rendering
 				public:
 					std::vector<std::byte> Vertices;
 					std::vector<uint16_t>  Indices;
+
+					/**
+					 * Used instead of Indices if not empty, needed for models with more than 65536 vertices
+					 */
+					std::vector<uint32_t> LargeIndices{};
+
+					/**
+					 * Size of a single vertex, needed so the model can be addressed with a base vertex inside the shared vertex buffer
+					 */
+					uint32_t VertexSizeInBytes = 0;
 			};
 
 		public:
@@ -20,16 +35,21 @@ namespace SplitEngine::Rendering
 
 			~Model();
 
-			explicit Model(const CreateInfo& createInfo)
-			{
-				_modelBuffer = Vulkan::BufferFactory::CreateStagedModelBuffer(&Vulkan::Instance::Get().GetPhysicalDevice().GetDevice(), createInfo.Vertices, createInfo.Indices);
-			}
+			explicit Model(const CreateInfo& createInfo);
 
+			/**
+			 * Binds the shared buffers the model lives in, draws need to use its vertex offset and first index
+			 */
 			void Bind(const vk::CommandBuffer& commandBuffer) const;
 
-			[[nodiscard]] const Vulkan::Buffer& GetModelBuffer() const;
+			[[nodiscard]] const Vulkan::MeshArena::Mesh& GetMesh() const;
+
+			[[nodiscard]] uint32_t      GetNumIndices() const;
+			[[nodiscard]] uint32_t      GetFirstIndex() const;
+			[[nodiscard]] int32_t       GetVertexOffset() const;
+			[[nodiscard]] vk::IndexType GetIndexType() const;
 
 		private:
-			Vulkan::Buffer _modelBuffer;
+			Vulkan::MeshArena::Mesh _mesh{};
 	};
 }
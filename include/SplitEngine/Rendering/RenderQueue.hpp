@@ -0,0 +1,89 @@
+#pragma once
+
+#include "SplitEngine/Rendering/Vulkan/TransientBufferAllocator.hpp"
+
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering
+{
+	class Shader;
+	class Material;
+	class Model;
+
+	/**
+	 * Collects the draws of a frame so they can be recorded in an order that changes as little state as possible.
+	 * Draws are sorted by a 64 bit key (shader, material, mesh buffers, model, depth) and recorded without rebinding pipelines, descriptor sets or vertex buffers that are already bound.
+	 * Draws with the same state end up front to back.
+	 *
+	 * Models share the vertex and index buffers of the mesh arena, if the device supports multi draw indirect consecutive draws that only differ in their model are recorded as a single indirect draw.
+	 *
+	 * The Renderer records its queue at the end of the main render pass, after everything that was recorded directly into its command buffers.
+	 */
+	class RenderQueue
+	{
+		public:
+			struct DrawPacket
+			{
+				Shader*      Shader   = nullptr;
+				Material*    Material = nullptr;
+				const Model* Model    = nullptr;
+
+				/**
+				 * Only used if there is no model, draws with a model always draw all of its indices
+				 */
+				uint32_t VertexCount   = 0;
+				uint32_t NumInstances  = 1;
+				uint32_t FirstInstance = 0;
+				float    Depth         = 0.0f;
+			};
+
+		public:
+			void Submit(const DrawPacket& drawPacket);
+
+			void Sort();
+
+			/**
+			 * Writes the indirect commands of all sorted draws into a transient allocation, so ranges recorded afterwards can merge their draws.
+			 * Needs to be called after sorting and only if the device supports multi draw indirect, without it every draw is recorded on its own.
+			 */
+			void WriteIndirectCommands(Vulkan::TransientBufferAllocator& transientBufferAllocator, uint32_t maxDrawIndirectCount);
+
+			/**
+			 * Records numDraws sorted draws starting at firstDraw, multiple ranges can be recorded on different threads at the same time
+			 */
+			void Record(const vk::CommandBuffer& commandBuffer, size_t firstDraw, size_t numDraws) const;
+
+			void Clear();
+
+			[[nodiscard]] size_t GetNumDraws() const;
+
+		private:
+			struct SortEntry
+			{
+				uint64_t Key         = 0;
+				uint32_t PacketIndex = 0;
+			};
+
+			std::vector<DrawPacket> _drawPackets{};
+			std::vector<SortEntry>  _sortEntries{};
+			std::vector<SortEntry>  _sortScratch{};
+
+			// Pointers get mapped to small ids in submission order, so they fit into the key
+			std::unordered_map<const void*, uint32_t> _sortIds[3]{};
+			std::unordered_map<uint64_t, uint32_t>    _meshBufferSortIds{};
+
+			Vulkan::TransientBufferAllocator::Allocation _indirectCommands{};
+			uint32_t                                     _maxDrawIndirectCount = 1;
+
+			uint32_t GetSortId(size_t category, const void* pointer);
+
+			uint32_t GetMeshBufferSortId(const Model* model);
+
+			/**
+			 * True if the second draw can be part of the same indirect draw as the first one
+			 */
+			[[nodiscard]] static bool CanMerge(const DrawPacket& drawPacket, const DrawPacket& nextDrawPacket);
+	};
+}
@@ -2,10 +2,17 @@
 
 #include <SplitEngine/RenderingSettings.hpp>
 
+#include "GpuProfiler.hpp"
+#include "RenderQueue.hpp"
 #include "SplitEngine/ApplicationInfo.hpp"
+#include "SplitEngine/IO/Image.hpp"
 #include "SplitEngine/Window.hpp"
 #include "Vulkan/CommandBuffer.hpp"
 #include "Vulkan/Instance.hpp"
+#include "Vulkan/ParallelCommandRecorder.hpp"
+#include "Vulkan/TransientBufferAllocator.hpp"
+
+#include <memory>
 
 namespace SplitEngine
 {
@@ -17,15 +24,52 @@ namespace SplitEngine
 		{
 			friend class SDLEventSystem;
 			friend class RenderingSystem;
+			friend class FramePacingSystem;
 
 			public:
 				explicit Renderer(ApplicationInfo& applicationInfo, ShaderParserSettings&& shaderParserSettings, RenderingSettings&& renderingSettings);
 				~Renderer();
 
+				/**
+				 * Secondary command buffer inside the main render pass, it changes after every parallel recording so it should be fetched again each time it's used
+				 */
 				[[nodiscard]] Vulkan::CommandBuffer& GetCommandBuffer();
-				[[nodiscard]] Vulkan::Instance&      GetVulkanInstance();
-				[[nodiscard]] Window&                GetWindow();
-				[[nodiscard]] bool                   WasSkipped() const;
+
+				/**
+				 * Primary command buffer outside of any render pass for compute work like gpu culling.
+				 * It's submitted together with and before the main render pass, anything it writes is visible to indirect draws, vertex input and shaders of the same frame.
+				 */
+				[[nodiscard]] Vulkan::CommandBuffer& GetComputeCommandBuffer();
+
+				/**
+				 * Used to record draws on multiple threads, the results are executed in the main render pass in the order they were recorded
+				 */
+				[[nodiscard]] Vulkan::ParallelCommandRecorder& GetParallelCommandRecorder();
+
+				/**
+				 * Draws submitted during a frame are sorted by state and recorded at the end of the main render pass
+				 */
+				[[nodiscard]] RenderQueue& GetRenderQueue();
+
+				/**
+				 * Measures the gpu time of the frame and of user zones, results show up in the statistics once the frame comes around again
+				 */
+				[[nodiscard]] GpuProfiler& GetGpuProfiler();
+
+				/**
+				 * Time the last frame spent waiting for the gpu to finish an earlier frame before it could start recording
+				 */
+				[[nodiscard]] float GetGpuWaitTimeMs() const;
+
+				[[nodiscard]] Vulkan::Instance&                 GetVulkanInstance();
+				[[nodiscard]] Vulkan::TransientBufferAllocator& GetTransientBufferAllocator();
+				[[nodiscard]] Window&                           GetWindow();
+				[[nodiscard]] bool                              WasSkipped() const;
+
+				/**
+				 * Waits for the gpu to finish the last rendered frame and returns its pixels, needs headless mode with readback enabled
+				 */
+				[[nodiscard]] IO::Image ReadBackFrame();
 
 			private:
 				Window           _window;
@@ -34,13 +78,40 @@ namespace SplitEngine
 				bool     _wasSkipped             = false;
 				uint32_t _latestImageIndexResult = 0;
 
+				uint64_t  _numHeadlessFrames   = 0;
+				uint32_t  _lastFrameImageIndex = -1u;
+				vk::Fence _lastFrameFence      = VK_NULL_HANDLE;
+
 				Vulkan::CommandBuffer _commandBuffer;
+				Vulkan::CommandBuffer _computeCommandBuffer;
+				Vulkan::CommandBuffer _uploadCommandBuffer;
+
+				Vulkan::TransientBufferAllocator _transientBufferAllocator;
+
+				std::unique_ptr<Vulkan::ParallelCommandRecorder> _parallelCommandRecorder;
+
+				RenderQueue _renderQueue;
+
+				std::unique_ptr<GpuProfiler> _gpuProfiler;
+
+				float _gpuWaitTimeMs     = 0.0f;
+				bool  _hasWaitedForFrame = false;
 
 				bool _frameBufferResized = false;
 
+				// Splitting the render queue into smaller jobs costs more in rebinds than recording them saves
+				static constexpr size_t MIN_DRAWS_PER_RECORDING_JOB = 256;
+
+				/**
+				 * Waits until the gpu is done with the frame in flight that's about to be recorded again
+				 */
+				void WaitForFrame();
+
 				void BeginRender();
 				void EndRender();
 
+				void RecordRenderQueue();
+
 				void HandleEvents(SDL_Event event);
 		};
 	}
@@ -6,6 +6,7 @@
 #include "SplitEngine/Rendering/Vulkan/InFlightResource.hpp"
 #include "SplitEngine/Rendering/Vulkan/Pipeline.hpp"
 
+#include <memory>
 #include <string>
 
 namespace SplitEngine::Rendering
@@ -57,10 +58,17 @@ namespace SplitEngine::Rendering
 
 					void SetBuffer(uint32_t bindingPoint, const Vulkan::Buffer& buffer, size_t offset, size_t range, uint32_t frameInFlight = -1);
 
+					/**
+					 * Sets the offset a dynamic buffer gets bound with, usually the offset of a Vulkan::TransientBufferAllocator allocation.
+					 * The offset is read when the set gets bound, so it has to be set before recording
+					 */
+					void SetDynamicOffset(uint32_t bindingPoint, uint32_t offset);
+
 					/**
 					 * Override backing buffer of this binding point
 					 * This also set the binding point dirty and changes the buffer infos to use assigned Buffer
 					 * The Buffer is now owned by the backing descriptor and will be destroyed when the descriptor leaves the scope
+					 * Offsets are relative to the start of the given buffer, a block range the descriptor had in the descriptor buffer arena is released
 					 */
 					void OverrideBuffer(uint32_t bindingPoint, Vulkan::Buffer&& buffer);
 
@@ -83,7 +91,6 @@ namespace SplitEngine::Rendering
 					Shader*                                           _shader                  = nullptr;
 					Vulkan::DescriptorSetAllocator::Allocation*       _descriptorSetAllocation = nullptr;
 					std::vector<Vulkan::InFlightResource<std::byte*>> _shaderBuffers{};
-					std::vector<vk::WriteDescriptorSet>               _updateWriteDescriptorSets{};
 					std::vector<uint32_t>                             _sharedPtrRemoveIndex;
 
 					static uint32_t                         _idCounter;
@@ -104,12 +111,27 @@ namespace SplitEngine::Rendering
 
 			~Shader();
 
+			/**
+			 * Creates all shaders at once, reading the spirv files, reflection and pipeline compilation of the different shaders run on worker threads.
+			 * The returned shaders are in the same order as the create infos.
+			 */
+			[[nodiscard]] static std::vector<std::unique_ptr<Shader>> CreateBatch(std::vector<CreateInfo>&& createInfos);
+
 			void PushConstant(const vk::CommandBuffer& commandBuffer, ShaderType shaderType, uint32_t index, void* data) const;
 
 			void BindGlobal(const vk::CommandBuffer& commandBuffer, uint32_t frameInFlight = -1) const;
 
 			void Bind(const vk::CommandBuffer& commandBuffer, uint32_t frameInFlight = -1) const;
 
+			/**
+			 * Binds this compute shader with its global and shader descriptor sets and dispatches it, push constants can be set before calling this
+			 */
+			void Dispatch(const vk::CommandBuffer& commandBuffer, uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1, uint32_t frameInFlight = -1) const;
+
+			/**
+			 * Descriptor writes of all properties are batched frame wide and applied before the next set gets bound, so calling this is usually not needed.
+			 * It applies the pending writes right away, for when the descriptor sets are used without binding them through a shader or material.
+			 */
 			static void UpdateGlobal();
 
 			void Update();
@@ -129,6 +151,10 @@ namespace SplitEngine::Rendering
 
 			Properties _shaderProperties;
 
-			std::vector<Vulkan::Pipeline::ShaderInfo> CreateShaderInfos();
+			Shader(const CreateInfo& createInfo, Vulkan::Pipeline&& pipeline);
+
+			static Vulkan::Pipeline CreatePipeline(const CreateInfo& createInfo);
+
+			static std::vector<Vulkan::Pipeline::ShaderInfo> CreateShaderInfos(const std::vector<std::filesystem::path>& shaderPaths);
 	};
 }
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SplitEngine/AssetDatabase.hpp"
+#include "SplitEngine/Tools/ImagePacker.hpp"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace SplitEngine::Rendering
+{
+	class Material;
+
+	struct SpriteTransform
+	{
+		glm::vec3 Position{};
+		float     Rotation = 0.0f;
+		glm::vec2 Scale{ 1.0f, 1.0f };
+	};
+
+	struct Sprite
+	{
+		AssetHandle<Material>           Material{};
+		Tools::ImagePacker::PackingInfo PackingInfo{};
+		glm::vec4                       Color{ 1.0f, 1.0f, 1.0f, 1.0f };
+	};
+
+	/**
+	 * Layout of a single sprite inside the instance storage buffer.
+	 * Matches std430 so the shader can declare it as an array of structs with the same member order.
+	 */
+	struct SpriteInstance
+	{
+		glm::vec3 Position{};
+		float     Rotation = 0.0f;
+		glm::vec2 Size{};
+		uint32_t  PageIndex = 0;
+		uint32_t  Padding   = 0;
+		glm::vec2 UVTopLeft{};
+		glm::vec2 UVBottomRight{};
+		glm::vec4 Color{};
+	};
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Sprite.hpp"
+#include "SplitEngine/ECS/System.hpp"
+#include "SplitEngine/Rendering/Vulkan/Buffer.hpp"
+#include "SplitEngine/Rendering/Vulkan/InFlightResource.hpp"
+
+#include <map>
+
+namespace SplitEngine::Rendering
+{
+	class Shader;
+
+	/**
+	 * Draws all entities with a SpriteTransform and a Sprite component using one instanced draw per (material, texture page) batch, the draws go through the render queue of the Renderer.
+	 * Instances are written into a persistently mapped storage buffer that gets bound to the per pipeline set (set 1) of each sprite shader,
+	 * the vertex shader is expected to build the quad from gl_VertexIndex and read its instance with gl_InstanceIndex.
+	 * Needs to run in a stage between EngineStage::BeginRendering and EngineStage::EndRendering.
+	 */
+	class SpriteRenderingSystem final : public ECS::System<SpriteTransform, Sprite>
+	{
+		public:
+			/**
+			 * @param instanceBufferBindingPoint Binding point of the instance storage buffer inside set 1, the binding can't be marked as single instance
+			 */
+			explicit SpriteRenderingSystem(uint32_t instanceBufferBindingPoint = 0);
+
+		protected:
+			void ExecuteArchetypes(std::vector<ECS::Archetype*>& archetypes, ECS::ContextProvider& contextProvider, uint8_t stage) override;
+
+			void Destroy(ECS::ContextProvider& contextProvider) override;
+
+		private:
+			struct Batch
+			{
+				Shader*   Shader        = nullptr;
+				Material* Material      = nullptr;
+				uint32_t  PageIndex     = 0;
+				uint32_t  NumInstances  = 0;
+				uint32_t  FirstInstance = 0;
+			};
+
+			uint32_t _instanceBufferBindingPoint = 0;
+
+			Vulkan::InFlightResource<Vulkan::Buffer> _instanceBuffers{};
+
+			std::vector<Batch>                                 _batches{};
+			std::map<std::pair<Material*, uint32_t>, uint32_t> _batchLookup{};
+			std::vector<uint32_t>                              _spriteBatchIndices{};
+			std::vector<uint32_t>                              _batchWriteCursors{};
+
+			Vulkan::Buffer& GetInstanceBuffer(size_t numInstances);
+	};
+}
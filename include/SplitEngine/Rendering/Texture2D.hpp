@@ -13,6 +13,11 @@ namespace SplitEngine::Rendering
 			{
 				IO::Image       IoImage;
 				TextureSettings TextureSettings{};
+
+				/**
+				 * Generates the full mip chain on the gpu if the image doesn't already contain mip levels, compressed images can't be generated for
+				 */
+				bool GenerateMipmaps = true;
 			};
 
 		public:
@@ -22,12 +27,32 @@ namespace SplitEngine::Rendering
 			[[nodiscard]] const Vulkan::Image& GetImage() const;
 			[[nodiscard]] const vk::Sampler*   GetSampler() const;
 
+			/**
+			 * Index into the bindless texture array, -1 if bindless textures aren't supported or the table is full
+			 */
+			[[nodiscard]] uint32_t GetBindlessIndex() const;
+
+			/**
+			 * True if the device can sample images with the given compression
+			 */
+			[[nodiscard]] static bool IsSupported(IO::Image::BlockCompression compression);
+
+			/**
+			 * Returns the first candidate the device can sample, only the headers of compressed files are read.
+			 * Candidates are usually the same texture in different compressions (e.g. ASTC, BC7, PNG), the last one is returned if none are supported.
+			 */
+			[[nodiscard]] static std::filesystem::path SelectSupportedImage(const std::vector<std::filesystem::path>& candidates);
+
 		private:
 			IO::Image             _ioImage;
 			Vulkan::Image         _vulkanImage;
 			const vk::Sampler*    _sampler{};
 			const TextureSettings _textureSettings;
+			uint32_t              _bindlessIndex = -1u;
 
 			static vk::Format GetVulkanFormat(const IO::Image& image);
+			static vk::Format GetVulkanFormat(IO::Image::BlockCompression compression, bool srgb);
+
+			static bool ShouldGenerateMipmaps(const CreateInfo& createInfo);
 	};
 }
@@ -35,7 +35,7 @@ namespace SplitEngine::Rendering
 			glm::vec<3, WrapMode> WrapMode            = {WrapMode::Repeat, WrapMode::Repeat, WrapMode::Repeat};
 			float                 MipLodBias          = 0;
 			float                 MinLod              = 0.0f;
-			float                 MaxLod              = 0.0f;
+			float                 MaxLod              = vk::LodClampNone;
 			float                 MaxAnisotropy       = 0.0f;
 
 			bool operator==(const TextureSettings& other) const
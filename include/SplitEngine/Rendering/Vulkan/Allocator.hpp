@@ -1,8 +1,11 @@
 #pragma once
 
+#include "SplitEngine/Contexts.hpp"
 #include "SplitEngine/Rendering/TextureSettings.hpp"
 
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include <vk_mem_alloc.h>
 
@@ -10,11 +13,33 @@ namespace SplitEngine::Rendering::Vulkan
 {
 	class Instance;
 
+	/**
+	 * Wraps VMA, buffers and images get their memory from here.
+	 *
+	 * The usage and budget of every memory heap are fetched once per frame, with VK_EXT_memory_budget they come from the driver and include other processes.
+	 * A warning is logged whenever a heap crosses one of the warning thresholds of the rendering settings.
+	 *
+	 * Once enough memory is allocated but unused inside VMA's blocks, allocations get compacted with incremental defragmentation passes.
+	 * Only buffers that enabled defragmentation are moved, everything else stays where it is.
+	 */
 	class Allocator
 	{
 		public:
 			explicit Allocator(const Instance& instance);
 
+			/**
+			 * Needs to be called once per frame before anything gets recorded.
+			 * A defragmentation pass waits for the gpu to finish every frame in flight, so passes only run if canDefragment is true
+			 * and at most every DefragmentationPassInterval frames.
+			 * The mesh arena and upload manager stay locked for the whole pass, it's skipped if an upload got recorded in the meantime.
+			 */
+			void Update(bool canDefragment);
+
+			/**
+			 * Usage and budget of each memory heap as of the last update
+			 */
+			[[nodiscard]] const std::vector<GpuMemoryHeapStatistics>& GetMemoryHeapStatistics() const;
+
 			void Destroy();
 
 #pragma region Memory
@@ -97,13 +122,45 @@ namespace SplitEngine::Rendering::Vulkan
 
 			void UnmapMemory(const MemoryAllocation& memoryAllocation) const;
 
+			/**
+			 * Lets defragmentation move the buffer, the buffer handle of the allocation gets replaced with one bound to the new memory.
+			 * The allocation can't be moved in memory itself until the buffer is destroyed, since the allocator writes the new handle back into it.
+			 */
+			void EnableDefragmentation(BufferAllocation& bufferAllocation, const vk::BufferCreateInfo& bufferCreateInfo);
+
 		private:
+			struct MovableBuffer
+			{
+				BufferAllocation*    Allocation = nullptr;
+				vk::BufferCreateInfo CreateInfo{};
+			};
+
 			VmaAllocator    _vmaAllocator = nullptr;
 			const Instance& _instance;
 
 			size_t _buffersAllocated = 0;
 			size_t _imagesAllocated  = 0;
 
+			uint32_t                             _frameIndex = 0;
+			std::vector<VmaBudget>               _budgets{};
+			std::vector<GpuMemoryHeapStatistics> _heapStatistics{};
+			std::vector<size_t>                  _heapWarningLevels{};
+
+			std::unordered_map<VmaAllocation, MovableBuffer> _movableBuffers{};
+			std::mutex                                       _movableBufferMutex{};
+
+			VmaDefragmentationContext _defragmentationContext          = nullptr;
+			uint32_t                  _framesSinceDefragmentationPass  = 0;
+			uint64_t                  _unusedBytesAfterDefragmentation = 0;
+
+			void UpdateHeapStatistics();
+
+			[[nodiscard]] uint64_t GetUnusedBytes() const;
+
+			void RunDefragmentationPass();
+
+			void EndDefragmentation();
+
 			static VmaAllocationCreateInfo CreateVmaAllocationCreateInfo(const MemoryAllocationCreateInfo& memoryAllocationCreateInfo);
 #pragma endregion
 
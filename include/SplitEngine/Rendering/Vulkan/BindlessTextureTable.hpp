@@ -0,0 +1,78 @@
+#pragma once
+
+#include "DeviceObject.hpp"
+#include "InFlightResource.hpp"
+
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	class Device;
+
+	/**
+	 * Hands out stable indices into one big update after bind sampler array in the global descriptor set.
+	 * Textures register themselves once and shaders index the array directly, so switching textures doesn't need another descriptor set or rebind.
+	 *
+	 * The array is declared in a shader with the bindless modifier (see ShaderParserSettings), entries registered before that shader exists are written as soon as it does.
+	 * Unregistered indices are only reused once every frame in flight that could still reference them has finished.
+	 *
+	 * Update after bind only allows writes while a set is bound in a command buffer that's still recording, not while a submitted one is executing.
+	 * So every frame in flight has its own set and entries are written into it once that frame's fence was waited on, the set of the frame being recorded is written right away.
+	 */
+	class BindlessTextureTable final : public DeviceObject
+	{
+		public:
+			BindlessTextureTable() = default;
+
+			BindlessTextureTable(Device* device, uint32_t maxTextures);
+
+			/**
+			 * Returns -1 if the device doesn't support bindless textures
+			 */
+			[[nodiscard]] uint32_t Register(const vk::DescriptorImageInfo& imageInfo);
+
+			void Unregister(uint32_t index);
+
+			/**
+			 * Needs to be called after the in flight fence of the current frame has been waited on
+			 */
+			void Update();
+
+			/**
+			 * Needs to be called before the current frame gets submitted, entries registered after that are written once the frame comes around again
+			 */
+			void EndFrame();
+
+			/**
+			 * Called once the global descriptor set containing the bindless binding was created
+			 */
+			void Attach(const std::vector<vk::DescriptorSet>& descriptorSets, uint32_t binding);
+
+			[[nodiscard]] bool     IsSupported() const;
+			[[nodiscard]] uint32_t GetCapacity() const;
+
+			void Destroy() override;
+
+		private:
+			bool     _isSupported = false;
+			uint32_t _capacity    = 0;
+
+			std::vector<vk::DescriptorImageInfo> _imageInfos{};
+			std::vector<uint32_t>                _freeIndices{};
+			uint32_t                             _nextIndex = 0;
+
+			// Indices unregistered since the last update wait for the frame that begins next, it was submitted after they were unregistered
+			std::vector<uint32_t>                   _unregisteredIndices{};
+			InFlightResource<std::vector<uint32_t>> _retiredIndices{};
+			InFlightResource<std::vector<uint32_t>> _pendingWrites{};
+
+			InFlightResource<vk::DescriptorSet> _descriptorSets{};
+			uint32_t                            _binding                = -1u;
+			bool                                _isCurrentFrameWritable = false;
+
+			void QueueWrites(uint32_t firstIndex, uint32_t count);
+
+			void FlushPendingWrites();
+	};
+}
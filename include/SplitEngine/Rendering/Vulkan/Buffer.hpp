@@ -90,6 +90,12 @@ namespace SplitEngine::Rendering::Vulkan
 
 			void Stage(const char** data) const;
 
+			/**
+			 * Lets the allocator move the buffer while defragmenting, GetVkBuffer returns a new handle afterwards.
+			 * The buffer object itself can't be moved anymore and its handle can't be stored in anything that outlives recording a frame, like a descriptor set.
+			 */
+			void EnableDefragmentation();
+
 			void Invalidate(size_t subBufferIndex = 0) const;
 
 			void Flush(size_t subBufferIndex = 0) const;
@@ -126,7 +132,9 @@ namespace SplitEngine::Rendering::Vulkan
 
 		private:
 			Allocator::BufferAllocation _bufferAllocation{};
-			vk::DeviceSize              _bufferSize = 0;
+			vk::DeviceSize              _bufferSize  = 0;
+			vk::BufferUsageFlags        _usage       = {};
+			vk::SharingMode             _sharingMode = vk::SharingMode::eExclusive;
 
 			std::vector<SubBuffer>                _subBuffers;
 			Allocator::MemoryAllocationCreateInfo _allocationCreateInfo;
@@ -12,16 +12,19 @@ namespace SplitEngine::Rendering::Vulkan
 	{
 		public:
 			CommandBuffer() = default;
-			CommandBuffer(Device* device, QueueType type, InFlightResource<vk::CommandBuffer>&& commandBuffers);
+			CommandBuffer(Device* device, QueueType type, InFlightResource<vk::CommandBuffer>&& commandBuffers, vk::CommandPool commandPool);
 
 			vk::CommandBuffer& GetVkCommandBuffer(const uint32_t fifIndex = -1);
 
 			InFlightResource<vk::CommandBuffer>& GetVkCommandBufferRaw();
 
+			[[nodiscard]] const vk::CommandPool& GetCommandPool() const;
+
 			void Destroy() override;
 
 		private:
 			QueueType                           _queueType = QueueType::MAX_VALUE;
 			InFlightResource<vk::CommandBuffer> _commandBuffers;
+			vk::CommandPool                     _commandPool = VK_NULL_HANDLE;
 	};
 }
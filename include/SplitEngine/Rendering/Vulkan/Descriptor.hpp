@@ -18,6 +18,10 @@ namespace SplitEngine::Rendering::Vulkan
 		Buffer   Buffer {};
 		bool     SingleInstance = false;
 
+		// Block the descriptor got suballocated from, Buffer stays empty in that case unless it gets overridden
+		Vulkan::Buffer* BlockBuffer = nullptr;
+		vk::DeviceSize  BlockOffset = 0;
+
 		InFlightResource<std::vector<vk::DescriptorImageInfo>> ImageInfos;
 		InFlightResource<vk::DescriptorBufferInfo>             BufferInfos;
 		InFlightResource<std::byte*>                           BufferPtrs;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Allocator.hpp"
+#include "Buffer.hpp"
+#include "DeviceObject.hpp"
+#include "FreeRangeList.hpp"
+#include "InFlightResource.hpp"
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	class Device;
+
+	/**
+	 * Backing memory for the uniform and storage buffers of descriptors that aren't shared.
+	 * Buffers with the same usage and memory requirements are suballocated from a few large blocks, so every material instance doesn't need its own buffer and allocation.
+	 * Each block keeps its free ranges sorted by offset, freed ranges get merged with their neighbours and are reused by the next allocation that fits.
+	 * Frames in flight can still read descriptors of a freed range, so it only goes back to its block once all of them have finished.
+	 */
+	class DescriptorBufferArena final : public DeviceObject
+	{
+		public:
+			struct Range
+			{
+				Buffer*        Buffer        = nullptr;
+				vk::DeviceSize OffsetInBytes = 0;
+				vk::DeviceSize SizeInBytes   = 0;
+				uint32_t       PoolIndex     = -1u;
+				uint32_t       BlockIndex    = -1u;
+			};
+
+			DescriptorBufferArena() = default;
+
+			DescriptorBufferArena(Device* device, vk::DeviceSize blockSizeInBytes);
+
+			/**
+			 * Ranges bigger than the block size get a block of their own, the offset is a multiple of the alignment
+			 */
+			[[nodiscard]] Range Allocate(vk::BufferUsageFlags usage, const Allocator::MemoryAllocationCreateInfo& allocationCreateInfo, vk::DeviceSize sizeInBytes, vk::DeviceSize alignment);
+
+			void Free(const Range& range);
+
+			/**
+			 * Needs to be called after the in flight fence of the current frame has been waited on
+			 */
+			void Update();
+
+			void Destroy() override;
+
+		private:
+			struct Block
+			{
+				Buffer        Buffer{};
+				FreeRangeList FreeRanges{};
+			};
+
+			/**
+			 * All blocks of a pool share usage and memory requirements
+			 */
+			struct Pool
+			{
+				vk::BufferUsageFlags                  Usage{};
+				Allocator::MemoryAllocationCreateInfo AllocationCreateInfo{};
+				std::deque<Block>                     Blocks{};
+			};
+
+			vk::DeviceSize _blockSizeInBytes = 0;
+
+			// Ranges point at the buffers of their block, so neither pools nor blocks can be stored in something that moves them around
+			std::deque<Pool> _pools{};
+			std::mutex       _mutex{};
+
+			// Ranges freed since the last update wait for the frame that begins next, it was submitted after they were freed
+			std::vector<Range>                   _freedRanges{};
+			InFlightResource<std::vector<Range>> _retiredRanges{};
+
+			[[nodiscard]] uint32_t GetPoolIndex(vk::BufferUsageFlags usage, const Allocator::MemoryAllocationCreateInfo& allocationCreateInfo);
+	};
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Buffer.hpp"
+#include "DescriptorBufferArena.hpp"
+#include "DescriptorWriteBatch.hpp"
 #include "DeviceObject.hpp"
 
 #include "InFlightResource.hpp"
@@ -43,6 +45,8 @@ namespace SplitEngine::Rendering
 						bool        NoCoherant             = false;
 						bool        TransferSrc            = false;
 						bool        TransferDst            = false;
+						bool        Dynamic                = false;
+						bool        Bindless               = false;
 				};
 
 				struct CreateInfo
@@ -55,18 +59,15 @@ namespace SplitEngine::Rendering
 						std::vector<DescriptorCreateInfo>                DescriptorCreateInfos    = std::vector<DescriptorCreateInfo>(0);
 				};
 
+				/**
+				 * Sets are never freed on their own, a pool is reset as a whole once every allocation made from it has been deallocated
+				 */
 				struct DescriptorPoolInstance
 				{
 					public:
-						vk::DescriptorPool             DescriptorPool;
-						std::vector<vk::DescriptorSet> DescriptorSets;
-						AvailableStack<uint32_t>       Available;
-				};
-
-				struct DescriptorPoolAllocation
-				{
-					uint32_t DescriptorPoolIndex;
-					uint32_t DescriptorSetIndex;
+						vk::DescriptorPool DescriptorPool;
+						uint32_t           NumAllocatedSets   = 0;
+						uint32_t           NumLiveAllocations = 0;
 				};
 
 				struct Allocation
@@ -84,10 +85,21 @@ namespace SplitEngine::Rendering
 						std::vector<DescriptorEntry>                          DescriptorEntries;
 						std::vector<InFlightResource<vk::WriteDescriptorSet>> WriteDescriptorSets;
 						std::vector<uint32_t>                                 SparseDescriptorLookup = std::vector<uint32_t>(12, -1);
+						const DescriptorWriteBatch::UpdateTemplate*           UpdateTemplate         = nullptr;
+
+						// Offsets of the dynamic buffer descriptors ordered by binding, this is the order bindDescriptorSets expects them in
+						std::vector<uint32_t> DynamicOffsets{};
+						std::vector<uint32_t> SparseDynamicOffsetLookup = std::vector<uint32_t>(12, -1);
+
+						/**
+						 * Gives the block range of the descriptor back to the arena, used once the descriptor gets a buffer of its own
+						 */
+						void FreeBlockRange(const Descriptor& descriptor);
 
 					private:
-						std::vector<Descriptor>               _uniqueDescriptors;
-						std::vector<DescriptorPoolAllocation> _descriptorPoolAllocations;
+						std::vector<Descriptor>                   _uniqueDescriptors;
+						std::vector<DescriptorBufferArena::Range> _bufferRanges;
+						uint32_t                                  _descriptorPoolIndex = -1u;
 				};
 
 			public:
@@ -98,24 +110,55 @@ namespace SplitEngine::Rendering
 
 				Allocation AllocateDescriptorSet();
 
+				/**
+				 * Allocates count descriptor sets with as few allocation and update calls as possible
+				 */
+				std::vector<Allocation> AllocateDescriptorSets(uint32_t count);
+
 				void DeallocateDescriptorSet(Allocation& descriptorSetAllocation);
 
 				[[nodiscard]] const vk::DescriptorSetLayout& GetDescriptorSetLayout() const;
 
 			private:
+				/**
+				 * Describes the backing memory of one non shared buffer descriptor, every allocation gets a range of this size from the descriptor buffer arena
+				 */
+				struct BufferLayout
+				{
+					vk::BufferUsageFlags                  Usage{};
+					Allocator::MemoryAllocationCreateInfo AllocationCreateInfo{};
+					vk::DeviceSize                        SizeInBytes = 0;
+					vk::DeviceSize                        Alignment   = 1;
+				};
+
 				std::vector<uint32_t>                            _bindings;
 				vk::DescriptorSetLayout                          _descriptorSetLayout;
 				std::vector<vk::DescriptorSetLayout>             _descriptorSetLayouts;
 				std::vector<DescriptorPoolInstance>              _descriptorPoolInstances;
+				std::vector<uint32_t>                            _availableDescriptorPools;
+				uint32_t                                         _currentDescriptorPool = -1u;
 				std::vector<vk::DescriptorPoolSize>              _descriptorPoolSizes;
 				std::vector<std::vector<vk::WriteDescriptorSet>> _writeDescriptorSets;
 				std::vector<DescriptorCreateInfo>                _descriptorCreateInfo;
-				uint32_t                                         _maxSetsPerPool = 10;
+				std::vector<BufferLayout>                        _bufferLayouts;
+				std::vector<uint32_t>                            _bufferLayoutLookup;
+				std::vector<uint32_t>                            _dynamicBindings;
+				uint32_t                                         _numUniqueDescriptors = 0;
+				uint32_t                                         _maxSetsPerPool       = 10;
+				bool                                             _updateAfterBind      = false;
+				const DescriptorWriteBatch::UpdateTemplate*      _updateTemplate       = nullptr;
 
 				static uint32_t                                    _descriptorIdCounter;
 				static std::unordered_map<std::string, Descriptor> _sharedDescriptors;
 
 				void AllocateNewDescriptorPool();
+
+				/**
+				 * Returns the index of a pool that can hold at least one more allocation
+				 */
+				uint32_t AcquireDescriptorPool();
+
+				void CreateDescriptors(Allocation& descriptorSetAllocation, std::vector<vk::WriteDescriptorSet>& writeDescriptorSets);
 		};
 	}
 }
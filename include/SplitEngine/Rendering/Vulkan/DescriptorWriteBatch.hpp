@@ -0,0 +1,97 @@
+#pragma once
+
+#include "DeviceObject.hpp"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	class Device;
+
+	/**
+	 * Collects the descriptor writes of all shader and material properties and applies them with a single update call.
+	 * Writes are deduplicated per set and binding, every frame in flight has its own set so a binding that gets dirtied multiple times in a frame is only written once.
+	 * The write only stores pointers to the image and buffer infos of the descriptor, so whatever was set last before the flush is what ends up in the set.
+	 *
+	 * Sets that had every binding dirtied are written with the update template of their layout instead, which skips parsing a write per binding in the driver.
+	 *
+	 * The batch is flushed once per frame before recording starts, a set that gets bound while it has pending writes is flushed on its own.
+	 */
+	class DescriptorWriteBatch final : public DeviceObject
+	{
+		public:
+			/**
+			 * Update template of a set layout, the template data holds the infos of all bindings tightly packed in binding order
+			 */
+			struct UpdateTemplate
+			{
+				vk::DescriptorUpdateTemplate Template = VK_NULL_HANDLE;
+				std::vector<uint32_t>        Bindings{};
+				std::vector<size_t>          Offsets{};
+				size_t                       SizeInBytes = 0;
+			};
+
+			DescriptorWriteBatch() = default;
+
+			explicit DescriptorWriteBatch(Device* device);
+
+			/**
+			 * Returns nullptr if the layout can't be written with a template, that's the case for bindless and texel buffer bindings.
+			 * The template is owned by the batch and stays valid until it gets destroyed again.
+			 */
+			[[nodiscard]] const UpdateTemplate* CreateUpdateTemplate(const vk::DescriptorSetLayout& descriptorSetLayout, const std::vector<vk::DescriptorSetLayoutBinding>& bindings, bool bindless);
+
+			void DestroyUpdateTemplate(const UpdateTemplate* updateTemplate);
+
+			/**
+			 * Replaces a pending write of the same set and binding, the update template is the one of the layout the set was allocated with
+			 */
+			void Add(const vk::WriteDescriptorSet& writeDescriptorSet, const UpdateTemplate* updateTemplate);
+
+			/**
+			 * Drops pending writes to sets that are about to be freed, their infos might not be alive anymore at the next flush
+			 */
+			void Discard(const vk::DescriptorSet& descriptorSet);
+
+			/**
+			 * Applies all pending writes, none of the written sets may be bound in a command buffer that's still recording
+			 */
+			void Flush();
+
+			/**
+			 * Only applies the pending writes of the given set, the set may not be bound in a command buffer that's still recording
+			 */
+			void Flush(const vk::DescriptorSet& descriptorSet);
+
+			[[nodiscard]] bool HasPendingWrites() const;
+
+			void Destroy() override;
+
+		private:
+			struct PendingSet
+			{
+				vk::DescriptorSet                           DescriptorSet  = VK_NULL_HANDLE;
+				const DescriptorWriteBatch::UpdateTemplate* UpdateTemplate = nullptr;
+				std::vector<vk::WriteDescriptorSet>         Writes{};
+			};
+
+			std::vector<PendingSet>                       _pendingSets{};
+			uint32_t                                      _numPendingSets = 0;
+			std::unordered_map<VkDescriptorSet, uint32_t> _pendingSetLookup{};
+
+			std::vector<vk::WriteDescriptorSet> _writeDescriptorSets{};
+			std::vector<std::byte>              _templateData{};
+
+			std::vector<std::unique_ptr<UpdateTemplate>> _updateTemplates{};
+			std::mutex                                   _updateTemplateMutex{};
+
+			/**
+			 * Sets that can be written with their template are written right away, the writes of all others are appended to _writeDescriptorSets
+			 */
+			void WritePendingSet(const PendingSet& pendingSet);
+	};
+}
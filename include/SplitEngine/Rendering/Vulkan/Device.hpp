@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Image.hpp"
+#include "OffscreenTargets.hpp"
 #include "Pipeline.hpp"
 #include "RenderPass.hpp"
 #include "Swapchain.hpp"
@@ -17,7 +18,10 @@ namespace SplitEngine::Rendering::Vulkan
 	class Device
 	{
 		public:
-			static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+			/**
+			 * Upper bound for the frames in flight set in the rendering settings
+			 */
+			static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
 
 			explicit Device(PhysicalDevice& physicalDevice);
 
@@ -30,10 +34,21 @@ namespace SplitEngine::Rendering::Vulkan
 			void CreateSwapchain(vk::SurfaceKHR surfaceKhr, glm::ivec2 size);
 			void DestroySwapchain();
 
+			/**
+			 * Replaces the swapchain in headless mode, there needs to be at least one image per frame in flight
+			 */
+			void CreateOffscreenTargets(vk::Extent2D size, uint32_t numImages, bool readback);
+			void DestroyOffscreenTargets();
+
+			/**
+			 * Writes the pipeline cache to the path in the rendering settings, this is done automatically on destroy
+			 */
+			void SavePipelineCache() const;
+
 			template<typename T>
 			InFlightResource<T> CreateInFlightResource(bool singleInstance = false, T defaultValue = {})
 			{
-				return InFlightResource<T>(GetCurrentFramePtr(singleInstance), std::vector<T>(singleInstance ? 1 : MAX_FRAMES_IN_FLIGHT, defaultValue));
+				return InFlightResource<T>(GetCurrentFramePtr(singleInstance), std::vector<T>(singleInstance ? 1 : _numFramesInFlight, defaultValue));
 			}
 
 			template<typename T>
@@ -41,16 +56,47 @@ namespace SplitEngine::Rendering::Vulkan
 
 			[[nodiscard]] const PhysicalDevice&                     GetPhysicalDevice() const;
 			[[nodiscard]] const Swapchain&                          GetSwapchain() const;
+			[[nodiscard]] const OffscreenTargets&                   GetOffscreenTargets() const;
+			[[nodiscard]] bool                                      IsHeadless() const;
 			[[nodiscard]] const RenderPass&                         GetRenderPass() const;
 			[[nodiscard]] const vk::Device&                         GetVkDevice() const;
 			[[nodiscard]] const QueueFamily&                        GetQueueFamily(const QueueType queueFamilyType) const;
 			[[nodiscard]] QueueFamily&                              GetQueueFamily(const QueueType queueFamilyType);
 			[[nodiscard]] const vk::PhysicalDeviceMemoryProperties& GetMemoryProperties() const;
+			[[nodiscard]] const vk::PipelineCache&                  GetPipelineCache() const;
+			[[nodiscard]] const vk::PhysicalDeviceFeatures&         GetEnabledFeatures() const;
+
+			/**
+			 * True if the descriptor indexing features needed by the BindlessTextureTable have been enabled
+			 */
+			[[nodiscard]] bool SupportsBindlessTextures() const;
+
+			/**
+			 * Without it indirect draws can't read their draw count from a buffer and have to draw a fixed number of (possibly empty) commands
+			 */
+			[[nodiscard]] bool SupportsDrawIndirectCount() const;
+
+			/**
+			 * True if a single indirect draw can issue multiple draws with their own first instance, which lets the RenderQueue merge draws that share all their state
+			 */
+			[[nodiscard]] bool SupportsMultiDrawIndirect() const;
+
+			/**
+			 * Size of the images rendered to, these come either from the swapchain or the offscreen targets
+			 */
+			[[nodiscard]] vk::Extent2D GetRenderExtent() const;
+
+			[[nodiscard]] const vk::Framebuffer& GetFrameBuffer(uint32_t imageIndex) const;
 
 			[[nodiscard]] const vk::Semaphore& GetImageAvailableSemaphore() const;
 			[[nodiscard]] const vk::Semaphore& GetRenderFinishedSemaphore() const;
 			[[nodiscard]] const vk::Fence&     GetInFlightFence() const;
 
+			/**
+			 * Frames the cpu can record ahead of the gpu, more hides stalls but adds a frame of input latency each
+			 */
+			[[nodiscard]] uint32_t GetNumFramesInFlight() const;
+
 			uint32_t* GetCurrentFramePtr(bool staticPtr = false);
 
 			[[nodiscard]] int FindMemoryTypeIndex(const vk::MemoryRequirements& memoryRequirements, const vk::Flags<vk::MemoryPropertyFlagBits>& memoryPropertyFlags) const;
@@ -58,11 +104,13 @@ namespace SplitEngine::Rendering::Vulkan
 		private:
 			uint32_t _currentStaticFrame = 0;
 			uint32_t _currentFrame       = 0;
+			uint32_t _numFramesInFlight  = 1;
 
 			vk::Device      _vkDevice;
 			PhysicalDevice& _physicalDevice;
 
-			std::unique_ptr<Swapchain> _swapchain;
+			std::unique_ptr<Swapchain>        _swapchain;
+			std::unique_ptr<OffscreenTargets> _offscreenTargets;
 
 			RenderPass _renderPass;
 
@@ -78,8 +126,16 @@ namespace SplitEngine::Rendering::Vulkan
 
 			vk::PhysicalDeviceMemoryProperties _memoryProperties;
 
+			vk::PipelineCache _pipelineCache = VK_NULL_HANDLE;
+
+			vk::PhysicalDeviceFeatures         _features{};
+			vk::PhysicalDeviceVulkan12Features _vulkan12Features{};
+
 			void CreateLogicalDevice(PhysicalDevice& physicalDevice);
 			void CreateRenderPass();
 			void CreateSyncObjects();
+			void CreatePipelineCache();
+
+			[[nodiscard]] bool IsPipelineCacheCompatible(const std::vector<std::byte>& cacheData) const;
 	};
 }
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <map>
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	/**
+	 * Free ranges of a buffer that gets suballocated, sorted by offset.
+	 * Freed ranges get merged with their neighbours so the list stays short and big allocations can still fit after lots of small ones were freed.
+	 */
+	class FreeRangeList
+	{
+		public:
+			FreeRangeList() = default;
+
+			explicit FreeRangeList(vk::DeviceSize sizeInBytes);
+
+			/**
+			 * First fit, the offset is a multiple of the alignment which doesn't need to be a power of two
+			 */
+			[[nodiscard]] bool TryAllocate(vk::DeviceSize sizeInBytes, vk::DeviceSize alignment, vk::DeviceSize& offsetInBytes);
+
+			void Free(vk::DeviceSize offsetInBytes, vk::DeviceSize sizeInBytes);
+
+		private:
+			std::map<vk::DeviceSize, vk::DeviceSize> _freeRanges{};
+	};
+}
@@ -10,6 +10,8 @@ namespace SplitEngine::Rendering::Vulkan
 
 	class Image : public DeviceObject
 	{
+		friend class UploadManager;
+
 		public:
 			struct CreateInfo
 			{
@@ -19,8 +21,17 @@ namespace SplitEngine::Rendering::Vulkan
 					vk::Flags<vk::ImageAspectFlagBits> AspectMask       = vk::ImageAspectFlagBits::eColor;
 					vk::Format                         Format           = vk::Format::eR8G8B8A8Srgb;
 					VkMemoryPropertyFlags              RequiredFlags    = {};
+
+					/**
+					 * Number of mip levels, FULL_MIP_CHAIN goes down to 1x1.
+					 * The pixels either contain all levels tightly packed starting with the biggest one, or only the biggest one if GenerateMipmaps is set
+					 */
+					uint32_t MipLevels       = 1;
+					bool     GenerateMipmaps = false;
 			};
 
+			static constexpr uint32_t FULL_MIP_CHAIN = -1u;
+
 		public:
 			Image() = default;
 			Image(Device* device, const std::byte* pixels, vk::DeviceSize pixelsSizeInBytes, vk::Extent3D extend, CreateInfo createInfo);
@@ -33,11 +44,17 @@ namespace SplitEngine::Rendering::Vulkan
 			[[nodiscard]] const vk::Image&       GetVkImage() const;
 			[[nodiscard]] const vk::ImageView&   GetView() const;
 			[[nodiscard]] const vk::ImageLayout& GetLayout() const;
+			[[nodiscard]] uint32_t               GetMipLevels() const;
+			[[nodiscard]] vk::Format             GetFormat() const;
+
+			[[nodiscard]] static uint32_t CalculateMipLevels(vk::Extent3D extent);
 
 		private:
 			Allocator::ImageAllocation _imageAllocation;
 			vk::ImageView              _view = VK_NULL_HANDLE;
 
-			vk::ImageLayout _layout = vk::ImageLayout::eUndefined;
+			vk::ImageLayout _layout    = vk::ImageLayout::eUndefined;
+			uint32_t        _mipLevels = 1;
+			vk::Format      _format    = vk::Format::eUndefined;
 	};
 }
@@ -4,8 +4,13 @@
 #include "SplitEngine/RenderingSettings.hpp"
 #include "SplitEngine/ShaderParserSettings.hpp"
 #include "SplitEngine/Window.hpp"
+#include "SplitEngine/Rendering/Vulkan/BindlessTextureTable.hpp"
+#include "SplitEngine/Rendering/Vulkan/DescriptorBufferArena.hpp"
+#include "SplitEngine/Rendering/Vulkan/DescriptorWriteBatch.hpp"
 #include "SplitEngine/Rendering/Vulkan/Device.hpp"
+#include "SplitEngine/Rendering/Vulkan/MeshArena.hpp"
 #include "SplitEngine/Rendering/Vulkan/PhysicalDevice.hpp"
+#include "SplitEngine/Rendering/Vulkan/UploadManager.hpp"
 
 #include <vulkan/vulkan.hpp>
 
@@ -29,6 +34,11 @@ namespace SplitEngine::Rendering::Vulkan
 			[[nodiscard]] const ShaderParserSettings& GetShaderParserSettings() const;
 			[[nodiscard]] PhysicalDevice&             GetPhysicalDevice() const;
 			[[nodiscard]] Allocator&                  GetAllocator() const;
+			[[nodiscard]] UploadManager&              GetUploadManager() const;
+			[[nodiscard]] BindlessTextureTable&       GetBindlessTextureTable() const;
+			[[nodiscard]] DescriptorWriteBatch&       GetDescriptorWriteBatch() const;
+			[[nodiscard]] DescriptorBufferArena&      GetDescriptorBufferArena() const;
+			[[nodiscard]] MeshArena&                  GetMeshArena() const;
 			[[nodiscard]] const vk::Instance&         GetVkInstance() const;
 			[[nodiscard]] const vk::SurfaceKHR&       GetVkSurface() const;
 			[[nodiscard]] vk::Viewport                CreateViewport(const vk::Extent2D extent) const;
@@ -39,8 +49,13 @@ namespace SplitEngine::Rendering::Vulkan
 			ShaderParserSettings _shaderParserSettings;
 			RenderingSettings    _renderingSettings;
 
-			std::unique_ptr<PhysicalDevice> _physicalDevice;
-			std::unique_ptr<Allocator>      _allocator;
+			std::unique_ptr<PhysicalDevice>        _physicalDevice;
+			std::unique_ptr<Allocator>             _allocator;
+			std::unique_ptr<UploadManager>         _uploadManager;
+			std::unique_ptr<BindlessTextureTable>  _bindlessTextureTable;
+			std::unique_ptr<DescriptorWriteBatch>  _descriptorWriteBatch;
+			std::unique_ptr<DescriptorBufferArena> _descriptorBufferArena;
+			std::unique_ptr<MeshArena>             _meshArena;
 
 			Image              _defaultImage;
 			const vk::Sampler* _defaultSampler = nullptr;
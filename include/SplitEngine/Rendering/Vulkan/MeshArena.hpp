@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Buffer.hpp"
+#include "DeviceObject.hpp"
+#include "FreeRangeList.hpp"
+#include "InFlightResource.hpp"
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	class Device;
+
+	/**
+	 * Vertices and indices of all models, suballocated from a few large device local buffers.
+	 * The buffers are always bound at offset 0 and every mesh is addressed through its base vertex and first index instead,
+	 * so consecutive draws of different models only need to rebind anything if their meshes ended up in different blocks or use a different index type.
+	 *
+	 * 16 and 32 bit indices share the same index blocks, each mesh is aligned to the size of its own index type.
+	 * Frames in flight can still draw a freed mesh, so its ranges only go back to their blocks once all of them have finished.
+	 */
+	class MeshArena final : public DeviceObject
+	{
+		public:
+			struct Mesh
+			{
+				uint32_t       VertexBlockIndex    = -1u;
+				uint32_t       IndexBlockIndex     = -1u;
+				vk::DeviceSize VertexOffsetInBytes = 0;
+				vk::DeviceSize VertexSizeInBytes   = 0;
+				vk::DeviceSize IndexOffsetInBytes  = 0;
+				vk::DeviceSize IndexSizeInBytes    = 0;
+
+				/**
+				 * Base vertex and first index to draw the mesh with
+				 */
+				int32_t       VertexOffset = 0;
+				uint32_t      FirstIndex   = 0;
+				uint32_t      NumIndices   = 0;
+				vk::IndexType IndexType    = vk::IndexType::eUint16;
+
+				/**
+				 * True if both meshes can be drawn without binding anything in between
+				 */
+				[[nodiscard]] bool SharesBuffersWith(const Mesh& other) const
+				{
+					return VertexBlockIndex == other.VertexBlockIndex && IndexBlockIndex == other.IndexBlockIndex && IndexType == other.IndexType;
+				}
+			};
+
+			MeshArena() = default;
+
+			MeshArena(Device* device, vk::DeviceSize vertexBlockSizeInBytes, vk::DeviceSize indexBlockSizeInBytes);
+
+			/**
+			 * Copies the mesh into the arena, like staged buffers it's usable in the current frame without waiting.
+			 * The vertex size is needed so the vertices start at a whole vertex and can be reached with a base vertex.
+			 */
+			[[nodiscard]] Mesh Allocate(const std::byte* vertices,
+			                            vk::DeviceSize   verticesSizeInBytes,
+			                            vk::DeviceSize   vertexSizeInBytes,
+			                            const std::byte* indices,
+			                            uint32_t         numIndices,
+			                            vk::IndexType    indexType);
+
+			void Free(const Mesh& mesh);
+
+			/**
+			 * Needs to be called after the in flight fence of the current frame has been waited on
+			 */
+			void Update();
+
+			void Bind(const vk::CommandBuffer& commandBuffer, const Mesh& mesh) const;
+
+			[[nodiscard]] const Buffer& GetVertexBuffer(uint32_t blockIndex) const;
+			[[nodiscard]] const Buffer& GetIndexBuffer(uint32_t blockIndex) const;
+
+			void Destroy() override;
+
+			/**
+			 * Keeps other threads from allocating or freeing meshes while the lock is held
+			 */
+			[[nodiscard]] std::unique_lock<std::mutex> Lock();
+
+		private:
+			struct Block
+			{
+				Buffer        Buffer{};
+				FreeRangeList FreeRanges{};
+			};
+
+			vk::DeviceSize _vertexBlockSizeInBytes = 0;
+			vk::DeviceSize _indexBlockSizeInBytes  = 0;
+
+			std::deque<Block> _vertexBlocks{};
+			std::deque<Block> _indexBlocks{};
+			std::mutex        _mutex{};
+
+			// Meshes freed since the last update wait for the frame that begins next, it was submitted after they were freed
+			std::vector<Mesh>                   _freedMeshes{};
+			InFlightResource<std::vector<Mesh>> _retiredMeshes{};
+
+			/**
+			 * Returns the index of the block the range was allocated in
+			 */
+			[[nodiscard]] uint32_t Allocate(std::deque<Block>&   blocks,
+			                                vk::BufferUsageFlags usage,
+			                                vk::DeviceSize       blockSizeInBytes,
+			                                vk::DeviceSize       sizeInBytes,
+			                                vk::DeviceSize       alignment,
+			                                vk::DeviceSize&      offsetInBytes) const;
+	};
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Buffer.hpp"
+#include "DeviceObject.hpp"
+#include "Image.hpp"
+#include "SplitEngine/IO/Image.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	class Device;
+
+	/**
+	 * Stands in for the swapchain in headless mode, frames are rendered into a ring of images that are used in turn.
+	 * Every image can have a host visible buffer the frame gets copied into, so it can be read back once the frame is done on the gpu.
+	 */
+	class OffscreenTargets final : public DeviceObject
+	{
+		public:
+			OffscreenTargets() = default;
+
+			explicit OffscreenTargets(Device* device, vk::Extent2D size, uint32_t numImages, bool readback);
+
+			void Destroy() override;
+
+			/**
+			 * Copies the image into its readback buffer, needs to be recorded after the main render pass that rendered into it
+			 */
+			void RecordReadback(const vk::CommandBuffer& commandBuffer, uint32_t imageIndex) const;
+
+			/**
+			 * Returns the pixels of the last frame that was rendered into the image as RGBA, the gpu needs to be done with that frame
+			 */
+			[[nodiscard]] IO::Image ReadBack(uint32_t imageIndex) const;
+
+			[[nodiscard]] const std::vector<Image>&           GetImages() const;
+			[[nodiscard]] const vk::Extent2D&                 GetExtend() const;
+			[[nodiscard]] const std::vector<vk::Framebuffer>& GetFrameBuffers() const;
+			[[nodiscard]] bool                                HasReadback() const;
+
+		private:
+			std::vector<Image> _images{};
+			Image              _depthImage{};
+
+			std::vector<vk::Framebuffer> _frameBuffers{};
+			std::vector<Buffer>          _readbackBuffers{};
+
+			vk::Extent2D _extend = {};
+	};
+}
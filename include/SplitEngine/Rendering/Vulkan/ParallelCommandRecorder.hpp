@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CommandBuffer.hpp"
+#include "DeviceObject.hpp"
+#include "InFlightResource.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	class Device;
+
+	/**
+	 * Records the contents of the main render pass into secondary command buffers so draw calls can be recorded on multiple threads.
+	 * Every worker (and the thread calling Record) owns a command pool per frame in flight, the pools are reset once the frame comes around again.
+	 *
+	 * Commands recorded into the inline command buffer and parallel jobs are executed in the order they were issued,
+	 * jobs of a single Record call are executed in job index order no matter which worker recorded them.
+	 */
+	class ParallelCommandRecorder final : public DeviceObject
+	{
+		public:
+			/**
+			 * Gets called with the job index and a secondary command buffer that is already inside the main render pass and has the viewport and scissor set
+			 */
+			using RecordFunction = std::function<void(uint32_t jobIndex, const vk::CommandBuffer& commandBuffer)>;
+
+			/**
+			 * @param numWorkers Number of worker threads, the thread calling Record always helps out so 0 records everything on the calling thread
+			 */
+			ParallelCommandRecorder(Device* device, uint32_t numWorkers);
+
+			ParallelCommandRecorder(const ParallelCommandRecorder&)            = delete;
+			ParallelCommandRecorder& operator=(const ParallelCommandRecorder&) = delete;
+
+			/**
+			 * Needs to be called after the in flight fence of the current frame has been waited on and the render pass has been begun with secondary command buffer contents.
+			 * Pipeline statistics that are being queried in the primary command buffer need to be passed on, so the secondary command buffers are allowed to run during the query.
+			 */
+			void BeginFrame(const vk::RenderPass&                  renderPass,
+			                const vk::Framebuffer&                 framebuffer,
+			                const vk::Viewport&                    viewport,
+			                const vk::Rect2D&                      scissor,
+			                const vk::QueryPipelineStatisticFlags& inheritedPipelineStatistics = {});
+
+			/**
+			 * Executes everything recorded during the frame in the given primary command buffer, the render pass still needs to be ended afterward
+			 */
+			void EndFrame(const vk::CommandBuffer& primaryCommandBuffer);
+
+			/**
+			 * Runs numJobs jobs across the workers and blocks until all of them are recorded.
+			 * Can only be called from the thread that owns the frame and not from inside a job.
+			 */
+			void Record(uint32_t numJobs, const RecordFunction& recordFunction);
+
+			/**
+			 * Command buffer for recording on the calling thread, its handle changes after every Record call so it shouldn't be cached
+			 */
+			[[nodiscard]] CommandBuffer& GetInlineCommandBuffer();
+
+			[[nodiscard]] uint32_t GetNumWorkers() const;
+
+			void Destroy() override;
+
+		private:
+			struct WorkerFrame
+			{
+				vk::CommandPool            CommandPool = VK_NULL_HANDLE;
+				std::vector<CommandBuffer> CommandBuffers{};
+				uint32_t                   NumUsed = 0;
+			};
+
+			// The last entry belongs to the thread calling Record
+			std::vector<InFlightResource<WorkerFrame>> _workerFrames{};
+			std::vector<std::jthread>                  _workers{};
+
+			CommandBuffer                    _inlineCommandBuffer{};
+			std::vector<vk::CommandBuffer>   _executionOrder{};
+			vk::CommandBufferInheritanceInfo _inheritanceInfo{};
+			vk::Viewport                     _viewport{};
+			vk::Rect2D                       _scissor{};
+
+			std::mutex                  _mutex{};
+			std::condition_variable_any _workAvailable{};
+			std::condition_variable     _workDone{};
+			uint64_t                    _generation     = 0;
+			uint32_t                    _numBusyWorkers = 0;
+
+			const RecordFunction*          _recordFunction = nullptr;
+			uint32_t                       _numJobs        = 0;
+			std::atomic<uint32_t>          _nextJob        = 0;
+			std::vector<vk::CommandBuffer> _jobCommandBuffers{};
+			std::exception_ptr             _exception = nullptr;
+
+			void WorkerLoop(const std::stop_token& stopToken, uint32_t workerIndex);
+
+			void RecordJobs(uint32_t workerIndex);
+
+			vk::CommandBuffer BeginSecondary(uint32_t workerIndex);
+
+			void BeginInlineSegment();
+			void EndInlineSegment();
+	};
+}
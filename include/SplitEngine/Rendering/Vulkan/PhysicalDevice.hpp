@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string_view>
 #include <vulkan/vulkan.hpp>
 
 #include "QueueFamily.hpp"
@@ -32,7 +33,13 @@ namespace SplitEngine::Rendering::Vulkan
 		public:
 			bool     IsQueueFamilyIndicesCompleted();
 			void     SearchQueues(const Instance& instance, const vk::PhysicalDevice& physicalDevice);
-			explicit PhysicalDevice(Instance& instance, std::vector<const char*> _requiredExtensions, std::vector<const char*> _requiredValidationLayers);
+			/**
+			 * Optional extensions are enabled if the selected device supports them, check IsExtensionEnabled before relying on one
+			 */
+			explicit PhysicalDevice(Instance&                       instance,
+			                        std::vector<const char*>        _requiredExtensions,
+			                        std::vector<const char*>        _requiredValidationLayers,
+			                        const std::vector<const char*>& optionalExtensions = {});
 
 			[[nodiscard]] Instance&                           GetInstance() const;
 			[[nodiscard]] Device&                             GetDevice() const;
@@ -44,6 +51,7 @@ namespace SplitEngine::Rendering::Vulkan
 			[[nodiscard]] const vk::SurfaceFormatKHR&         GetImageFormat() const;
 			[[nodiscard]] vk::Format                          GetDepthImageFormat() const;
 			[[nodiscard]] const vk::PhysicalDeviceProperties& GetProperties() const;
+			[[nodiscard]] bool                                IsExtensionEnabled(std::string_view extension) const;
 
 			void Destroy();
 
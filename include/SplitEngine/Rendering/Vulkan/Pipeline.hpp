@@ -1,11 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <filesystem>
+#include <mutex>
 #include <SplitEngine/RenderingSettings.hpp>
 
 #include "DescriptorSetAllocator.hpp"
 #include "DeviceObject.hpp"
-#include "spirv_common.hpp"
 
 #include <vulkan/vulkan.hpp>
 
@@ -36,6 +37,10 @@ namespace SplitEngine::Rendering::Vulkan
 
 			Pipeline() = default;
 
+			/**
+			 * Pipelines can be created from multiple threads at once, only the descriptor set setup is serialized.
+			 * The global set is created by whichever pipeline gets there first, so the first pipeline should be created before going parallel.
+			 */
 			Pipeline(Device* device, const std::string& name, const std::vector<ShaderInfo>& shaderInfos, PipelineCreateInfo createInfo);
 
 			void Bind(const vk::CommandBuffer& commandBuffer) const;
@@ -47,6 +52,9 @@ namespace SplitEngine::Rendering::Vulkan
 			                        uint32_t                 dynamicOffsetCount = 0,
 			                        uint32_t*                dynamicOffsets     = nullptr) const;
 
+			/**
+			 * Without explicit dynamic offsets the ones stored in the allocation are used, see Shader::Properties::SetDynamicOffset
+			 */
 			void BindDescriptorSets(const vk::CommandBuffer&            commandBuffer,
 			                        DescriptorSetAllocator::Allocation* descriptorSetAllocation,
 			                        uint32_t                            firstSet,
@@ -59,12 +67,15 @@ namespace SplitEngine::Rendering::Vulkan
 			[[nodiscard]] const PushConstantInfo&   GetPushConstantInfo(ShaderType shaderType, const uint32_t index) const;
 			[[nodiscard]] const vk::Pipeline&       GetVkPipeline() const;
 			[[nodiscard]] const vk::PipelineLayout& GetLayout() const;
+			[[nodiscard]] vk::PipelineBindPoint     GetBindPoint() const;
 
 			[[nodiscard]] static DescriptorSetAllocator::Allocation& GetGlobalDescriptorSetAllocation();
 			[[nodiscard]] DescriptorSetAllocator::Allocation&        GetPerPipelineDescriptorSetAllocation();
 
 			[[nodiscard]] DescriptorSetAllocator::Allocation AllocatePerInstanceDescriptorSet();
 
+			[[nodiscard]] std::vector<DescriptorSetAllocator::Allocation> AllocatePerInstanceDescriptorSets(uint32_t count);
+
 			static vk::ShaderStageFlagBits GetShaderStageFromShaderType(ShaderType shaderType);
 
 			void DeallocatePerInstanceDescriptorSet(DescriptorSetAllocator::Allocation& descriptorSetAllocation);
@@ -76,7 +87,8 @@ namespace SplitEngine::Rendering::Vulkan
 
 			static DescriptorSetAllocator             _globalDescriptorManager;
 			static DescriptorSetAllocator::Allocation _globalDescriptorSetAllocation;
-			static bool                               _globalDescriptorsProcessed;
+			static std::atomic<bool>                  _globalDescriptorsProcessed;
+			static std::mutex                         _descriptorSetupMutex;
 
 			DescriptorSetAllocator _perInstanceDescriptorSetManager;
 			DescriptorSetAllocator _perPipelineDescriptorSetManager;
@@ -94,8 +106,5 @@ namespace SplitEngine::Rendering::Vulkan
 				vk::ShaderStageFlagBits::eFragment,
 				vk::ShaderStageFlagBits::eCompute
 			};
-
-
-			[[nodiscard]] static vk::Format GetFormatFromType(const spirv_cross::SPIRType& type);
 	};
 }
@@ -26,13 +26,24 @@ namespace SplitEngine::Rendering::Vulkan
 
 			[[nodiscard]] const vk::Queue&       GetVkQueue(uint32_t index = 0) const;
 			[[nodiscard]] const vk::CommandPool& GetCommandPool() const;
+			[[nodiscard]] uint32_t               GetIndex() const;
 
 			[[nodiscard]] vk::CommandBuffer& BeginOneshotCommands();
 
 			void EndOneshotCommands(uint32_t index = 0);
 
-			CommandBuffer AllocateCommandBuffer(QueueType type, vk::CommandBufferLevel commandBufferLevel = vk::CommandBufferLevel::ePrimary, bool singleInstance = false);
-
+			/**
+			 * Allocates from the command pool of the queue family unless another pool of this family is passed, the command buffer then needs to be freed with that pool
+			 */
+			CommandBuffer AllocateCommandBuffer(QueueType              type,
+			                                    vk::CommandBufferLevel commandBufferLevel = vk::CommandBufferLevel::ePrimary,
+			                                    bool                   singleInstance     = false,
+			                                    vk::CommandPool        commandPool        = VK_NULL_HANDLE);
+
+			/**
+			 * Creates an additional command pool for this family, used for pools that are only accessed by a single thread. The caller owns the pool.
+			 */
+			[[nodiscard]] vk::CommandPool CreateCommandPool(vk::CommandPoolCreateFlags flags = {}) const;
 
 		private:
 			std::vector<vk::Queue> _vkQueues;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	/**
+	 * Everything a pipeline needs to know about a single SPIR-V module.
+	 * Reflecting with spirv_cross is the slowest part of creating a pipeline, so the result is stored in a small binary sidecar file next to the module.
+	 * The sidecar contains a hash of the SPIR-V code and gets ignored (and rewritten) as soon as the module changes.
+	 */
+	struct ShaderReflection
+	{
+		struct Resource
+		{
+			vk::DescriptorType Type            = vk::DescriptorType::eUniformBuffer;
+			uint32_t           Set             = 0;
+			uint32_t           Binding         = 0;
+			uint32_t           DescriptorCount = 1;
+			uint64_t           SizeInBytes     = 0;
+			std::string        Name{};
+		};
+
+		struct PushConstantMember
+		{
+			uint32_t Offset      = 0;
+			uint32_t SizeInBytes = 0;
+		};
+
+		struct PushConstantBlock
+		{
+			uint32_t                        FirstOffset = 0;
+			uint32_t                        SizeInBytes = 0;
+			std::vector<PushConstantMember> Members{};
+		};
+
+		struct StageInput
+		{
+			uint32_t   Location    = 0;
+			uint32_t   Binding     = 0;
+			vk::Format Format      = vk::Format::eUndefined;
+			uint32_t   SizeInBytes = 0;
+		};
+
+		/**
+		 * Uniform buffers, storage buffers and sampled images in that order, SizeInBytes is the declared struct size and 0 for images
+		 */
+		std::vector<Resource>          Resources{};
+		std::vector<PushConstantBlock> PushConstantBlocks{};
+		std::vector<StageInput>        StageInputs{};
+
+		[[nodiscard]] static ShaderReflection Reflect(const std::vector<uint32_t>& spirv);
+
+		/**
+		 * Uses the sidecar (spirvPath + sidecarExtension) if its hash matches the code, otherwise reflects the code and writes a new sidecar.
+		 * An empty extension disables the sidecar completely.
+		 */
+		[[nodiscard]] static ShaderReflection LoadOrReflect(const std::filesystem::path& spirvPath, const std::vector<uint32_t>& spirv, const std::string& sidecarExtension);
+
+		/**
+		 * FNV-1a over the raw SPIR-V words
+		 */
+		[[nodiscard]] static uint64_t HashSpirv(const std::vector<uint32_t>& spirv);
+	};
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Buffer.hpp"
+#include "DeviceObject.hpp"
+#include "InFlightResource.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	class Device;
+
+	/**
+	 * Linear allocator for data that only lives for a single frame (per draw uniforms, instance data, dynamic vertices...).
+	 * Each frame in flight owns one persistently mapped buffer, allocations just bump an offset inside it and the whole buffer is reset once the fence of that frame signaled.
+	 * Allocations can be bound to dynamic uniform/storage buffer descriptors by setting Allocation::Offset with Shader::Properties::SetDynamicOffset.
+	 */
+	class TransientBufferAllocator final : public DeviceObject
+	{
+		public:
+			struct Allocation
+			{
+				vk::Buffer     Buffer      = VK_NULL_HANDLE;
+				uint32_t       Offset      = 0;
+				vk::DeviceSize SizeInBytes = 0;
+				std::byte*     Data        = nullptr;
+
+				template<typename T>
+				[[nodiscard]] T* GetData() const { return reinterpret_cast<T*>(Data); }
+
+				[[nodiscard]] vk::DescriptorBufferInfo GetDescriptorBufferInfo() const { return { Buffer, 0, SizeInBytes }; }
+			};
+
+			TransientBufferAllocator() = default;
+
+			TransientBufferAllocator(Device* device, vk::DeviceSize sizeInBytesPerFrame);
+
+			/**
+			 * Alignment is derived from the usage, uniform and storage buffers respect the min offset alignment of the physical device.
+			 * The returned memory is only valid until the same frame in flight comes around again.
+			 */
+			Allocation Allocate(vk::DeviceSize sizeInBytes, vk::BufferUsageFlagBits usage = vk::BufferUsageFlagBits::eUniformBuffer);
+
+			/**
+			 * Allocates and copies the data into the new allocation
+			 */
+			template<typename T>
+			Allocation Write(const T& data, const vk::BufferUsageFlagBits usage = vk::BufferUsageFlagBits::eUniformBuffer)
+			{
+				Allocation allocation = Allocate(sizeof(T), usage);
+				memcpy(allocation.Data, &data, sizeof(T));
+				return allocation;
+			}
+
+			/**
+			 * Needs to be called after the in flight fence of the current frame has been waited on
+			 */
+			void Reset();
+
+			/**
+			 * Flushes everything allocated during the current frame, needs to be called before the frame gets submitted
+			 */
+			void Flush();
+
+			void Destroy() override;
+
+			/**
+			 * Buffer of the current frame, dynamic descriptors need to point to it.
+			 * The buffer only changes if a frame outgrows it, in that case descriptors would need to be written again while the frame is being recorded so the initial size should be chosen generously.
+			 */
+			[[nodiscard]] const Buffer& GetBuffer() const;
+
+			[[nodiscard]] vk::DeviceSize GetUsedSizeInBytes() const;
+
+		private:
+			struct FrameBuffer
+			{
+				Buffer                      Buffer{};
+				vk::DeviceSize              Offset = 0;
+				std::vector<Vulkan::Buffer> RetiredBuffers{};
+			};
+
+			static constexpr vk::BufferUsageFlags USAGE = vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer |
+			                                              vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer;
+
+			vk::DeviceSize _minUniformAlignment = 1;
+			vk::DeviceSize _minStorageAlignment = 1;
+
+			InFlightResource<FrameBuffer> _frameBuffers{};
+
+			[[nodiscard]] Buffer CreateFrameBuffer(vk::DeviceSize sizeInBytes) const;
+	};
+}
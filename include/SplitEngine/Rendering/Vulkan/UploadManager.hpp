@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Buffer.hpp"
+#include "DeviceObject.hpp"
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	class Device;
+	class Image;
+
+	/**
+	 * Batches uploads into a single command buffer on the transfer queue instead of submitting and waiting on every copy.
+	 * Data is copied into a persistently mapped staging ring, the space of a batch gets reused once the fence of the batch signaled.
+	 * Uploads that don't fit into the ring at all get their own staging buffer which lives until the batch is done.
+	 *
+	 * If the transfer queue belongs to another family than the graphics queue the ownership of the resources is released after the copy
+	 * and acquired again on the frame command buffer once the batch finished, a ticket only counts as complete after that happened.
+	 *
+	 * Uploads can be recorded from worker threads, every public function locks the manager.
+	 */
+	class UploadManager final : public DeviceObject
+	{
+		public:
+			struct Ticket
+			{
+				uint64_t BatchID = 0;
+			};
+
+			UploadManager() = default;
+
+			UploadManager(Device* device, vk::DeviceSize stagingBufferSizeInBytes);
+
+			/**
+			 * The destination buffer needs to stay alive until the ticket completed
+			 */
+			Ticket UploadBuffer(const Buffer& destinationBuffer, const std::byte* data, vk::DeviceSize sizeInBytes, vk::DeviceSize destinationOffsetInBytes = 0);
+
+			/**
+			 * The image needs to be in an undefined layout, it ends up in the final layout once the ticket completed.
+			 * The pixels contain every mip level of the image tightly packed, or only the first one if the others should be generated.
+			 * Generating uses blits which transfer only queues can't do, so with a separate transfer queue family that part runs on the graphics queue after the ownership transfer.
+			 */
+			Ticket UploadImage(Image&               destinationImage,
+			                   const std::byte*     pixels,
+			                   vk::DeviceSize       pixelsSizeInBytes,
+			                   vk::Extent3D         extent,
+			                   vk::ImageAspectFlags aspectMask,
+			                   vk::ImageLayout      finalLayout     = vk::ImageLayout::eShaderReadOnlyOptimal,
+			                   bool                 generateMipmaps = false);
+
+			/**
+			 * Submits everything recorded since the last submit, this is also done once per frame by the renderer
+			 */
+			Ticket Submit();
+
+			/**
+			 * The renderer waits for the ticket before it submits the current frame, for uploads that need to be usable without polling.
+			 * Anything drawn in the same frame can rely on the data and the final layout being there.
+			 */
+			void RequireForFrame(Ticket ticket);
+
+			[[nodiscard]] bool IsComplete(Ticket ticket) const;
+
+			/**
+			 * True if nothing is being recorded, in flight or waiting to be acquired
+			 */
+			[[nodiscard]] bool IsIdle() const;
+
+			/**
+			 * Blocks until the ticket completed
+			 */
+			void Wait(Ticket ticket);
+
+			/**
+			 * Submits the current batch, retires finished batches and records pending ownership acquires into the given graphics command buffer.
+			 * Blocks until every required batch is done, the command buffer needs to be submitted ahead of everything that reads the uploads and outside of a render pass.
+			 */
+			void Update(const vk::CommandBuffer& graphicsCommandBuffer);
+
+			void Destroy() override;
+
+			/**
+			 * Keeps other threads from recording uploads while the lock is held, the manager itself can still be used from the locking thread
+			 */
+			[[nodiscard]] std::unique_lock<std::recursive_mutex> Lock();
+
+		private:
+			struct MipmapGeneration
+			{
+				vk::Image            Image       = VK_NULL_HANDLE;
+				vk::Extent3D         Extent      = {};
+				uint32_t             MipLevels   = 1;
+				vk::ImageAspectFlags AspectMask  = vk::ImageAspectFlagBits::eColor;
+				vk::ImageLayout      FinalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+			};
+
+			struct Batch
+			{
+				uint64_t                             ID            = 0;
+				vk::CommandBuffer                    CommandBuffer = VK_NULL_HANDLE;
+				vk::Fence                            Fence         = VK_NULL_HANDLE;
+				uint64_t                             StagingEnd    = 0;
+				std::vector<Buffer>                  DedicatedStagingBuffers{};
+				std::vector<vk::ImageMemoryBarrier>  ImageAcquireBarriers{};
+				std::vector<vk::BufferMemoryBarrier> BufferAcquireBarriers{};
+				std::vector<MipmapGeneration>        MipmapGenerations{};
+			};
+
+			static constexpr vk::DeviceSize STAGING_ALIGNMENT = 16;
+
+			// Recursive since public functions like Submit are also used internally
+			mutable std::recursive_mutex _mutex{};
+
+			vk::CommandPool _commandPool              = VK_NULL_HANDLE;
+			uint32_t        _transferQueueFamilyIndex = -1u;
+			uint32_t        _graphicsQueueFamilyIndex = -1u;
+
+			Buffer         _stagingBuffer{};
+			std::byte*     _stagingData     = nullptr;
+			vk::DeviceSize _stagingCapacity = 0;
+
+			// Positions only ever grow, the actual offset inside the ring is the position modulo the capacity
+			uint64_t _stagingHead = 0;
+			uint64_t _stagingTail = 0;
+
+			Batch              _recordingBatch{};
+			bool               _isRecording = false;
+			std::deque<Batch>  _submittedBatches{};
+			std::vector<Batch> _freeBatches{};
+
+			uint64_t _nextBatchID      = 1;
+			uint64_t _retiredBatchID   = 0;
+			uint64_t _completedBatchID = 0;
+			uint64_t _requiredBatchID  = 0;
+
+			std::vector<vk::ImageMemoryBarrier>  _pendingImageAcquireBarriers{};
+			std::vector<vk::BufferMemoryBarrier> _pendingBufferAcquireBarriers{};
+			std::vector<MipmapGeneration>        _pendingMipmapGenerations{};
+
+			[[nodiscard]] bool IsSameQueueFamily() const;
+
+			Batch& GetRecordingBatch();
+
+			std::byte* AllocateStaging(vk::DeviceSize sizeInBytes, vk::Buffer& stagingBuffer, vk::DeviceSize& stagingOffsetInBytes);
+
+			bool RetireOldestBatch(bool wait);
+
+			[[nodiscard]] bool HasPendingAcquires() const;
+
+			void RecordPendingAcquires(const vk::CommandBuffer& graphicsCommandBuffer);
+
+			/**
+			 * All levels need to be in the transfer destination layout with the first one written, they all end up in the final layout
+			 */
+			static void RecordMipmapGeneration(const vk::CommandBuffer& commandBuffer, const MipmapGeneration& mipmapGeneration);
+	};
+}
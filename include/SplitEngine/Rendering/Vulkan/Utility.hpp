@@ -9,7 +9,8 @@ namespace SplitEngine::Rendering::Vulkan
 		requires std::same_as<T, vk::Pipeline> || std::same_as<T, vk::PipelineLayout> || std::same_as<T, vk::ShaderModule> || std::same_as<T, vk::RenderPass> ||
 						 std::same_as<T, vk::SwapchainKHR> || std::same_as<T, vk::ImageView> || std::same_as<T, vk::Framebuffer> ||
 						 std::same_as<T, vk::Buffer> || std::same_as<T, vk::DeviceMemory> || std::same_as<T, vk::Image> ||
-						 std::same_as<T, vk::DescriptorSetLayout> || std::same_as<T, vk::DescriptorPool> || std::same_as<T, vk::Sampler> || std::same_as<T, vk::CommandPool>;
+						 std::same_as<T, vk::DescriptorSetLayout> || std::same_as<T, vk::DescriptorPool> || std::same_as<T, vk::Sampler> || std::same_as<T, vk::CommandPool> ||
+						 std::same_as<T, vk::Fence>;
 	};
 
 	class Utility
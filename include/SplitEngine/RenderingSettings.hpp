@@ -4,6 +4,10 @@
 #include "Rendering/Vulkan/PipelineCreateInfo.hpp"
 #include "Rendering/Vulkan/ViewportStyle.hpp"
 
+#include <filesystem>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
 namespace SplitEngine
 {
 	struct RenderingSettings
@@ -13,5 +17,122 @@ namespace SplitEngine
 		Rendering::Vulkan::ViewportStyle      ViewportStyle             = Rendering::Vulkan::ViewportStyle::Flipped;
 		Color                                 ClearColor                = Color(0x264E80FF);
 		Rendering::Vulkan::PipelineCreateInfo PipelineCreateInfo{};
+
+		/**
+		 * Size of the transient buffer per frame in flight, it grows if a frame needs more but that forces a new buffer to be bound.
+		 */
+		uint64_t TransientBufferSizeInBytes = 4ull * 1024ull * 1024ull;
+
+		/**
+		 * Size of the staging ring used for uploads, uploads bigger than this get a dedicated staging buffer.
+		 */
+		uint64_t UploadStagingBufferSizeInBytes = 32ull * 1024ull * 1024ull;
+
+		/**
+		 * Size of the blocks uniform and storage buffers of materials and shaders are suballocated from, buffers with the same memory requirements share blocks.
+		 */
+		uint64_t DescriptorBufferBlockSizeInBytes = 4ull * 1024ull * 1024ull;
+
+		/**
+		 * Size of the shared vertex and index buffers models are suballocated from, models in the same blocks can be drawn without rebinding anything.
+		 * Models that don't fit anymore start a new block, a single model bigger than a block gets a block of its own.
+		 */
+		uint64_t MeshVertexBlockSizeInBytes = 64ull * 1024ull * 1024ull;
+		uint64_t MeshIndexBlockSizeInBytes  = 16ull * 1024ull * 1024ull;
+
+		/**
+		 * Fractions of a memory heap's budget at which a warning gets logged, in ascending order.
+		 * Each one is only logged once until the usage of the heap drops below it again.
+		 */
+		std::vector<float> MemoryBudgetWarningThresholds = { 0.8f, 0.95f };
+
+		/**
+		 * Memory that has to be allocated from the device but unused inside VMA's blocks before defragmentation starts, 0 disables defragmentation.
+		 * Only buffers that enabled defragmentation get moved, like the blocks of the mesh arena.
+		 */
+		uint64_t DefragmentationThresholdInBytes = 64ull * 1024ull * 1024ull;
+
+		/**
+		 * Bytes moved by a single defragmentation pass.
+		 * A pass waits for all frames in flight, so passes only run on frames without pending uploads and at most every DefragmentationPassInterval frames.
+		 */
+		uint64_t DefragmentationBytesPerPass = 16ull * 1024ull * 1024ull;
+		uint32_t DefragmentationPassInterval = 30;
+
+		/**
+		 * Compiled pipelines get stored here on shutdown and loaded again on startup, leave empty to not persist the cache.
+		 * The file is ignored if it was created by a different gpu or driver.
+		 */
+		std::filesystem::path PipelineCachePath = "pipeline.cache";
+
+		/**
+		 * Number of worker threads used by the parallel command recorder, -1 uses one less than the number of hardware threads.
+		 * The thread calling Record always records as well, so 0 records everything on the main thread.
+		 */
+		uint32_t CommandRecordingThreads = -1u;
+
+		/**
+		 * Size of the bindless texture array, gets clamped to the limits of the device
+		 */
+		uint32_t MaxBindlessTextures = 16384;
+
+		/**
+		 * Frames the cpu can record while the gpu is still busy with earlier ones, between 1 and 4.
+		 * More frames keep the gpu fed when frame times vary, fewer frames mean less input latency.
+		 */
+		uint32_t FramesInFlight = 2;
+
+		/**
+		 * Preferred present mode, FIFO is used if the surface doesn't support it.
+		 * Mailbox and immediate don't block on vsync, FIFO relaxed only tears if a frame misses it.
+		 */
+		vk::PresentModeKHR PresentMode = vk::PresentModeKHR::eMailbox;
+
+		/**
+		 * Number of swapchain images, 0 uses one more than the surface minimum. Gets clamped to what the surface supports
+		 */
+		uint32_t SwapchainImageCount = 0;
+
+		/**
+		 * Waits for the gpu at the start of the frame instead of right before rendering, so input gets polled as late as possible.
+		 * This trades cpu/gpu overlap for latency, the frame can't be prepared on the cpu while the gpu is still busy.
+		 */
+		bool FramePacing = false;
+
+		/**
+		 * Renders into a ring of offscreen images instead of a window, no window, surface or swapchain is created and nothing gets presented.
+		 * This also works on devices without present support like lavapipe in a container, which makes it usable for benchmarks and tests in automation.
+		 */
+		bool Headless = false;
+
+		/**
+		 * Size of the offscreen images in headless mode
+		 */
+		vk::Extent2D HeadlessResolution = { 1280, 720 };
+
+		/**
+		 * Number of offscreen images rendered to in turn in headless mode, can't be less than the number of frames in flight
+		 */
+		uint32_t HeadlessImageCount = 3;
+
+		/**
+		 * Copies every headless frame into host memory so it can be read back with Renderer::ReadBackFrame, costs an extra copy per frame
+		 */
+		bool HeadlessReadback = false;
+
+		/**
+		 * Measures how long the gpu takes for each frame, its main render pass and GpuProfiler zones, the results end up in the statistics
+		 */
+		bool GpuTimestamps = true;
+
+		/**
+		 * Zones per frame the GpuProfiler has room for, zones beyond that aren't measured
+		 */
+		uint32_t MaxGpuProfilerZones = 64;
+
+		/**
+		 * Counts vertices, primitives and shader invocations of each frame, needs the pipelineStatisticsQuery and inheritedQueries device features
+		 */
+		bool GpuPipelineStatistics = false;
 	};
 }
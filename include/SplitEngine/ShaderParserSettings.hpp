@@ -11,6 +11,13 @@ namespace SplitEngine
 		std::string FragmentShaderFileExtension = ".frag";
 		std::string ComputeShaderFileExtension  = ".comp";
 		std::string SpirvFileExtension          = ".spv";
+
+		/**
+		 * Reflection results get cached in a file with this extension next to each spirv file so spirv_cross only needs to run if the shader changed.
+		 * Leave empty to always reflect at startup.
+		 */
+		std::string ShaderReflectionFileExtension = ".refl";
+
 		char        ShaderBufferModDelimiter    = '_';
 
 		/**
@@ -64,5 +71,17 @@ namespace SplitEngine
 		 * Will add the transfer dst bit
 		 */
 		std::vector<std::string> ShaderBufferTransferDstModPrefixes = { "transferDst", "td" };
+
+		/**
+		 * Creates the descriptor as dynamic uniform/storage buffer, implies noAlloc.
+		 * The buffer needs to be set once per frame in flight and the offset is set with Shader::Properties::SetDynamicOffset, this is meant to be used with the Vulkan::TransientBufferAllocator
+		 */
+		std::vector<std::string> ShaderBufferDynamicModPrefixes = { "dynamic", "dyn" };
+
+		/**
+		 * Turns an unsized sampler array in the global set (set 0) into the bindless texture table.
+		 * Every Texture2D gets written into it at its bindless index, shaders index the array with an index passed through push constants or instance data.
+		 */
+		std::vector<std::string> ShaderPropertyBindlessModPrefixes = { "bindless", "bl" };
 	};
 }
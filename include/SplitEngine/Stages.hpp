@@ -28,7 +28,9 @@ namespace SplitEngine
 	{
 		enum EngineStageOrder
 		{
+			BeginFrame_FramePacingSystem   = -12'000,
 			BeginFrame_StatisticsSystem    = -11'000,
+			BeginFrame_EventBusSystem      = -10'500,
 			BeginFrame_TimeSystem          = -10'000,
 			BeginFrame_SDLEventSystem      = -10'000,
 			BeginRendering_RenderingSystem = -10'000,
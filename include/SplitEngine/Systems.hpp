@@ -1,7 +1,10 @@
 #pragma once
 #include <cstdint>
+#include <string_view>
+#include <unordered_map>
 #include <SDL_events.h>
 
+#include "Contexts.hpp"
 #include "Event.hpp"
 #include "ECS/ContextProvider.hpp"
 #include "ECS/SystemBase.hpp"
@@ -16,6 +19,14 @@ namespace SplitEngine
 		private:
 			float    _accumulatedDeltaTime = 0.0f;
 			uint64_t _accumulatedFrames    = 0;
+
+			float                                       _accumulatedGpuFrameTimeMs      = 0.0f;
+			float                                       _accumulatedGpuRenderPassTimeMs = 0.0f;
+			float                                       _accumulatedGpuWaitTimeMs       = 0.0f;
+			uint64_t                                    _accumulatedGpuFrames           = 0;
+			uint64_t                                    _lastGpuFrameNumber             = 0;
+			std::unordered_map<std::string_view, float> _accumulatedGpuZoneTimeMs{};
+			GpuPipelineStatistics                       _accumulatedGpuPipelineStatistics{};
 	};
 
 	class TimeSystem : public ECS::SystemBase
@@ -43,6 +54,20 @@ namespace SplitEngine
 			SDL_Event _event{};
 	};
 
+	class EventBusSystem : public ECS::SystemBase
+	{
+		protected:
+			void RunExecute(ECS::ContextProvider& context, uint8_t stage) override;
+	};
+
+	/**
+	 * Waits for the gpu before anything else happens in the frame, so input is polled right before the frame gets recorded
+	 */
+	class FramePacingSystem : public ECS::SystemBase
+	{
+		protected:
+			void RunExecute(ECS::ContextProvider& context, uint8_t stage) override;
+	};
 
 	class RenderingSystem : public ECS::SystemBase
 	{
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "SplitEngine/IO/Image.hpp"
+
+namespace SplitEngine::Tools
+{
+	class MipmapGenerator
+	{
+		public:
+			MipmapGenerator() = delete;
+
+			/**
+			 * Appends the full mip chain down to 1x1 to the pixels of the image using a 2x2 box filter, images that already have mip levels or are compressed are left alone.
+			 * The color channels of RGBA images are filtered in linear space since Texture2D treats them as sRGB.
+			 * Textures built this way are uploaded in one staged copy instead of generating their mip levels on the gpu.
+			 */
+			static void Generate(IO::Image& image);
+	};
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ImagePacker.hpp"
+#include "SplitEngine/IO/Image.hpp"
+
+#include <filesystem>
+
+namespace SplitEngine::Tools
+{
+	/**
+	 * Encodes images into block compressed formats so they can be stored and uploaded without ever being decoded.
+	 * BC1 is meant for images without partial transparency (alpha is cut off at 50%), BC7 uses a single subset mode and keeps alpha.
+	 * ASTC images need to be encoded with an external encoder, IO::ImageLoader still loads them.
+	 */
+	class TextureCompressor
+	{
+		public:
+			TextureCompressor() = delete;
+
+			/**
+			 * Compresses every mip level of an uncompressed 4 channel image, blocks are encoded on all hardware threads
+			 */
+			[[nodiscard]] static IO::Image Compress(const IO::Image& image, IO::Image::BlockCompression compression);
+
+			/**
+			 * Compresses all atlas pages in place, the packing infos stay valid
+			 */
+			static void Compress(ImagePacker::PackingData& packingData, IO::Image::BlockCompression compression);
+
+			/**
+			 * Writes a compressed image with all of its mip levels into a KTX2 file
+			 */
+			static void WriteKtx2(const IO::Image& image, const std::filesystem::path& filePath);
+	};
+}
@@ -12,13 +12,17 @@ namespace SplitEngine
 	class Window
 	{
 		public:
-			Window(const std::string& windowTitle = "Split Engine Game", uint32_t width = 500, uint32_t height = 500);
+			/**
+			 * A headless window doesn't open anything, it only keeps its size so code that asks for it keeps working
+			 */
+			Window(const std::string& windowTitle = "Split Engine Game", uint32_t width = 500, uint32_t height = 500, bool headless = false);
 
 			void Close();
 
 			[[nodiscard]] SDL_Window* GetSDLWindow() const;
 			[[nodiscard]] glm::ivec2  GetSize() const;
 			[[nodiscard]] bool        IsMinimized() const;
+			[[nodiscard]] bool        IsHeadless() const;
 
 			void HandleEvents(SDL_Event event);
 
@@ -31,6 +35,7 @@ namespace SplitEngine
 
 		private:
 			SDL_Window* _window         = nullptr;
+			glm::ivec2  _headlessSize   = { 0, 0 };
 
 			bool        _isMinimized    = false;
 			bool        _isInFullscreen = false;
@@ -28,13 +28,18 @@ namespace SplitEngine
 
 		LOG("Initializing ECS...");
 		LOG("Registering Engine Contexts...");
-		_ecsRegistry.RegisterContext<EngineContext>({ this, &_assetDatabase, {} });
+		_ecsRegistry.RegisterContext<EngineContext>({ this, &_assetDatabase, {}, nullptr, &_eventBus });
 		_ecsRegistry.RegisterContext<TimeContext>({});
 		_ecsRegistry.RegisterContext<RenderingContext>({ &_renderer });
 		_ecsRegistry.RegisterContext<AudioContext>({ &_audioManager });
 
 		LOG("Adding Engine Systems...");
+		if (_renderer.GetVulkanInstance().GetRenderingSettings().FramePacing)
+		{
+			_ecsRegistry.AddSystem<FramePacingSystem>(EngineStage::BeginFrame, EngineStageOrder::BeginFrame_FramePacingSystem);
+		}
 		_ecsRegistry.AddSystem<StatisticsSystem>(EngineStage::BeginFrame, EngineStageOrder::BeginFrame_StatisticsSystem);
+		_ecsRegistry.AddSystem<EventBusSystem>(EngineStage::BeginFrame, EngineStageOrder::BeginFrame_EventBusSystem);
 		_ecsRegistry.AddSystem<TimeSystem>(EngineStage::BeginFrame, EngineStageOrder::BeginFrame_TimeSystem);
 		ECS::Registry::SystemHandle<SDLEventSystem> eventSystem = _ecsRegistry.AddSystem<SDLEventSystem>(EngineStage::BeginFrame, EngineStageOrder::BeginFrame_SDLEventSystem);
 		_ecsRegistry.AddSystem<RenderingSystem>({
@@ -64,5 +69,7 @@ namespace SplitEngine
 
 	AssetDatabase& Application::GetAssetDatabase() { return _assetDatabase; }
 
+	EventBus& Application::GetEventBus() { return _eventBus; }
+
 	ECS::Registry& Application::GetECSRegistry() { return _ecsRegistry; }
 }
@@ -6,16 +6,21 @@ namespace SplitEngine::ECS
 	                     std::vector<Component>&   sparseComponentLookup,
 	                     std::vector<Archetype*>&  archetypeLookup,
 	                     AvailableStack<uint64_t>& entityGraveyard,
+	                     std::vector<Archetype*>&  dirtyArchetypes,
 	                     std::vector<uint64_t>&&   componentIDs) :
 		ComponentIDs(std::move(componentIDs)),
 		_sparseEntityLookup(sparseEntityLookup),
 		_sparseComponentLookup(sparseComponentLookup),
 		_archetypeLookup(archetypeLookup),
-		_entityGraveyard(entityGraveyard)
+		_entityGraveyard(entityGraveyard),
+		_dirtyArchetypes(dirtyArchetypes)
 	{
 		// Sort components IDs from lowest to highest
 		std::ranges::sort(ComponentIDs);
 
+		// The signature grows as bits get set, so it doesn't need to be resized when new components get registered
+		for (const auto& id: ComponentIDs) { Signature.SetBit(id); }
+
 		Resize();
 
 		ID = _archetypeLookup.size();
@@ -23,7 +28,11 @@ namespace SplitEngine::ECS
 		_archetypeLookup.push_back(this);
 	}
 
-	void Archetype::DestroyEntity(uint64_t entityID) { _entitiesToDestroy.push_back(entityID); }
+	void Archetype::DestroyEntity(uint64_t entityID)
+	{
+		_entitiesToDestroy.push_back(entityID);
+		MarkDirty();
+	}
 
 	void Archetype::DestroyEntityImmediately(uint64_t entityID, bool callComponentDestructor)
 	{
@@ -135,6 +144,7 @@ namespace SplitEngine::ECS
 			if (entity.moveComponentIndex == -1ull)
 			{
 				archetype->_entitiesToAdd.push_back(entityID);
+				archetype->MarkDirty();
 				entity.moveComponentIndex = (archetype->Entities.size() + archetype->_entitiesToAdd.size()) - 1;
 			}
 
@@ -160,14 +170,11 @@ namespace SplitEngine::ECS
 	void Archetype::Resize()
 	{
 		const uint64_t numUniqueComponents = TypeIDGenerator<Component>::GetCount();
-		Signature.ExtendSizeTo(numUniqueComponents);
 		ComponentData.resize(numUniqueComponents);
 		_componentDataToAdd.resize(numUniqueComponents);
 
 		_sparseAddComponentArchetypes    = std::vector<uint64_t>(numUniqueComponents, -1);
 		_sparseRemoveComponentArchetypes = std::vector<uint64_t>(numUniqueComponents, -1);
-
-		for (const auto& id: ComponentIDs) { Signature.SetBit(id); }
 	}
 
 	void Archetype::ResizeAddComponentsForNewEntity()
@@ -7,7 +7,7 @@ namespace SplitEngine::ECS
 	Registry::Registry()
 	{
 		_contextProvider.Registry = this;
-		_archetypeRoot            = new Archetype(_sparseEntityLookup, _sparseComponentLookup, _archetypeLookup, _entityGraveyard, {});
+		_archetypeRoot            = new Archetype(_sparseEntityLookup, _sparseComponentLookup, _archetypeLookup, _entityGraveyard, _dirtyArchetypes, {});
 	}
 
 	Registry::~Registry()
@@ -25,18 +25,185 @@ namespace SplitEngine::ECS
 
 	void Registry::ExeutePendingOperations()
 	{
-		for (const auto& archetype: _archetypeLookup) { archetype->MoveQueuedEntities(); }
+		NotifyRemoveObservers();
 
-		for (const auto& archetype: _archetypeLookup) { archetype->AddQueuedEntities(); }
+		// Moving entities can dirty more archetypes, so this can't be a range based loop
+		for (size_t i = 0; i < _dirtyArchetypes.size(); ++i) { _dirtyArchetypes[i]->MoveQueuedEntities(); }
 
-		for (const auto& archetype: _archetypeLookup) { archetype->DestroyQueuedEntities(); }
+		for (Archetype* archetype: _dirtyArchetypes)
+		{
+			if (!_addObservers.empty())
+			{
+				for (const uint64_t entityID: archetype->_entitiesToAdd)
+				{
+					// Entities that were alive before still reference the archetype they got moved from
+					const Entity& entity = _sparseEntityLookup[entityID];
+					_addedEntities.push_back({ entityID, archetype->ID, entity.componentIndex != -1ull ? entity.archetypeIndex : -1ull });
+				}
+			}
+
+			archetype->AddQueuedEntities();
+		}
+
+		for (Archetype* archetype: _dirtyArchetypes)
+		{
+			if (!_destroyObservers.empty()) { _destroyedEntities.insert(_destroyedEntities.end(), archetype->_entitiesToDestroy.begin(), archetype->_entitiesToDestroy.end()); }
+
+			archetype->DestroyQueuedEntities();
+			archetype->_isDirty = false;
+		}
+
+		_dirtyArchetypes.clear();
 
 		RemoveQueuedSystems();
 
 		AddQueuedSystems();
 
-		// Reset cached state on system
-		for (SystemEntry& system: _systems) { if (IsSystemValid(system.ID)) { system.System->_cachedArchetypes = false; } }
+		// Reset cached state on system if new archetypes got created since they last cached
+		if (_numCachedArchetypes != _archetypeLookup.size())
+		{
+			for (SystemEntry& system: _systems) { if (IsSystemValid(system.ID)) { system.System->_cachedArchetypes = false; } }
+			_numCachedArchetypes = _archetypeLookup.size();
+		}
+
+		// Observers run last so everything they queue up gets executed next frame
+		NotifyAddObservers();
+
+		NotifyDestroyObservers();
+	}
+
+	void Registry::OnDestroy(EntityObserver&& observer) { _destroyObservers.push_back(std::move(observer)); }
+
+	bool Registry::HasComponentObservers(const std::vector<std::vector<RawComponentObserver>>& observers, const uint64_t componentID)
+	{
+		return componentID < observers.size() && !observers[componentID].empty();
+	}
+
+	void Registry::NotifyRemoveObservers()
+	{
+		if (_removeObservers.empty()) { return; }
+
+		// Entities that get moved and destroyed in the same frame are also in a move queue, they are only reported as destroyed.
+		// Entities still in an add queue never got reported as added, so they are skipped here as well
+		for (const Archetype* archetype: _dirtyArchetypes)
+		{
+			for (const uint64_t entityID: archetype->_entitiesToDestroy)
+			{
+				if (_sparseEntityLookup[entityID].componentIndex != -1ull) { _entitiesPendingDestroy.SetBit(entityID); }
+			}
+		}
+
+		// Everything gets gathered before the first observer runs, so all entities of a component end up in a single batch
+		for (uint64_t componentID = 0; componentID < _removeObservers.size(); ++componentID)
+		{
+			if (!HasComponentObservers(_removeObservers, componentID)) { continue; }
+
+			const size_t componentSize = _sparseComponentLookup[componentID].Size;
+
+			for (Archetype* archetype: _dirtyArchetypes)
+			{
+				for (const uint64_t entityID: archetype->_entitiesToDestroy)
+				{
+					const Entity& entity = _sparseEntityLookup[entityID];
+					if (entity.componentIndex == -1ull) { continue; }
+
+					// The data still lives in the current archetype, not in the one the entity was about to move to
+					Archetype* currentArchetype = _archetypeLookup[entity.archetypeIndex];
+					if (!currentArchetype->HasComponent(componentID)) { continue; }
+
+					_observedEntities.push_back(entityID);
+					_observedComponents.push_back(currentArchetype->ComponentData[componentID].data() + entity.componentIndex * componentSize);
+				}
+
+				if (!archetype->HasComponent(componentID)) { continue; }
+
+				std::byte* components = archetype->ComponentData[componentID].data();
+
+				for (const uint64_t entityID: archetype->_entitiesToMove)
+				{
+					const Entity& entity = _sparseEntityLookup[entityID];
+					if (entity.componentIndex == -1ull || _entitiesPendingDestroy.IsBitSet(entityID)) { continue; }
+					if (_archetypeLookup[entity.moveArchetypeIndex]->HasComponent(componentID)) { continue; }
+
+					_observedEntities.push_back(entityID);
+					_observedComponents.push_back(components + entity.componentIndex * componentSize);
+				}
+			}
+
+			_observerBatches.push_back({ componentID, _observedEntities.size() });
+		}
+
+		for (const Archetype* archetype: _dirtyArchetypes)
+		{
+			for (const uint64_t entityID: archetype->_entitiesToDestroy) { _entitiesPendingDestroy.UnsetBit(entityID); }
+		}
+
+		// Observers can queue up new operations, these get executed this frame but are not reported to remove observers
+		DispatchComponentObservers(_removeObservers);
+	}
+
+	void Registry::NotifyAddObservers()
+	{
+		if (_addedEntities.empty()) { return; }
+
+		// Everything gets gathered before the first observer runs, so all entities of a component end up in a single batch
+		for (uint64_t componentID = 0; componentID < _addObservers.size(); ++componentID)
+		{
+			if (!HasComponentObservers(_addObservers, componentID)) { continue; }
+
+			const size_t componentSize = _sparseComponentLookup[componentID].Size;
+
+			for (const AddedEntity& addedEntity: _addedEntities)
+			{
+				const Entity& entity = _sparseEntityLookup[addedEntity.EntityID];
+
+				// Skip entities that got destroyed in the same frame or already had the component
+				if (entity.archetypeIndex != addedEntity.ArchetypeID) { continue; }
+
+				Archetype* archetype = _archetypeLookup[addedEntity.ArchetypeID];
+				if (!archetype->HasComponent(componentID)) { continue; }
+				if (addedEntity.PreviousArchetypeID != -1ull && _archetypeLookup[addedEntity.PreviousArchetypeID]->HasComponent(componentID)) { continue; }
+
+				_observedEntities.push_back(addedEntity.EntityID);
+				_observedComponents.push_back(archetype->ComponentData[componentID].data() + entity.componentIndex * componentSize);
+			}
+
+			_observerBatches.push_back({ componentID, _observedEntities.size() });
+		}
+
+		_addedEntities.clear();
+
+		DispatchComponentObservers(_addObservers);
+	}
+
+	void Registry::NotifyDestroyObservers()
+	{
+		if (_destroyedEntities.empty()) { return; }
+
+		for (EntityObserver& observer: _destroyObservers) { observer(_destroyedEntities, _contextProvider); }
+
+		_destroyedEntities.clear();
+	}
+
+	void Registry::DispatchComponentObservers(std::vector<std::vector<RawComponentObserver>>& observers)
+	{
+		size_t batchStart = 0;
+		for (const ObserverBatch& batch: _observerBatches)
+		{
+			if (batch.End != batchStart)
+			{
+				const std::span<uint64_t>   entities   = std::span(_observedEntities).subspan(batchStart, batch.End - batchStart);
+				const std::span<std::byte*> components = std::span(_observedComponents).subspan(batchStart, batch.End - batchStart);
+
+				for (RawComponentObserver& observer: observers[batch.ComponentID]) { observer(entities, components, _contextProvider); }
+			}
+
+			batchStart = batch.End;
+		}
+
+		_observerBatches.clear();
+		_observedEntities.clear();
+		_observedComponents.clear();
 	}
 
 	void Registry::RemoveQueuedSystems()
@@ -44,7 +211,8 @@ namespace SplitEngine::ECS
 		for (const auto& systemsToRemoveID: _systemsToRemove)
 		{
 			SystemEntry& systemEntry = _systems[systemsToRemoveID];
-			systemEntry.ID           = -1;
+			systemEntry.ID             = -1;
+			systemEntry.ExecutionState = {};
 			systemEntry.System->Destroy(_contextProvider);
 			delete systemEntry.System;
 
@@ -80,6 +248,8 @@ namespace SplitEngine::ECS
 
 	std::vector<float>& Registry::GetAccumulatedStageTimeMs() { return _accumulatedStageTimeMs; }
 
+	std::vector<uint64_t>& Registry::GetAccumulatedBudgetOverruns() { return _accumulatedBudgetOverruns; }
+
 	std::vector<uint8_t>& Registry::GetActiveStages() { return _activeStages; }
 
 	uint8_t Registry::GetPrimaryGroup() const { return _primaryGroup; }
@@ -231,7 +401,13 @@ namespace SplitEngine::ECS
 
 			if (_collectStatistics) { stageStartTime = SDL_GetPerformanceCounter(); }
 
-			for (SystemExecutionEntry& systemExecutionEntry: systemExecutionEntries) { _systems[systemExecutionEntry.SystemID].System->RunExecute(_contextProvider, stage); }
+			for (SystemExecutionEntry& systemExecutionEntry: systemExecutionEntries)
+			{
+				SystemEntry& systemEntry = _systems[systemExecutionEntry.SystemID];
+
+				if (systemEntry.ExecutionState.Budget.IsEnabled()) { RunSystemBudgeted(systemEntry, stage); }
+				else { systemEntry.System->RunExecute(_contextProvider, stage); }
+			}
 
 			if (_collectStatistics)
 			{
@@ -242,5 +418,45 @@ namespace SplitEngine::ECS
 	}
 
 
+	void Registry::RunSystemBudgeted(SystemEntry& systemEntry, const uint8_t stage)
+	{
+		SystemBase::ExecutionState& executionState = systemEntry.ExecutionState;
+
+		const uint64_t startTime = SDL_GetPerformanceCounter();
+		const uint64_t frequency = SDL_GetPerformanceFrequency();
+
+		executionState.EntitiesProcessed    = 0;
+		executionState.FirstSliceEndCounter = 0;
+		executionState.DeadlineCounter      = executionState.Budget.TimeBudgetMs > 0.0f
+			                                      ? startTime + static_cast<uint64_t>(executionState.Budget.TimeBudgetMs * 0.001f * static_cast<float>(frequency))
+			                                      : -1ull;
+
+		systemEntry.System->_executionState = &executionState;
+		systemEntry.System->RunExecute(_contextProvider, stage);
+		systemEntry.System->_executionState = nullptr;
+
+		// The deadline is only checked between slices, so every frame that used up its budget ends a bit past it.
+		// It only counts as an overrun if a single slice doesn't fit into the budget, which means the slice size is too big for it.
+		if (executionState.Budget.TimeBudgetMs > 0.0f && executionState.FirstSliceEndCounter > executionState.DeadlineCounter)
+		{
+			_accumulatedBudgetOverruns[systemEntry.ID]++;
+		}
+	}
+
+	void Registry::SetSystemExecutionBudget(const uint64_t systemID, const SystemBase::ExecutionBudget& budget)
+	{
+		if (!IsSystemValid(systemID))
+		{
+			LOG_WARNING("Can't set execution budget, system with ID {0} is not valid", systemID);
+			return;
+		}
+
+		SystemBase::ExecutionState& executionState = _systems[systemID].ExecutionState;
+		executionState.Budget                      = budget;
+		executionState.Cursor                      = {};
+
+		if (_accumulatedBudgetOverruns.size() <= systemID) { _accumulatedBudgetOverruns.resize(systemID + 1, 0); }
+	}
+
 	void Registry::RemoveSystem(uint64_t systemID) { _systemsToRemove.push_back(systemID); }
 }
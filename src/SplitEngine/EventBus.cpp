@@ -0,0 +1,13 @@
+#include "SplitEngine/EventBus.hpp"
+
+namespace SplitEngine
+{
+	void EventBus::Unsubscribe(const SubscriptionHandle& handle)
+	{
+		if (handle.ChannelID >= _channels.size() || _channels[handle.ChannelID] == nullptr) { return; }
+
+		_channels[handle.ChannelID]->Unsubscribe(handle.SubscriptionID);
+	}
+
+	void EventBus::Flush() { for (const std::unique_ptr<EventChannelBase>& channel: _channels) { if (channel != nullptr) { channel->Flush(); } } }
+}
@@ -5,10 +5,122 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
 namespace SplitEngine::IO
 {
+	namespace
+	{
+		// The container formats store VkFormat and DXGI_FORMAT values, only the ones of the supported block compressions are needed
+		void ReadVkFormat(const uint32_t vkFormat, Image& image)
+		{
+			switch (vkFormat)
+			{
+				case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+				case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+				case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+				case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+					image.Compression = Image::BlockCompression::BC1;
+					image.Srgb        = vkFormat == 132 || vkFormat == 134;
+					break;
+				case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+				case 146: // VK_FORMAT_BC7_SRGB_BLOCK
+					image.Compression = Image::BlockCompression::BC7;
+					image.Srgb        = vkFormat == 146;
+					break;
+				case 157: // VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+				case 158: // VK_FORMAT_ASTC_4x4_SRGB_BLOCK
+					image.Compression = Image::BlockCompression::ASTC4x4;
+					image.Srgb        = vkFormat == 158;
+					break;
+				default:
+					image.Compression = Image::BlockCompression::None;
+			}
+		}
+
+		// Typeless formats don't say how they are meant to be read, so they are treated as linear like the legacy DXT1 header
+		void ReadDxgiFormat(const uint32_t dxgiFormat, Image& image)
+		{
+			switch (dxgiFormat)
+			{
+				case 70: // DXGI_FORMAT_BC1_TYPELESS
+				case 71: // DXGI_FORMAT_BC1_UNORM
+				case 72: // DXGI_FORMAT_BC1_UNORM_SRGB
+					image.Compression = Image::BlockCompression::BC1;
+					image.Srgb        = dxgiFormat == 72;
+					break;
+				case 97: // DXGI_FORMAT_BC7_TYPELESS
+				case 98: // DXGI_FORMAT_BC7_UNORM
+				case 99: // DXGI_FORMAT_BC7_UNORM_SRGB
+					image.Compression = Image::BlockCompression::BC7;
+					image.Srgb        = dxgiFormat == 99;
+					break;
+				default:
+					image.Compression = Image::BlockCompression::None;
+			}
+		}
+
+		template<typename T>
+		T Read(const std::vector<std::byte>& data, const size_t offset)
+		{
+			T value{};
+			if (offset + sizeof(T) <= data.size()) { memcpy(&value, data.data() + offset, sizeof(T)); }
+			return value;
+		}
+
+		std::vector<std::byte> ReadFile(const std::filesystem::path& filePath, const size_t maxSizeInBytes = SIZE_MAX)
+		{
+			std::ifstream file = std::ifstream(filePath, std::ios::binary | std::ios::ate);
+			if (!file.is_open()) { ErrorHandler::ThrowRuntimeError(std::format("failed to open image {0}!", filePath.string())); }
+
+			std::vector<std::byte> data(std::min(static_cast<size_t>(file.tellg()), maxSizeInBytes));
+
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+			return data;
+		}
+
+		bool HasExtension(const std::filesystem::path& filePath, const std::string_view extension)
+		{
+			std::string fileExtension = filePath.extension().string();
+			std::ranges::transform(fileExtension, fileExtension.begin(), [](const char c) { return static_cast<char>(std::tolower(c)); });
+
+			return fileExtension == extension;
+		}
+
+		constexpr size_t KTX2_HEADER_SIZE = 80;
+		constexpr size_t DDS_HEADER_SIZE  = 128;
+		constexpr size_t DX10_HEADER_SIZE = 20;
+
+		// Far above what any device can sample, but small enough that level sizes can't overflow
+		constexpr uint32_t MAX_IMAGE_DIMENSION = 1u << 16;
+
+		// Headers come straight from the file, so anything the level sizes are computed from needs to be checked first
+		void ValidateHeader(const std::filesystem::path& filePath, const Image& image)
+		{
+			if (image.Width == 0 || image.Height == 0 || image.Width > MAX_IMAGE_DIMENSION || image.Height > MAX_IMAGE_DIMENSION)
+			{
+				ErrorHandler::ThrowRuntimeError(std::format("failed to load image {0}! size {1}x{2} is invalid", filePath.string(), image.Width, image.Height));
+			}
+
+			if (image.MipLevels > static_cast<uint32_t>(std::bit_width(std::max(image.Width, image.Height))))
+			{
+				ErrorHandler::ThrowRuntimeError(std::format("failed to load image {0}! {1} mip levels don't fit a {2}x{3} image", filePath.string(), image.MipLevels, image.Width, image.Height));
+			}
+		}
+	}
+
 	Image ImageLoader::Load(const std::filesystem::path& filePath, const ChannelSetup channelSetup)
 	{
+		if (HasExtension(filePath, ".ktx2")) { return LoadKtx2(filePath, false); }
+		if (HasExtension(filePath, ".dds")) { return LoadDds(filePath, false); }
+
 		int width, height;
 
 		const stbi_uc* pixels = stbi_load(filePath.string().c_str(), &width, &height, nullptr, static_cast<int>(channelSetup));
@@ -30,4 +142,108 @@ namespace SplitEngine::IO
 
 		return image;
 	}
+
+	Image::BlockCompression ImageLoader::ReadBlockCompression(const std::filesystem::path& filePath)
+	{
+		if (HasExtension(filePath, ".ktx2")) { return LoadKtx2(filePath, true).Compression; }
+		if (HasExtension(filePath, ".dds")) { return LoadDds(filePath, true).Compression; }
+
+		return Image::BlockCompression::None;
+	}
+
+	Image ImageLoader::LoadKtx2(const std::filesystem::path& filePath, const bool headerOnly)
+	{
+		static constexpr std::array<uint8_t, 12> IDENTIFIER = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+		const std::vector<std::byte> data = ReadFile(filePath, headerOnly ? KTX2_HEADER_SIZE : SIZE_MAX);
+
+		if (data.size() < KTX2_HEADER_SIZE || memcmp(data.data(), IDENTIFIER.data(), IDENTIFIER.size()) != 0)
+		{
+			ErrorHandler::ThrowRuntimeError(std::format("failed to load image {0}! not a ktx2 file", filePath.string()));
+		}
+
+		Image image{};
+		image.Width       = Read<uint32_t>(data, 20);
+		image.Height      = Read<uint32_t>(data, 24);
+		image.MipLevels   = std::max(Read<uint32_t>(data, 40), 1u);
+		ReadVkFormat(Read<uint32_t>(data, 12), image);
+
+		const uint32_t depth                  = Read<uint32_t>(data, 28);
+		const uint32_t layerCount             = Read<uint32_t>(data, 32);
+		const uint32_t faceCount              = Read<uint32_t>(data, 36);
+		const uint32_t supercompressionScheme = Read<uint32_t>(data, 44);
+
+		if (image.Compression == Image::BlockCompression::None || depth > 1 || layerCount > 1 || faceCount != 1 || supercompressionScheme != 0)
+		{
+			ErrorHandler::ThrowRuntimeError(std::format("failed to load image {0}! only single 2D BC1, BC7 or ASTC 4x4 images without supercompression are supported", filePath.string()));
+		}
+
+		ValidateHeader(filePath, image);
+
+		if (headerOnly) { return image; }
+
+		// The level index starts with the biggest level, the data in the file usually starts with the smallest one
+		for (uint32_t level = 0; level < image.MipLevels; ++level)
+		{
+			const size_t indexOffset = KTX2_HEADER_SIZE + level * 3 * sizeof(uint64_t);
+			const size_t byteOffset  = Read<uint64_t>(data, indexOffset);
+			const size_t byteLength  = Read<uint64_t>(data, indexOffset + sizeof(uint64_t));
+
+			if (byteLength != image.GetMipLevelSizeInBytes(level) || byteOffset > data.size() || byteLength > data.size() - byteOffset)
+			{
+				ErrorHandler::ThrowRuntimeError(std::format("failed to load image {0}! mip level {1} is corrupted", filePath.string(), level));
+			}
+
+			image.Pixels.insert(image.Pixels.end(), data.begin() + byteOffset, data.begin() + byteOffset + byteLength);
+		}
+
+		return image;
+	}
+
+	Image ImageLoader::LoadDds(const std::filesystem::path& filePath, const bool headerOnly)
+	{
+		const std::vector<std::byte> data = ReadFile(filePath, headerOnly ? DDS_HEADER_SIZE + DX10_HEADER_SIZE : SIZE_MAX);
+
+		if (data.size() < DDS_HEADER_SIZE || memcmp(data.data(), "DDS ", 4) != 0) { ErrorHandler::ThrowRuntimeError(std::format("failed to load image {0}! not a dds file", filePath.string())); }
+
+		Image image{};
+		image.Height    = Read<uint32_t>(data, 12);
+		image.Width     = Read<uint32_t>(data, 16);
+		image.MipLevels = std::max(Read<uint32_t>(data, 28), 1u);
+
+		size_t dataOffset = DDS_HEADER_SIZE;
+
+		const uint32_t fourCC = Read<uint32_t>(data, 84);
+		if (memcmp(&fourCC, "DXT1", 4) == 0)
+		{
+			image.Compression = Image::BlockCompression::BC1;
+			image.Srgb        = false;
+		}
+		else if (memcmp(&fourCC, "DX10", 4) == 0)
+		{
+			if (Read<uint32_t>(data, 140) <= 1) { ReadDxgiFormat(Read<uint32_t>(data, 128), image); }
+			dataOffset += DX10_HEADER_SIZE;
+		}
+
+		if (image.Compression == Image::BlockCompression::None)
+		{
+			ErrorHandler::ThrowRuntimeError(std::format("failed to load image {0}! only single 2D BC1 or BC7 images are supported", filePath.string()));
+		}
+
+		ValidateHeader(filePath, image);
+
+		if (headerOnly) { return image; }
+
+		// Levels are stored tightly packed starting with the biggest one, just like Image expects
+		size_t sizeInBytes = 0;
+		for (uint32_t level = 0; level < image.MipLevels; ++level)
+		{
+			sizeInBytes += image.GetMipLevelSizeInBytes(level);
+			if (dataOffset + sizeInBytes > data.size()) { ErrorHandler::ThrowRuntimeError(std::format("failed to load image {0}! file is truncated", filePath.string())); }
+		}
+
+		image.Pixels.assign(data.begin() + dataOffset, data.begin() + dataOffset + sizeInBytes);
+
+		return image;
+	}
 }
@@ -0,0 +1,171 @@
+#include "SplitEngine/Rendering/GpuCuller.hpp"
+
+#include "SplitEngine/ErrorHandler.hpp"
+#include "SplitEngine/Debug/Log.hpp"
+#include "SplitEngine/Rendering/Shader.hpp"
+#include "SplitEngine/Rendering/Vulkan/Device.hpp"
+#include "SplitEngine/Rendering/Vulkan/Instance.hpp"
+
+#include <algorithm>
+
+namespace SplitEngine::Rendering
+{
+	namespace
+	{
+		Vulkan::Buffer CreateHostBuffer(Vulkan::Device* device, const vk::DeviceSize sizeInBytes)
+		{
+			return Vulkan::Buffer(device,
+			                      vk::BufferUsageFlagBits::eStorageBuffer,
+			                      vk::SharingMode::eExclusive,
+			                      { Vulkan::Allocator::Auto, vk::Flags<Vulkan::Allocator::MemoryAllocationCreateFlagBits>(Vulkan::Allocator::WriteSequentially | Vulkan::Allocator::PersistentMap) },
+			                      nullptr,
+			                      sizeInBytes,
+			                      sizeInBytes);
+		}
+
+		Vulkan::Buffer CreateDeviceBuffer(Vulkan::Device* device, const vk::Flags<vk::BufferUsageFlagBits> usage, const vk::DeviceSize sizeInBytes)
+		{
+			return Vulkan::Buffer(device, usage, vk::SharingMode::eExclusive, { Vulkan::Allocator::GpuOnly }, nullptr, sizeInBytes, sizeInBytes);
+		}
+	}
+
+	GpuCuller::GpuCuller(AssetHandle<Shader> cullShader, const uint32_t maxInstances, const uint32_t maxDraws) :
+		_cullShader(cullShader),
+		_maxInstances(maxInstances),
+		_maxDraws(maxDraws)
+	{
+		Vulkan::Device* device = &Vulkan::Instance::Get().GetPhysicalDevice().GetDevice();
+
+		// Vertex shaders find their visible instances through the first instance of the commands
+		if (!IsSupported()) { ErrorHandler::ThrowRuntimeError("Device doesn't support drawIndirectFirstInstance, which gpu culling needs to look up visible instances"); }
+
+		_supportsDrawIndirectCount = device->SupportsDrawIndirectCount();
+		if (!_supportsDrawIndirectCount) { LOG_WARNING("Device doesn't support indirect count draws, culled draws fall back to drawing all {0} commands", maxDraws); }
+
+		_supportsMultiDrawIndirect = device->GetEnabledFeatures().multiDrawIndirect;
+		if (!_supportsMultiDrawIndirect) { LOG_WARNING("Device doesn't support multi draw indirect, culled draws fall back to one draw call per command"); }
+
+		_frameBuffers = device->CreateInFlightResource<FrameBuffers>();
+
+		const vk::DeviceSize boundsSize           = maxInstances * sizeof(InstanceBounds);
+		const vk::DeviceSize drawsSize            = maxDraws * sizeof(DrawInfo);
+		const vk::DeviceSize commandsSize         = maxDraws * sizeof(vk::DrawIndexedIndirectCommand);
+		const vk::DeviceSize visibleInstancesSize = maxInstances * sizeof(uint32_t);
+
+		Shader::Properties& properties = _cullShader->GetProperties();
+
+		for (uint32_t i = 0; i < device->GetNumFramesInFlight(); ++i)
+		{
+			FrameBuffers& frameBuffers = _frameBuffers[i];
+
+			frameBuffers.Bounds           = CreateHostBuffer(device, boundsSize);
+			frameBuffers.Draws            = CreateHostBuffer(device, drawsSize);
+			frameBuffers.Commands         = CreateDeviceBuffer(device, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst, commandsSize);
+			frameBuffers.DrawCount        = CreateDeviceBuffer(device, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst, sizeof(uint32_t));
+			frameBuffers.VisibleInstances = CreateDeviceBuffer(device, vk::BufferUsageFlagBits::eStorageBuffer, visibleInstancesSize);
+
+			properties.SetBuffer(Binding::Bounds, frameBuffers.Bounds, 0, boundsSize, i);
+			properties.SetBuffer(Binding::Draws, frameBuffers.Draws, 0, drawsSize, i);
+			properties.SetBuffer(Binding::Commands, frameBuffers.Commands, 0, commandsSize, i);
+			properties.SetBuffer(Binding::DrawCount, frameBuffers.DrawCount, 0, sizeof(uint32_t), i);
+			properties.SetBuffer(Binding::VisibleInstances, frameBuffers.VisibleInstances, 0, visibleInstancesSize, i);
+		}
+
+		_cullShader->Update();
+	}
+
+	bool GpuCuller::IsSupported() { return Vulkan::Instance::Get().GetPhysicalDevice().GetDevice().GetEnabledFeatures().drawIndirectFirstInstance; }
+
+	GpuCuller::InstanceBounds* GpuCuller::GetInstanceBounds() { return _frameBuffers.Get().Bounds.GetMappedData<InstanceBounds>(); }
+
+	GpuCuller::DrawInfo* GpuCuller::GetDrawInfos() { return _frameBuffers.Get().Draws.GetMappedData<DrawInfo>(); }
+
+	void GpuCuller::Cull(const vk::CommandBuffer& computeCommandBuffer, const std::array<glm::vec4, 6>& frustumPlanes, const uint32_t numDraws)
+	{
+		FrameBuffers& frameBuffers = _frameBuffers.Get();
+
+		frameBuffers.NumDraws = std::min(numDraws, _maxDraws);
+		if (frameBuffers.NumDraws == 0) { return; }
+
+		frameBuffers.Bounds.Flush();
+		frameBuffers.Draws.Flush();
+
+		computeCommandBuffer.fillBuffer(frameBuffers.DrawCount.GetVkBuffer(), 0, sizeof(uint32_t), 0);
+
+		// Without the count all commands get drawn, the ones the shader didn't append to need to be empty
+		if (!_supportsDrawIndirectCount) { computeCommandBuffer.fillBuffer(frameBuffers.Commands.GetVkBuffer(), 0, frameBuffers.NumDraws * sizeof(vk::DrawIndexedIndirectCommand), 0); }
+
+		const vk::MemoryBarrier clearBarrier = vk::MemoryBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+		computeCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {}, clearBarrier, nullptr, nullptr);
+
+		CullConstants cullConstants = { frustumPlanes, frameBuffers.NumDraws };
+
+		_cullShader->PushConstant(computeCommandBuffer, ShaderType::Compute, 0, &cullConstants);
+		_cullShader->Dispatch(computeCommandBuffer, frameBuffers.NumDraws);
+	}
+
+	void GpuCuller::Draw(const vk::CommandBuffer& commandBuffer) const
+	{
+		const FrameBuffers& frameBuffers = _frameBuffers.Get();
+		if (frameBuffers.NumDraws == 0) { return; }
+
+		if (_supportsDrawIndirectCount)
+		{
+			commandBuffer.drawIndexedIndirectCount(frameBuffers.Commands.GetVkBuffer(),
+			                                       0,
+			                                       frameBuffers.DrawCount.GetVkBuffer(),
+			                                       0,
+			                                       frameBuffers.NumDraws,
+			                                       sizeof(vk::DrawIndexedIndirectCommand));
+		}
+		else if (_supportsMultiDrawIndirect) { commandBuffer.drawIndexedIndirect(frameBuffers.Commands.GetVkBuffer(), 0, frameBuffers.NumDraws, sizeof(vk::DrawIndexedIndirectCommand)); }
+		else
+		{
+			// A draw count above one needs multi draw indirect, the cleared commands still draw nothing
+			for (uint32_t i = 0; i < frameBuffers.NumDraws; ++i)
+			{
+				commandBuffer.drawIndexedIndirect(frameBuffers.Commands.GetVkBuffer(), i * sizeof(vk::DrawIndexedIndirectCommand), 1, sizeof(vk::DrawIndexedIndirectCommand));
+			}
+		}
+	}
+
+	const Vulkan::Buffer& GpuCuller::GetVisibleInstanceBuffer(const uint32_t frameInFlight)
+	{
+		return frameInFlight == -1u ? _frameBuffers.Get().VisibleInstances : _frameBuffers[frameInFlight].VisibleInstances;
+	}
+
+	std::array<glm::vec4, 6> GpuCuller::ExtractFrustumPlanes(const glm::mat4& viewProjection)
+	{
+		const glm::mat4 rows = glm::transpose(viewProjection);
+
+		// Depth is in the zero to one range, so the near plane is just the third row
+		std::array<glm::vec4, 6> planes = {
+			rows[3] + rows[0],
+			rows[3] - rows[0],
+			rows[3] + rows[1],
+			rows[3] - rows[1],
+			rows[2],
+			rows[3] - rows[2],
+		};
+
+		for (glm::vec4& plane: planes) { plane /= glm::length(glm::vec3(plane)); }
+
+		return planes;
+	}
+
+	void GpuCuller::Destroy()
+	{
+		if (!_frameBuffers.IsValid()) { return; }
+
+		for (FrameBuffers& frameBuffers: _frameBuffers.GetDataVector())
+		{
+			frameBuffers.Bounds.Destroy();
+			frameBuffers.Draws.Destroy();
+			frameBuffers.Commands.Destroy();
+			frameBuffers.DrawCount.Destroy();
+			frameBuffers.VisibleInstances.Destroy();
+		}
+
+		_frameBuffers = {};
+	}
+}
@@ -0,0 +1,217 @@
+#include "SplitEngine/Rendering/GpuProfiler.hpp"
+
+#include "SplitEngine/Debug/Log.hpp"
+#include "SplitEngine/Rendering/Vulkan/Device.hpp"
+#include "SplitEngine/Rendering/Vulkan/PhysicalDevice.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace SplitEngine::Rendering
+{
+	GpuProfiler::GpuProfiler(Vulkan::Device* device, const bool timestamps, const bool pipelineStatistics, const uint32_t maxZones) :
+		_device(device),
+		_maxZones(maxZones)
+	{
+		const Vulkan::PhysicalDevice& physicalDevice = device->GetPhysicalDevice();
+
+		// The compute command buffer is submitted to the graphics queue as well, so its timestamps are the only ones that matter
+		const uint32_t graphicsFamilyIndex = device->GetQueueFamily(Vulkan::QueueType::Graphics).GetIndex();
+		const uint32_t timestampValidBits  = physicalDevice.GetVkPhysicalDevice().getQueueFamilyProperties()[graphicsFamilyIndex].timestampValidBits;
+
+		_timestampsEnabled = timestamps && timestampValidBits > 0;
+		_timestampMask     = timestampValidBits >= 64 ? ~0ull : (1ull << timestampValidBits) - 1;
+		_timestampPeriod   = physicalDevice.GetProperties().limits.timestampPeriod;
+
+		if (timestamps && !_timestampsEnabled) { LOG_WARNING("The graphics queue doesn't support timestamps, gpu times won't be measured"); }
+
+		// The device enables every supported core feature, so they only need to be checked here
+		const vk::PhysicalDeviceFeatures features = physicalDevice.GetVkPhysicalDevice().getFeatures();
+
+		_pipelineStatisticsEnabled = pipelineStatistics && features.pipelineStatisticsQuery && features.inheritedQueries;
+
+		if (pipelineStatistics && !_pipelineStatisticsEnabled) { LOG_WARNING("Device doesn't support pipeline statistics queries in secondary command buffers, pipeline statistics won't be collected"); }
+
+		_frames = device->CreateInFlightResource<Frame>();
+
+		for (Frame& frame: _frames.GetDataVector())
+		{
+			if (_timestampsEnabled)
+			{
+				frame.TimestampPool = device->GetVkDevice().createQueryPool(vk::QueryPoolCreateInfo({}, vk::QueryType::eTimestamp, Timestamp::MAX_VALUE + maxZones * 2));
+			}
+
+			if (_pipelineStatisticsEnabled)
+			{
+				frame.StatisticsPool = device->GetVkDevice().createQueryPool(vk::QueryPoolCreateInfo({}, vk::QueryType::ePipelineStatistics, 2, PIPELINE_STATISTICS));
+			}
+
+			frame.ZoneNames.resize(maxZones, nullptr);
+		}
+	}
+
+	void GpuProfiler::BeginFrame(const vk::CommandBuffer& computeCommandBuffer)
+	{
+		Frame& frame = _frames.Get();
+
+		ReadResults(frame);
+
+		_numZones.store(0, std::memory_order_relaxed);
+
+		if (_timestampsEnabled)
+		{
+			computeCommandBuffer.resetQueryPool(frame.TimestampPool, 0, Timestamp::MAX_VALUE + _maxZones * 2);
+			computeCommandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, frame.TimestampPool, Timestamp::FrameBegin);
+		}
+
+		if (_pipelineStatisticsEnabled)
+		{
+			computeCommandBuffer.resetQueryPool(frame.StatisticsPool, 0, 2);
+			computeCommandBuffer.beginQuery(frame.StatisticsPool, StatisticsQuery::Compute, {});
+		}
+	}
+
+	void GpuProfiler::BeginRenderPass(const vk::CommandBuffer& commandBuffer)
+	{
+		const Frame& frame = _frames.Get();
+
+		if (_timestampsEnabled) { commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, frame.TimestampPool, Timestamp::RenderPassBegin); }
+		if (_pipelineStatisticsEnabled) { commandBuffer.beginQuery(frame.StatisticsPool, StatisticsQuery::RenderPass, {}); }
+	}
+
+	void GpuProfiler::EndRenderPass(const vk::CommandBuffer& commandBuffer)
+	{
+		const Frame& frame = _frames.Get();
+
+		if (_pipelineStatisticsEnabled) { commandBuffer.endQuery(frame.StatisticsPool, StatisticsQuery::RenderPass); }
+		if (_timestampsEnabled) { commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, frame.TimestampPool, Timestamp::RenderPassEnd); }
+	}
+
+	void GpuProfiler::EndFrame(const vk::CommandBuffer& computeCommandBuffer, const vk::CommandBuffer& commandBuffer)
+	{
+		Frame& frame = _frames.Get();
+
+		if (_pipelineStatisticsEnabled) { computeCommandBuffer.endQuery(frame.StatisticsPool, StatisticsQuery::Compute); }
+		if (_timestampsEnabled) { commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, frame.TimestampPool, Timestamp::FrameEnd); }
+
+		frame.NumZones   = std::min(_numZones.load(std::memory_order_relaxed), _maxZones);
+		frame.HasResults = _timestampsEnabled || _pipelineStatisticsEnabled;
+	}
+
+	uint32_t GpuProfiler::BeginZone(const vk::CommandBuffer& commandBuffer, const char* name)
+	{
+		if (!_timestampsEnabled) { return -1u; }
+
+		const uint32_t zone = _numZones.fetch_add(1, std::memory_order_relaxed);
+		if (zone >= _maxZones) { return -1u; }
+
+		Frame& frame = _frames.Get();
+
+		frame.ZoneNames[zone] = name;
+		commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, frame.TimestampPool, Timestamp::MAX_VALUE + zone * 2);
+
+		return zone;
+	}
+
+	void GpuProfiler::EndZone(const vk::CommandBuffer& commandBuffer, const uint32_t zone)
+	{
+		if (zone == -1u) { return; }
+
+		commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, _frames.Get().TimestampPool, Timestamp::MAX_VALUE + zone * 2 + 1);
+	}
+
+	vk::QueryPipelineStatisticFlags GpuProfiler::GetInheritedPipelineStatistics() const { return _pipelineStatisticsEnabled ? PIPELINE_STATISTICS : vk::QueryPipelineStatisticFlags(); }
+
+	const GpuProfiler::FrameResults& GpuProfiler::GetResults() const { return _results; }
+
+	void GpuProfiler::ReadResults(Frame& frame)
+	{
+		if (!frame.HasResults) { return; }
+
+		frame.HasResults = false;
+
+		const vk::Device& vkDevice = _device->GetVkDevice();
+
+		if (_timestampsEnabled)
+		{
+			// Every value is followed by its availability, zones that were never ended are simply left out instead of failing the whole read
+			const uint32_t numQueries = Timestamp::MAX_VALUE + frame.NumZones * 2;
+
+			const vk::ResultValue<std::vector<uint64_t>> timestamps = vkDevice.getQueryPoolResults<uint64_t>(frame.TimestampPool,
+			                                                                                                   0,
+			                                                                                                   numQueries,
+			                                                                                                   numQueries * 2 * sizeof(uint64_t),
+			                                                                                                   2 * sizeof(uint64_t),
+			                                                                                                   vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability);
+
+			const std::vector<uint64_t>& values      = timestamps.value;
+			const auto                   isAvailable = [&values](const uint32_t query) { return values[query * 2 + 1] != 0; };
+			const auto                   getValue    = [&values](const uint32_t query) { return values[query * 2]; };
+
+			if (isAvailable(Timestamp::FrameBegin) && isAvailable(Timestamp::FrameEnd))
+			{
+				_results.FrameTimeMs = GetTimeMs(getValue(Timestamp::FrameBegin), getValue(Timestamp::FrameEnd));
+			}
+
+			if (isAvailable(Timestamp::RenderPassBegin) && isAvailable(Timestamp::RenderPassEnd))
+			{
+				_results.RenderPassTimeMs = GetTimeMs(getValue(Timestamp::RenderPassBegin), getValue(Timestamp::RenderPassEnd));
+			}
+
+			_results.Zones.clear();
+			for (uint32_t zone = 0; zone < frame.NumZones; ++zone)
+			{
+				const uint32_t beginQuery = Timestamp::MAX_VALUE + zone * 2;
+				if (!isAvailable(beginQuery) || !isAvailable(beginQuery + 1)) { continue; }
+
+				_results.Zones.push_back({ frame.ZoneNames[zone], GetTimeMs(getValue(beginQuery), getValue(beginQuery + 1)) });
+			}
+		}
+
+		if (_pipelineStatisticsEnabled)
+		{
+			constexpr uint32_t numStatistics = std::popcount(static_cast<uint32_t>(PIPELINE_STATISTICS));
+
+			const vk::ResultValue<std::vector<uint64_t>> statistics = vkDevice.getQueryPoolResults<uint64_t>(frame.StatisticsPool,
+			                                                                                                   0,
+			                                                                                                   2,
+			                                                                                                   2 * numStatistics * sizeof(uint64_t),
+			                                                                                                   numStatistics * sizeof(uint64_t),
+			                                                                                                   vk::QueryResultFlagBits::e64);
+
+			// Values are in the order of their flag bits, the compute query only counts compute invocations and the render pass query everything else
+			if (statistics.result == vk::Result::eSuccess)
+			{
+				const std::vector<uint64_t>& values = statistics.value;
+
+				GpuPipelineStatistics& pipelineStatistics = _results.PipelineStatistics;
+				pipelineStatistics.InputAssemblyVertices     = values[0] + values[numStatistics + 0];
+				pipelineStatistics.InputAssemblyPrimitives   = values[1] + values[numStatistics + 1];
+				pipelineStatistics.VertexShaderInvocations   = values[2] + values[numStatistics + 2];
+				pipelineStatistics.ClippingPrimitives        = values[3] + values[numStatistics + 3];
+				pipelineStatistics.FragmentShaderInvocations = values[4] + values[numStatistics + 4];
+				pipelineStatistics.ComputeShaderInvocations  = values[5] + values[numStatistics + 5];
+			}
+		}
+
+		_results.FrameNumber++;
+	}
+
+	float GpuProfiler::GetTimeMs(const uint64_t begin, const uint64_t end) const
+	{
+		return static_cast<float>(static_cast<double>((end - begin) & _timestampMask) * _timestampPeriod / 1'000'000.0);
+	}
+
+	void GpuProfiler::Destroy()
+	{
+		if (!_frames.IsValid()) { return; }
+
+		for (const Frame& frame: _frames.GetDataVector())
+		{
+			if (frame.TimestampPool) { _device->GetVkDevice().destroy(frame.TimestampPool); }
+			if (frame.StatisticsPool) { _device->GetVkDevice().destroy(frame.StatisticsPool); }
+		}
+
+		_frames = {};
+	}
+}
@@ -7,6 +7,30 @@ namespace SplitEngine::Rendering
 		_instanceDescriptorSetAllocation(_shader->GetPipeline().AllocatePerInstanceDescriptorSet()),
 		_instanceProperties(Shader::Properties(_shader.Get(), &_instanceDescriptorSetAllocation)) {}
 
+	Material::Material(const CreateInfo& createInfo, Vulkan::DescriptorSetAllocator::Allocation&& instanceDescriptorSetAllocation) :
+		_shader(createInfo._shader),
+		_instanceDescriptorSetAllocation(std::move(instanceDescriptorSetAllocation)),
+		_instanceProperties(Shader::Properties(_shader.Get(), &_instanceDescriptorSetAllocation)) {}
+
+	std::vector<std::unique_ptr<Material>> Material::CreateBatch(std::vector<CreateInfo>&& createInfos)
+	{
+		std::unordered_map<Shader*, std::vector<size_t>> materialsPerShader{};
+		for (size_t i = 0; i < createInfos.size(); ++i) { materialsPerShader[createInfos[i]._shader.Get()].push_back(i); }
+
+		std::vector<std::unique_ptr<Material>> materials = std::vector<std::unique_ptr<Material>>(createInfos.size());
+		for (auto& [shader, indices]: materialsPerShader)
+		{
+			std::vector<Vulkan::DescriptorSetAllocator::Allocation> allocations = shader->GetPipeline().AllocatePerInstanceDescriptorSets(static_cast<uint32_t>(indices.size()));
+
+			for (size_t i = 0; i < indices.size(); ++i)
+			{
+				materials[indices[i]] = std::unique_ptr<Material>(new Material(createInfos[indices[i]], std::move(allocations[i])));
+			}
+		}
+
+		return materials;
+	}
+
 	AssetHandle<Shader> Material::GetShader() const { return _shader; }
 
 	void Material::Update() { _instanceProperties.Update(); }
@@ -1,17 +1,38 @@
 #include "SplitEngine/Rendering/Model.hpp"
 
+#include "SplitEngine/Rendering/Vulkan/Instance.hpp"
+
 namespace SplitEngine::Rendering
 {
-	const Vulkan::Buffer& Model::GetModelBuffer() const { return _modelBuffer; }
+	Model::Model(const CreateInfo& createInfo)
+	{
+		const bool          useLargeIndices = !createInfo.LargeIndices.empty();
+		const std::byte*    indices         = useLargeIndices ? reinterpret_cast<const std::byte*>(createInfo.LargeIndices.data()) : reinterpret_cast<const std::byte*>(createInfo.Indices.data());
+		const size_t        numIndices      = useLargeIndices ? createInfo.LargeIndices.size() : createInfo.Indices.size();
+		const vk::IndexType indexType       = useLargeIndices ? vk::IndexType::eUint32 : vk::IndexType::eUint16;
 
-	Model::~Model() { _modelBuffer.Destroy(); }
+		_mesh = Vulkan::Instance::Get().GetMeshArena().Allocate(createInfo.Vertices.data(),
+		                                                        createInfo.Vertices.size(),
+		                                                        createInfo.VertexSizeInBytes,
+		                                                        indices,
+		                                                        static_cast<uint32_t>(numIndices),
+		                                                        indexType);
+	}
 
-	void Model::Bind(const vk::CommandBuffer& commandBuffer) const
+	Model::~Model()
 	{
-		const vk::Buffer         vertexBuffers[] = { _modelBuffer.GetVkBuffer() };
-		constexpr vk::DeviceSize offsets[]       = { 0 };
-
-		commandBuffer.bindVertexBuffers(0, 1, vertexBuffers, offsets);
-		commandBuffer.bindIndexBuffer(_modelBuffer.GetVkBuffer(), _modelBuffer.GetSizeInBytes(0), vk::IndexType::eUint16);
+		if (_mesh.VertexBlockIndex != -1u) { Vulkan::Instance::Get().GetMeshArena().Free(_mesh); }
 	}
+
+	const Vulkan::MeshArena::Mesh& Model::GetMesh() const { return _mesh; }
+
+	uint32_t Model::GetNumIndices() const { return _mesh.NumIndices; }
+
+	uint32_t Model::GetFirstIndex() const { return _mesh.FirstIndex; }
+
+	int32_t Model::GetVertexOffset() const { return _mesh.VertexOffset; }
+
+	vk::IndexType Model::GetIndexType() const { return _mesh.IndexType; }
+
+	void Model::Bind(const vk::CommandBuffer& commandBuffer) const { Vulkan::Instance::Get().GetMeshArena().Bind(commandBuffer, _mesh); }
 }
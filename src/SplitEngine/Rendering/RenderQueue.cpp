@@ -0,0 +1,197 @@
+#include "SplitEngine/Rendering/RenderQueue.hpp"
+
+#include "SplitEngine/Rendering/Material.hpp"
+#include "SplitEngine/Rendering/Model.hpp"
+#include "SplitEngine/Rendering/Shader.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace SplitEngine::Rendering
+{
+	namespace
+	{
+		// Key layout from most to least significant bits, ids that don't fit wrap around which only makes the sort less effective
+		constexpr uint64_t SHADER_BITS      = 12;
+		constexpr uint64_t MATERIAL_BITS    = 20;
+		constexpr uint64_t MESH_BUFFER_BITS = 4;
+		constexpr uint64_t MODEL_BITS       = 12;
+		constexpr uint64_t DEPTH_BITS       = 16;
+
+		constexpr uint64_t MODEL_SHIFT       = DEPTH_BITS;
+		constexpr uint64_t MESH_BUFFER_SHIFT = MODEL_SHIFT + MODEL_BITS;
+		constexpr uint64_t MATERIAL_SHIFT    = MESH_BUFFER_SHIFT + MESH_BUFFER_BITS;
+		constexpr uint64_t SHADER_SHIFT      = MATERIAL_SHIFT + MATERIAL_BITS;
+
+		constexpr uint64_t Mask(const uint64_t bits) { return (1ull << bits) - 1; }
+
+		uint64_t QuantizeDepth(const float depth)
+		{
+			// The bits of a positive float sort the same way as its value, so the upper bits are a cheap quantization
+			return depth > 0.0f ? std::bit_cast<uint32_t>(depth) >> (32 - DEPTH_BITS) : 0;
+		}
+	}
+
+	void RenderQueue::Submit(const DrawPacket& drawPacket)
+	{
+		const uint64_t key = (GetSortId(0, drawPacket.Shader) & Mask(SHADER_BITS)) << SHADER_SHIFT |
+		                     (GetSortId(1, drawPacket.Material) & Mask(MATERIAL_BITS)) << MATERIAL_SHIFT |
+		                     (GetMeshBufferSortId(drawPacket.Model) & Mask(MESH_BUFFER_BITS)) << MESH_BUFFER_SHIFT |
+		                     (GetSortId(2, drawPacket.Model) & Mask(MODEL_BITS)) << MODEL_SHIFT |
+		                     QuantizeDepth(drawPacket.Depth);
+
+		_sortEntries.push_back({ key, static_cast<uint32_t>(_drawPackets.size()) });
+		_drawPackets.push_back(drawPacket);
+	}
+
+	void RenderQueue::Sort()
+	{
+		// LSD radix sort over 8 bit digits, it's stable so draws with equal keys keep their submission order
+		_sortScratch.resize(_sortEntries.size());
+
+		for (uint64_t shift = 0; shift < 64; shift += 8)
+		{
+			std::array<size_t, 256> offsets{};
+			for (const SortEntry& sortEntry: _sortEntries) { offsets[(sortEntry.Key >> shift) & 0xFF]++; }
+
+			// Every key shares this digit, so the pass wouldn't change anything
+			if (std::ranges::find(offsets, _sortEntries.size()) != offsets.end()) { continue; }
+
+			size_t offset = 0;
+			for (size_t& bucketOffset: offsets)
+			{
+				const size_t count = bucketOffset;
+				bucketOffset       = offset;
+				offset += count;
+			}
+
+			for (const SortEntry& sortEntry: _sortEntries) { _sortScratch[offsets[(sortEntry.Key >> shift) & 0xFF]++] = sortEntry; }
+
+			std::swap(_sortEntries, _sortScratch);
+		}
+	}
+
+	void RenderQueue::WriteIndirectCommands(Vulkan::TransientBufferAllocator& transientBufferAllocator, const uint32_t maxDrawIndirectCount)
+	{
+		_indirectCommands     = transientBufferAllocator.Allocate(_sortEntries.size() * sizeof(vk::DrawIndexedIndirectCommand), vk::BufferUsageFlagBits::eIndirectBuffer);
+		_maxDrawIndirectCount = std::max(maxDrawIndirectCount, 1u);
+
+		vk::DrawIndexedIndirectCommand* indirectCommands = _indirectCommands.GetData<vk::DrawIndexedIndirectCommand>();
+
+		// Commands are in sorted order, so a merged draw reads a contiguous range
+		for (size_t i = 0; i < _sortEntries.size(); ++i)
+		{
+			const DrawPacket& drawPacket = _drawPackets[_sortEntries[i].PacketIndex];
+			const Model*      model      = drawPacket.Model;
+
+			if (model == nullptr) { indirectCommands[i] = vk::DrawIndexedIndirectCommand(); }
+			else
+			{
+				indirectCommands[i] = vk::DrawIndexedIndirectCommand(model->GetNumIndices(), drawPacket.NumInstances, model->GetFirstIndex(), model->GetVertexOffset(), drawPacket.FirstInstance);
+			}
+		}
+	}
+
+	void RenderQueue::Record(const vk::CommandBuffer& commandBuffer, const size_t firstDraw, const size_t numDraws) const
+	{
+		vk::CommandBuffer mutableCommandBuffer = commandBuffer;
+
+		Shader*                        boundShader   = nullptr;
+		Material*                      boundMaterial = nullptr;
+		const Vulkan::MeshArena::Mesh* boundMesh     = nullptr;
+
+		const size_t lastDraw = firstDraw + numDraws;
+
+		for (size_t i = firstDraw; i < lastDraw; ++i)
+		{
+			const DrawPacket& drawPacket = _drawPackets[_sortEntries[i].PacketIndex];
+
+			// Pipeline layouts of different shaders aren't necessarily compatible, so all sets need to be bound again after a pipeline change
+			if (drawPacket.Shader != boundShader)
+			{
+				drawPacket.Shader->BindGlobal(commandBuffer);
+				drawPacket.Shader->Bind(commandBuffer);
+
+				boundShader   = drawPacket.Shader;
+				boundMaterial = nullptr;
+			}
+
+			if (drawPacket.Material != boundMaterial)
+			{
+				if (drawPacket.Material != nullptr) { drawPacket.Material->Bind(mutableCommandBuffer); }
+				boundMaterial = drawPacket.Material;
+			}
+
+			const Model* model = drawPacket.Model;
+
+			if (model == nullptr)
+			{
+				commandBuffer.draw(drawPacket.VertexCount, drawPacket.NumInstances, 0, drawPacket.FirstInstance);
+				continue;
+			}
+
+			// Vertex and index buffers aren't affected by pipeline changes, and models in the same blocks of the mesh arena share them
+			if (boundMesh == nullptr || !model->GetMesh().SharesBuffersWith(*boundMesh))
+			{
+				model->Bind(commandBuffer);
+				boundMesh = &model->GetMesh();
+			}
+
+			size_t numMergedDraws = 1;
+			if (_indirectCommands.Buffer)
+			{
+				while (i + numMergedDraws < lastDraw &&
+				       numMergedDraws < _maxDrawIndirectCount &&
+				       CanMerge(drawPacket, _drawPackets[_sortEntries[i + numMergedDraws].PacketIndex])) { numMergedDraws++; }
+			}
+
+			if (numMergedDraws > 1)
+			{
+				commandBuffer.drawIndexedIndirect(_indirectCommands.Buffer,
+				                                  _indirectCommands.Offset + i * sizeof(vk::DrawIndexedIndirectCommand),
+				                                  static_cast<uint32_t>(numMergedDraws),
+				                                  sizeof(vk::DrawIndexedIndirectCommand));
+
+				i += numMergedDraws - 1;
+			}
+			else { commandBuffer.drawIndexed(model->GetNumIndices(), drawPacket.NumInstances, model->GetFirstIndex(), model->GetVertexOffset(), drawPacket.FirstInstance); }
+		}
+	}
+
+	void RenderQueue::Clear()
+	{
+		_drawPackets.clear();
+		_sortEntries.clear();
+		for (std::unordered_map<const void*, uint32_t>& sortIds: _sortIds) { sortIds.clear(); }
+		_meshBufferSortIds.clear();
+
+		_indirectCommands = {};
+	}
+
+	size_t RenderQueue::GetNumDraws() const { return _drawPackets.size(); }
+
+	uint32_t RenderQueue::GetSortId(const size_t category, const void* pointer)
+	{
+		return _sortIds[category].try_emplace(pointer, static_cast<uint32_t>(_sortIds[category].size())).first->second;
+	}
+
+	uint32_t RenderQueue::GetMeshBufferSortId(const Model* model)
+	{
+		if (model == nullptr) { return 0; }
+
+		const Vulkan::MeshArena::Mesh& mesh = model->GetMesh();
+
+		const uint64_t meshBuffers = static_cast<uint64_t>(mesh.VertexBlockIndex) << 32 | static_cast<uint64_t>(mesh.IndexBlockIndex) << 1 | (mesh.IndexType == vk::IndexType::eUint32);
+
+		return _meshBufferSortIds.try_emplace(meshBuffers, static_cast<uint32_t>(_meshBufferSortIds.size())).first->second;
+	}
+
+	bool RenderQueue::CanMerge(const DrawPacket& drawPacket, const DrawPacket& nextDrawPacket)
+	{
+		return nextDrawPacket.Shader == drawPacket.Shader &&
+		       nextDrawPacket.Material == drawPacket.Material &&
+		       nextDrawPacket.Model != nullptr &&
+		       nextDrawPacket.Model->GetMesh().SharesBuffersWith(drawPacket.Model->GetMesh());
+	}
+}
@@ -3,7 +3,10 @@
 #include "SplitEngine/ErrorHandler.hpp"
 #include "SplitEngine/Debug/Performance.hpp"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <thread>
 #include <SplitEngine/RenderingSettings.hpp>
 
 #include "SplitEngine/Window.hpp"
@@ -11,23 +14,53 @@
 namespace SplitEngine::Rendering
 {
 	Renderer::Renderer(ApplicationInfo& applicationInfo, ShaderParserSettings&& shaderParserSettings, RenderingSettings&& renderingSettings):
-		_window(Window(applicationInfo.Name, 500, 500)),
+		_window(renderingSettings.Headless
+			        ? Window(applicationInfo.Name, renderingSettings.HeadlessResolution.width, renderingSettings.HeadlessResolution.height, true)
+			        : Window(applicationInfo.Name, 500, 500)),
 		_vulkanInstance(Vulkan::Instance(_window, applicationInfo, std::move(shaderParserSettings), std::move(renderingSettings)))
 	{
 		_window.OnResize.Add([this](int width, int height) { _frameBufferResized = true; });
 
 		_commandBuffer = _vulkanInstance.GetPhysicalDevice().GetDevice().GetQueueFamily(Vulkan::QueueType::Graphics).AllocateCommandBuffer(Vulkan::QueueType::Graphics);
+
+		// Graphics queues always support compute, so no queue ownership transfers or semaphores are needed between the two
+		_computeCommandBuffer = _vulkanInstance.GetPhysicalDevice().GetDevice().GetQueueFamily(Vulkan::QueueType::Graphics).AllocateCommandBuffer(Vulkan::QueueType::Graphics);
+
+		_uploadCommandBuffer = _vulkanInstance.GetPhysicalDevice().GetDevice().GetQueueFamily(Vulkan::QueueType::Graphics).AllocateCommandBuffer(Vulkan::QueueType::Graphics);
+
+		_transientBufferAllocator = Vulkan::TransientBufferAllocator(&_vulkanInstance.GetPhysicalDevice().GetDevice(), _vulkanInstance.GetRenderingSettings().TransientBufferSizeInBytes);
+
+		uint32_t numRecordingThreads = _vulkanInstance.GetRenderingSettings().CommandRecordingThreads;
+		if (numRecordingThreads == -1u) { numRecordingThreads = std::max(std::thread::hardware_concurrency(), 1u) - 1; }
+
+		_parallelCommandRecorder = std::make_unique<Vulkan::ParallelCommandRecorder>(&_vulkanInstance.GetPhysicalDevice().GetDevice(), numRecordingThreads);
+
+		const RenderingSettings& settings = _vulkanInstance.GetRenderingSettings();
+		_gpuProfiler = std::make_unique<GpuProfiler>(&_vulkanInstance.GetPhysicalDevice().GetDevice(), settings.GpuTimestamps, settings.GpuPipelineStatistics, settings.MaxGpuProfilerZones);
 	}
 
 	Renderer::~Renderer()
 	{
 		LOG("Shutting down Renderer...");
 
+		_gpuProfiler->Destroy();
+		_parallelCommandRecorder->Destroy();
+		_transientBufferAllocator.Destroy();
 		_vulkanInstance.Destroy();
 		_window.Close();
 	}
 
-	Vulkan::CommandBuffer& Renderer::GetCommandBuffer() { return _commandBuffer; }
+	Vulkan::CommandBuffer& Renderer::GetCommandBuffer() { return _parallelCommandRecorder->GetInlineCommandBuffer(); }
+
+	Vulkan::CommandBuffer& Renderer::GetComputeCommandBuffer() { return _computeCommandBuffer; }
+
+	Vulkan::ParallelCommandRecorder& Renderer::GetParallelCommandRecorder() { return *_parallelCommandRecorder; }
+
+	RenderQueue& Renderer::GetRenderQueue() { return _renderQueue; }
+
+	GpuProfiler& Renderer::GetGpuProfiler() { return *_gpuProfiler; }
+
+	float Renderer::GetGpuWaitTimeMs() const { return _gpuWaitTimeMs; }
 
 	void Renderer::HandleEvents(SDL_Event event) { _window.HandleEvents(event); }
 
@@ -35,8 +68,29 @@ namespace SplitEngine::Rendering
 
 	Vulkan::Instance& Renderer::GetVulkanInstance() { return _vulkanInstance; }
 
+	Vulkan::TransientBufferAllocator& Renderer::GetTransientBufferAllocator() { return _transientBufferAllocator; }
+
 	Window& Renderer::GetWindow() { return _window; }
 
+	void Renderer::WaitForFrame()
+	{
+		if (_window.IsMinimized()) { return; }
+
+		Vulkan::Device& device = _vulkanInstance.GetPhysicalDevice().GetDevice();
+
+		// If the cpu has to wait here a lot the frame is gpu bound
+		const std::chrono::steady_clock::time_point waitStartTime = std::chrono::steady_clock::now();
+
+		device.GetVkDevice().waitForFences(device.GetInFlightFence(), vk::True, UINT64_MAX);
+
+		_gpuWaitTimeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - waitStartTime).count();
+
+		// The fence gets reset in BeginRender, so a readback can't wait on it anymore
+		if (_lastFrameFence == device.GetInFlightFence()) { _lastFrameFence = VK_NULL_HANDLE; }
+
+		_hasWaitedForFrame = true;
+	}
+
 	void Renderer::BeginRender()
 	{
 		if (_window.IsMinimized())
@@ -47,29 +101,48 @@ namespace SplitEngine::Rendering
 
 		Vulkan::Device& device = _vulkanInstance.GetPhysicalDevice().GetDevice();
 
-		device.GetVkDevice().waitForFences(device.GetInFlightFence(), vk::True, UINT64_MAX);
-
-		vk::ResultValue<uint32_t> imageIndexResult        = vk::ResultValue<uint32_t>(vk::Result::eIncomplete, 0);
-		bool                      needToRecreateSwapChain = false;
-		try
-		{
-			imageIndexResult = device.GetVkDevice().acquireNextImageKHR(device.GetSwapchain().GetVkSwapchain(), UINT64_MAX, device.GetImageAvailableSemaphore(), VK_NULL_HANDLE);
-		}
-		catch (vk::OutOfDateKHRError& outOfDateKhrError) { needToRecreateSwapChain = true; } catch (vk::SystemError& systemError)
-		{
-			ErrorHandler::ThrowRuntimeError(std::format("failed to present swap chain image! {0}", systemError.what()));
-		}
+		// With frame pacing the wait already happened at the start of the frame
+		if (!_hasWaitedForFrame) { WaitForFrame(); }
+		_hasWaitedForFrame = false;
 
-		_latestImageIndexResult = imageIndexResult.value;
+		// Buffers only get moved while no upload could still write into their old place
+		_vulkanInstance.GetAllocator().Update(_vulkanInstance.GetUploadManager().IsIdle());
 
-		if (needToRecreateSwapChain)
-		{
-			device.GetVkDevice().waitIdle();
-			device.CreateSwapchain(_vulkanInstance.GetVkSurface(), _window.GetSize());
+		// The gpu is done with everything this frame allocated the last time around
+		_transientBufferAllocator.Reset();
+		_vulkanInstance.GetBindlessTextureTable().Update();
+		_vulkanInstance.GetDescriptorBufferArena().Update();
+		_vulkanInstance.GetMeshArena().Update();
 
-			_wasSkipped = true;
+		// Properties changed since the last frame get written in one go, the sets of this frame in flight aren't in use anymore
+		_vulkanInstance.GetDescriptorWriteBatch().Flush();
 
-			return;
+		// Offscreen images are used in turn, the fence above already guarantees the next one isn't in use anymore
+		if (device.IsHeadless()) { _latestImageIndexResult = static_cast<uint32_t>(_numHeadlessFrames++ % device.GetOffscreenTargets().GetImages().size()); }
+		else
+		{
+			vk::ResultValue<uint32_t> imageIndexResult        = vk::ResultValue<uint32_t>(vk::Result::eIncomplete, 0);
+			bool                      needToRecreateSwapChain = false;
+			try
+			{
+				imageIndexResult = device.GetVkDevice().acquireNextImageKHR(device.GetSwapchain().GetVkSwapchain(), UINT64_MAX, device.GetImageAvailableSemaphore(), VK_NULL_HANDLE);
+			}
+			catch (vk::OutOfDateKHRError& outOfDateKhrError) { needToRecreateSwapChain = true; } catch (vk::SystemError& systemError)
+			{
+				ErrorHandler::ThrowRuntimeError(std::format("failed to present swap chain image! {0}", systemError.what()));
+			}
+
+			_latestImageIndexResult = imageIndexResult.value;
+
+			if (needToRecreateSwapChain)
+			{
+				device.GetVkDevice().waitIdle();
+				device.CreateSwapchain(_vulkanInstance.GetVkSurface(), _window.GetSize());
+
+				_wasSkipped = true;
+
+				return;
+			}
 		}
 
 		device.GetVkDevice().resetFences(device.GetInFlightFence());
@@ -82,6 +155,12 @@ namespace SplitEngine::Rendering
 
 		commandBuffer.begin(commandBufferBeginInfo);
 
+		const vk::CommandBuffer& computeCommandBuffer = _computeCommandBuffer.GetVkCommandBuffer();
+		computeCommandBuffer.reset({});
+		computeCommandBuffer.begin(commandBufferBeginInfo);
+
+		_gpuProfiler->BeginFrame(computeCommandBuffer);
+
 		Color color = _vulkanInstance.GetRenderingSettings().ClearColor;
 
 		const vk::ClearValue clearColor = vk::ClearValue(color.ConvertToType<vk::ClearColorValue>());
@@ -91,19 +170,25 @@ namespace SplitEngine::Rendering
 		std::vector<vk::ClearValue> clearValues = { clearColor, depthClearColor };
 
 		const vk::RenderPassBeginInfo renderPassBeginInfo = vk::RenderPassBeginInfo(device.GetRenderPass().GetVkRenderPass(),
-		                                                                            device.GetSwapchain().GetFrameBuffers()[imageIndexResult.value],
-		                                                                            { { 0, 0 }, device.GetSwapchain().GetExtend() },
+		                                                                            device.GetFrameBuffer(_latestImageIndexResult),
+		                                                                            { { 0, 0 }, device.GetRenderExtent() },
 		                                                                            clearValues);
 
-		vk::Extent2D extent   = device.GetSwapchain().GetExtend();
+		vk::Extent2D extent   = device.GetRenderExtent();
 		vk::Viewport viewport = _vulkanInstance.CreateViewport(extent);
 
-		commandBuffer.setViewport(0, 1, &viewport);
-
 		const vk::Rect2D scissor = vk::Rect2D({ 0, 0 }, extent);
-		commandBuffer.setScissor(0, 1, &scissor);
 
-		commandBuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
+		_gpuProfiler->BeginRenderPass(commandBuffer);
+
+		// Everything inside the render pass gets recorded into secondary command buffers, the viewport and scissor are set in each of them
+		commandBuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+
+		_parallelCommandRecorder->BeginFrame(device.GetRenderPass().GetVkRenderPass(),
+		                                     device.GetFrameBuffer(_latestImageIndexResult),
+		                                     viewport,
+		                                     scissor,
+		                                     _gpuProfiler->GetInheritedPipelineStatistics());
 	}
 
 	void Renderer::EndRender()
@@ -114,14 +199,69 @@ namespace SplitEngine::Rendering
 		if (_wasSkipped)
 		{
 			_wasSkipped = false;
+			_renderQueue.Clear();
 			return;
 		}
 
+		RecordRenderQueue();
+
+		_parallelCommandRecorder->EndFrame(commandBuffer);
+
 		commandBuffer.endRenderPass();
+
+		_gpuProfiler->EndRenderPass(commandBuffer);
+
+		if (device.IsHeadless()) { device.GetOffscreenTargets().RecordReadback(commandBuffer, _latestImageIndexResult); }
+
+		const vk::CommandBuffer& computeCommandBuffer = _computeCommandBuffer.GetVkCommandBuffer();
+
+		_gpuProfiler->EndFrame(computeCommandBuffer, commandBuffer);
+
 		commandBuffer.end();
 
+		// Barriers cover everything submitted after them on the same queue, so this also guards the main command buffer
+		const vk::MemoryBarrier computeBarrier = vk::MemoryBarrier(vk::AccessFlagBits::eShaderWrite,
+		                                                           vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eShaderRead);
+
+		computeCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+		                                     vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader,
+		                                     {},
+		                                     computeBarrier,
+		                                     nullptr,
+		                                     nullptr);
+		computeCommandBuffer.end();
+
+		// Once submitted the bindless set of this frame can't be written anymore until its fence was waited on
+		_vulkanInstance.GetBindlessTextureTable().EndFrame();
+
+		_transientBufferAllocator.Flush();
+
+		// Uploads get submitted last so everything created during the frame is included, the required ones are waited on before the frame that uses them is submitted.
+		// Ownership acquires and mipmap generation need to happen outside of a render pass and before the compute work, so they get a command buffer of their own that runs first.
+		const vk::CommandBuffer& uploadCommandBuffer = _uploadCommandBuffer.GetVkCommandBuffer();
+		uploadCommandBuffer.reset({});
+		uploadCommandBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit, nullptr));
+
+		_vulkanInstance.GetUploadManager().Update(uploadCommandBuffer);
+
+		uploadCommandBuffer.end();
+
+		const std::array<vk::CommandBuffer, 3> commandBuffers = { uploadCommandBuffer, computeCommandBuffer, commandBuffer };
+
+		if (device.IsHeadless())
+		{
+			// Nothing was acquired and nothing gets presented, so there is nothing to wait on or signal
+			device.GetQueueFamily(Vulkan::QueueType::Graphics).GetVkQueue().submit(vk::SubmitInfo({}, {}, commandBuffers, {}), device.GetInFlightFence());
+
+			_lastFrameFence      = device.GetInFlightFence();
+			_lastFrameImageIndex = _latestImageIndexResult;
+
+			device.AdvanceFrame();
+			return;
+		}
+
 		vk::PipelineStageFlags waitStages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
-		const vk::SubmitInfo   submitInfo   = vk::SubmitInfo(device.GetImageAvailableSemaphore(), waitStages, commandBuffer, device.GetRenderFinishedSemaphore());
+		const vk::SubmitInfo   submitInfo   = vk::SubmitInfo(device.GetImageAvailableSemaphore(), waitStages, commandBuffers, device.GetRenderFinishedSemaphore());
 
 		device.GetQueueFamily(Vulkan::QueueType::Graphics).GetVkQueue().submit(submitInfo, device.GetInFlightFence());
 
@@ -146,4 +286,47 @@ namespace SplitEngine::Rendering
 
 		device.AdvanceFrame();
 	}
+
+	IO::Image Renderer::ReadBackFrame()
+	{
+		Vulkan::Device& device = _vulkanInstance.GetPhysicalDevice().GetDevice();
+
+		if (!device.IsHeadless()) { ErrorHandler::ThrowRuntimeError("Frames can only be read back in headless mode"); }
+		if (_lastFrameImageIndex == -1u) { ErrorHandler::ThrowRuntimeError("Can't read back a frame before one has been rendered"); }
+
+		if (_lastFrameFence) { device.GetVkDevice().waitForFences(_lastFrameFence, vk::True, UINT64_MAX); }
+
+		return device.GetOffscreenTargets().ReadBack(_lastFrameImageIndex);
+	}
+
+	void Renderer::RecordRenderQueue()
+	{
+		const size_t numDraws = _renderQueue.GetNumDraws();
+		if (numDraws == 0) { return; }
+
+		_renderQueue.Sort();
+
+		const Vulkan::Device& device = _vulkanInstance.GetPhysicalDevice().GetDevice();
+		if (device.SupportsMultiDrawIndirect())
+		{
+			_renderQueue.WriteIndirectCommands(_transientBufferAllocator, device.GetPhysicalDevice().GetProperties().limits.maxDrawIndirectCount);
+		}
+
+		// Every job starts without any state bound, so big queues are only split up as far as the workers can actually record in parallel
+		const size_t numJobs = std::min<size_t>(_parallelCommandRecorder->GetNumWorkers() + 1, (numDraws + MIN_DRAWS_PER_RECORDING_JOB - 1) / MIN_DRAWS_PER_RECORDING_JOB);
+
+		if (numJobs <= 1) { _renderQueue.Record(GetCommandBuffer().GetVkCommandBuffer(), 0, numDraws); }
+		else
+		{
+			_parallelCommandRecorder->Record(static_cast<uint32_t>(numJobs),
+			                                 [this, numDraws, numJobs](const uint32_t jobIndex, const vk::CommandBuffer& commandBuffer)
+			                                 {
+				                                 const size_t firstDraw = jobIndex * numDraws / numJobs;
+				                                 const size_t lastDraw  = (jobIndex + 1) * numDraws / numJobs;
+				                                 _renderQueue.Record(commandBuffer, firstDraw, lastDraw - firstDraw);
+			                                 });
+		}
+
+		_renderQueue.Clear();
+	}
 }
@@ -5,7 +5,11 @@
 #include "SplitEngine/Rendering/Vulkan/Instance.hpp"
 #include "SplitEngine/Rendering/Vulkan/Pipeline.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <filesystem>
+#include <thread>
 #include <vector>
 
 #define PRIVATE_FIF_SELECTOR(descriptorPtr, fifVar, attribute) fifVar == -1 ? descriptorPtr->attribute.Get() : descriptorPtr->attribute[fifVar]
@@ -32,15 +36,15 @@ namespace SplitEngine::Rendering
 
 	bool Shader::_globalPropertiesDefined = false;
 
-	std::vector<Vulkan::Pipeline::ShaderInfo> Shader::CreateShaderInfos()
+	std::vector<Vulkan::Pipeline::ShaderInfo> Shader::CreateShaderInfos(const std::vector<std::filesystem::path>& shaderPaths)
 	{
 		std::vector<Vulkan::Pipeline::ShaderInfo> shaderInfos{};
-		const ShaderParserSettings&               shaderParserSettings = _device->GetPhysicalDevice().GetInstance().GetShaderParserSettings();
+		const ShaderParserSettings&               shaderParserSettings = Vulkan::Instance::Get().GetShaderParserSettings();
 
-		shaderInfos.reserve(_shaderPaths.size());
+		shaderInfos.reserve(shaderPaths.size());
 
 		// Get shader infos
-		for (std::filesystem::path& file: _shaderPaths)
+		for (std::filesystem::path file: shaderPaths)
 		{
 			if (!file.has_extension()) { ErrorHandler::ThrowRuntimeError(std::format("Failed to parse shader files! {0}", file.string())); }
 
@@ -59,13 +63,22 @@ namespace SplitEngine::Rendering
 		return shaderInfos;
 	}
 
+	Vulkan::Pipeline Shader::CreatePipeline(const CreateInfo& createInfo)
+	{
+		return Vulkan::Pipeline(&Vulkan::Instance::Get().GetPhysicalDevice().GetDevice(),
+		                        "main",
+		                        CreateShaderInfos(createInfo.ShaderPaths),
+		                        createInfo.PipelineCreateInfo.has_value() ? createInfo.PipelineCreateInfo.value() : Vulkan::Instance::Get().GetRenderingSettings().PipelineCreateInfo);
+	}
+
 	Shader::Shader(const CreateInfo& createInfo) :
+		Shader(createInfo, CreatePipeline(createInfo))
+	{}
+
+	Shader::Shader(const CreateInfo& createInfo, Vulkan::Pipeline&& pipeline) :
 		_shaderPaths(createInfo.ShaderPaths),
 		_device(&Vulkan::Instance::Get().GetPhysicalDevice().GetDevice()),
-		_pipeline(_device,
-		          "main",
-		          CreateShaderInfos(),
-		          createInfo.PipelineCreateInfo.has_value() ? createInfo.PipelineCreateInfo.value() : Vulkan::Instance::Get().GetRenderingSettings().PipelineCreateInfo),
+		_pipeline(std::move(pipeline)),
 		_shaderProperties(Properties(this, &_pipeline.GetPerPipelineDescriptorSetAllocation()))
 	{
 		if (!_globalPropertiesDefined)
@@ -75,6 +88,55 @@ namespace SplitEngine::Rendering
 		}
 	}
 
+	std::vector<std::unique_ptr<Shader>> Shader::CreateBatch(std::vector<CreateInfo>&& createInfos)
+	{
+		std::vector<Vulkan::Pipeline>   pipelines  = std::vector<Vulkan::Pipeline>(createInfos.size());
+		std::vector<std::exception_ptr> exceptions = std::vector<std::exception_ptr>(createInfos.size());
+
+		if (createInfos.empty()) { return {}; }
+
+		// The first pipeline that gets created defines the global set, so the first shader is created up front like it would be without a batch
+		pipelines[0] = CreatePipeline(createInfos[0]);
+
+		// The remaining pipelines are independent of each other so workers just grab the next one until none are left
+		std::atomic<size_t> nextIndex = 1;
+
+		const size_t numThreads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), createInfos.size() - 1);
+		{
+			std::vector<std::jthread> workers{};
+			workers.reserve(numThreads);
+
+			for (size_t i = 0; i < numThreads; ++i)
+			{
+				workers.emplace_back([&] {
+					for (size_t index = nextIndex++; index < createInfos.size(); index = nextIndex++)
+					{
+						try { pipelines[index] = CreatePipeline(createInfos[index]); }
+						catch (...) { exceptions[index] = std::current_exception(); }
+					}
+				});
+			}
+		}
+
+		for (size_t i = 0; i < exceptions.size(); ++i)
+		{
+			if (exceptions[i] == nullptr) { continue; }
+
+			// Don't leak the pipelines that did get created
+			for (size_t j = 0; j < pipelines.size(); ++j) { if (exceptions[j] == nullptr) { pipelines[j].Destroy(); } }
+
+			std::rethrow_exception(exceptions[i]);
+		}
+
+		// Properties touch static bookkeeping, so the shaders themselves are created on this thread
+		std::vector<std::unique_ptr<Shader>> shaders{};
+		shaders.reserve(createInfos.size());
+
+		for (size_t i = 0; i < createInfos.size(); ++i) { shaders.push_back(std::unique_ptr<Shader>(new Shader(createInfos[i], std::move(pipelines[i])))); }
+
+		return shaders;
+	}
+
 	Vulkan::Pipeline& Shader::GetPipeline() { return _pipeline; }
 
 	Shader::~Shader() { _pipeline.Destroy(); }
@@ -94,6 +156,16 @@ namespace SplitEngine::Rendering
 		_pipeline.BindDescriptorSets(commandBuffer, _shaderProperties._descriptorSetAllocation, 1, 0, nullptr, frameInFlight);
 	}
 
+	void Shader::Dispatch(const vk::CommandBuffer& commandBuffer, const uint32_t groupCountX, const uint32_t groupCountY, const uint32_t groupCountZ, const uint32_t frameInFlight) const
+	{
+		if (_pipeline.GetBindPoint() != vk::PipelineBindPoint::eCompute) { ErrorHandler::ThrowRuntimeError("Only compute shaders can be dispatched!"); }
+
+		BindGlobal(commandBuffer, frameInFlight);
+		Bind(commandBuffer, frameInFlight);
+
+		commandBuffer.dispatch(groupCountX, groupCountY, groupCountZ);
+	}
+
 	Shader::Properties& Shader::GetProperties() { return _shaderProperties; }
 
 	Shader::Properties& Shader::GetGlobalProperties() { return _globalProperties; }
@@ -171,13 +243,37 @@ namespace SplitEngine::Rendering
 		if (descriptor->SharedID != -1) { SetSharedWriteDescriptorsDirty(descriptor, frameInFlight); }
 	}
 
+	void Shader::Properties::SetDynamicOffset(const uint32_t bindingPoint, const uint32_t offset)
+	{
+		const std::vector<uint32_t>& lookup = _descriptorSetAllocation->SparseDynamicOffsetLookup;
+
+		const uint32_t index = bindingPoint < lookup.size() ? lookup[bindingPoint] : -1u;
+		if (index == -1u) { ErrorHandler::ThrowRuntimeError(std::format("Binding {0} is not a dynamic buffer", bindingPoint)); }
+
+		_descriptorSetAllocation->DynamicOffsets[index] = offset;
+	}
+
 	void Shader::Properties::OverrideBuffer(uint32_t bindingPoint, Vulkan::Buffer&& buffer)
 	{
 		Vulkan::Descriptor* descriptor = GetDescriptor(bindingPoint);
 
-		descriptor->Buffer = std::move(buffer);
+		// Offsets of suballocated descriptors start at their slot in the block, the new buffer starts at 0
+		for (vk::DescriptorBufferInfo& descriptorBufferInfo: descriptor->BufferInfos.GetDataVector())
+		{
+			descriptorBufferInfo.buffer = buffer.GetVkBuffer();
+			descriptorBufferInfo.offset -= descriptor->BlockOffset;
+		}
+
+		_descriptorSetAllocation->FreeBlockRange(*descriptor);
+
+		descriptor->Buffer      = std::move(buffer);
+		descriptor->BlockBuffer = nullptr;
+		descriptor->BlockOffset = 0;
 
-		for (vk::DescriptorBufferInfo& descriptorBufferInfo: descriptor->BufferInfos.GetDataVector()) { descriptorBufferInfo.buffer = descriptor->Buffer.GetVkBuffer(); }
+		// The old pointers point into the released block range
+		std::byte*               mappedData = descriptor->Buffer.GetMappedData<std::byte>();
+		std::vector<std::byte*>& bytes      = descriptor->BufferPtrs.GetDataVector();
+		for (int i = 0; i < bytes.size(); ++i) { bytes[i] = mappedData != nullptr ? mappedData + descriptor->BufferInfos[i].offset : nullptr; }
 
 		SetWriteDescriptorSetDirty(bindingPoint);
 
@@ -190,10 +286,14 @@ namespace SplitEngine::Rendering
 
 		std::vector<std::byte*>& bytes = descriptor->BufferPtrs.GetDataVector();
 
-		for (int i = 0; i < bytes.size(); ++i) { bytes[i] = buffer.GetMappedData<std::byte>() + descriptor->BufferInfos[i].offset; }
+		for (int i = 0; i < bytes.size(); ++i) { bytes[i] = buffer.GetMappedData<std::byte>() + (descriptor->BufferInfos[i].offset - descriptor->BlockOffset); }
 	}
 
-	Vulkan::Buffer& Shader::Properties::GetBuffer(uint32_t bindingPoint) const { return GetDescriptor(bindingPoint)->Buffer; }
+	Vulkan::Buffer& Shader::Properties::GetBuffer(uint32_t bindingPoint) const
+	{
+		Vulkan::Descriptor* descriptor = GetDescriptor(bindingPoint);
+		return descriptor->BlockBuffer != nullptr ? *descriptor->BlockBuffer : descriptor->Buffer;
+	}
 
 	const vk::DescriptorBufferInfo& Shader::Properties::GetBufferInfo(const uint32_t bindingPoint, const uint32_t frameInFlight) const
 	{
@@ -253,28 +353,18 @@ namespace SplitEngine::Rendering
 
 	void Shader::Properties::SetWriteDescriptorSetDirty(uint32_t bindingPoint, uint32_t frameInFlight)
 	{
-		const uint32_t      index      = _descriptorSetAllocation->SparseDescriptorLookup[bindingPoint];
-		Vulkan::Descriptor* descriptor = GetDescriptor(bindingPoint);
-		for (int i = 0; i < Vulkan::Device::MAX_FRAMES_IN_FLIGHT; ++i)
-		{
-			if (descriptor->SingleInstance) { _updateWriteDescriptorSets.push_back(_descriptorSetAllocation->WriteDescriptorSets[index][i]); }
-			else
-			{
-				_updateWriteDescriptorSets.push_back(frameInFlight == -1
-					                                     ? _descriptorSetAllocation->WriteDescriptorSets[index].Get()
-					                                     : _descriptorSetAllocation->WriteDescriptorSets[index][frameInFlight]);
-				break;
-			}
-		}
-	}
+		const uint32_t                                    index                = _descriptorSetAllocation->SparseDescriptorLookup[bindingPoint];
+		Vulkan::Descriptor*                               descriptor           = GetDescriptor(bindingPoint);
+		Vulkan::InFlightResource<vk::WriteDescriptorSet>& writeDescriptorSets  = _descriptorSetAllocation->WriteDescriptorSets[index];
+		Vulkan::DescriptorWriteBatch&                     descriptorWriteBatch = Vulkan::Instance::Get().GetDescriptorWriteBatch();
 
-	void Shader::Properties::Update()
-	{
-		if (!_updateWriteDescriptorSets.empty())
+		// Single instance descriptors are shared by the sets of every frame in flight
+		if (descriptor->SingleInstance)
 		{
-			Vulkan::Instance::Get().GetPhysicalDevice().GetDevice().GetVkDevice().updateDescriptorSets(_updateWriteDescriptorSets, nullptr);
+			for (const vk::WriteDescriptorSet& writeDescriptorSet: writeDescriptorSets.GetDataVector()) { descriptorWriteBatch.Add(writeDescriptorSet, _descriptorSetAllocation->UpdateTemplate); }
 		}
-
-		_updateWriteDescriptorSets.clear();
+		else { descriptorWriteBatch.Add(frameInFlight == -1 ? writeDescriptorSets.Get() : writeDescriptorSets[frameInFlight], _descriptorSetAllocation->UpdateTemplate); }
 	}
+
+	void Shader::Properties::Update() { Vulkan::Instance::Get().GetDescriptorWriteBatch().Flush(); }
 }
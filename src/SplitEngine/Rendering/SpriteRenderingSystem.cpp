@@ -0,0 +1,130 @@
+#include "SplitEngine/Rendering/SpriteRenderingSystem.hpp"
+
+#include "SplitEngine/Contexts.hpp"
+#include "SplitEngine/Rendering/Material.hpp"
+#include "SplitEngine/Rendering/Renderer.hpp"
+#include "SplitEngine/Rendering/Shader.hpp"
+#include "SplitEngine/Rendering/Vulkan/BufferFactory.hpp"
+#include "SplitEngine/Rendering/Vulkan/Instance.hpp"
+
+#include <bit>
+
+namespace SplitEngine::Rendering
+{
+	SpriteRenderingSystem::SpriteRenderingSystem(const uint32_t instanceBufferBindingPoint) :
+		_instanceBufferBindingPoint(instanceBufferBindingPoint),
+		_instanceBuffers(Vulkan::Instance::Get().GetPhysicalDevice().GetDevice().CreateInFlightResource<Vulkan::Buffer>()) {}
+
+	void SpriteRenderingSystem::ExecuteArchetypes(std::vector<ECS::Archetype*>& archetypes, ECS::ContextProvider& contextProvider, uint8_t stage)
+	{
+		Renderer* renderer = contextProvider.GetContext<RenderingContext>()->Renderer;
+		if (renderer->WasSkipped()) { return; }
+
+		_batches.clear();
+		_batchLookup.clear();
+		_spriteBatchIndices.clear();
+
+		// Count instances per batch, the last batch is cached since neighbouring sprites usually share material and page
+		Material* lastMaterial   = nullptr;
+		uint32_t  lastPageIndex  = -1u;
+		uint32_t  lastBatchIndex = -1u;
+
+		for (ECS::Archetype* archetype: archetypes)
+		{
+			Sprite*      sprites    = archetype->GetComponents<Sprite>();
+			const size_t numSprites = archetype->Entities.size();
+
+			for (size_t i = 0; i < numSprites; ++i)
+			{
+				Material*      material  = sprites[i].Material.Get();
+				const uint32_t pageIndex = sprites[i].PackingInfo.PageIndex;
+
+				if (material != lastMaterial || pageIndex != lastPageIndex)
+				{
+					auto [it, inserted] = _batchLookup.try_emplace({ material, pageIndex }, static_cast<uint32_t>(_batches.size()));
+					if (inserted) { _batches.push_back({ material->GetShader().Get(), material, pageIndex, 0, 0 }); }
+
+					lastMaterial   = material;
+					lastPageIndex  = pageIndex;
+					lastBatchIndex = it->second;
+				}
+
+				_batches[lastBatchIndex].NumInstances++;
+				_spriteBatchIndices.push_back(lastBatchIndex);
+			}
+		}
+
+		if (_spriteBatchIndices.empty()) { return; }
+
+		_batchWriteCursors.resize(_batches.size());
+
+		uint32_t firstInstance = 0;
+		for (uint32_t batchIndex = 0; batchIndex < _batches.size(); ++batchIndex)
+		{
+			_batches[batchIndex].FirstInstance = firstInstance;
+			_batchWriteCursors[batchIndex]     = firstInstance;
+
+			firstInstance += _batches[batchIndex].NumInstances;
+		}
+
+		// Write instances directly into the mapped buffer, sorted by batch
+		Vulkan::Buffer& instanceBuffer = GetInstanceBuffer(_spriteBatchIndices.size());
+		SpriteInstance* instances      = instanceBuffer.GetMappedData<SpriteInstance>();
+
+		size_t spriteIndex = 0;
+		for (ECS::Archetype* archetype: archetypes)
+		{
+			const SpriteTransform* transforms = archetype->GetComponents<SpriteTransform>();
+			const Sprite*          sprites    = archetype->GetComponents<Sprite>();
+			const size_t           numSprites = archetype->Entities.size();
+
+			for (size_t i = 0; i < numSprites; ++i, ++spriteIndex)
+			{
+				const SpriteTransform&                 transform   = transforms[i];
+				const Tools::ImagePacker::PackingInfo& packingInfo = sprites[i].PackingInfo;
+
+				SpriteInstance& instance = instances[_batchWriteCursors[_spriteBatchIndices[spriteIndex]]++];
+				instance.Position        = transform.Position;
+				instance.Rotation        = transform.Rotation;
+				instance.Size            = glm::vec2(packingInfo.Size) * transform.Scale;
+				instance.PageIndex       = packingInfo.PageIndex;
+				instance.UVTopLeft       = packingInfo.UVTopLeft;
+				instance.UVBottomRight   = packingInfo.UVBottomRight;
+				instance.Color           = sprites[i].Color;
+			}
+		}
+
+		instanceBuffer.Flush(0, _spriteBatchIndices.size() * sizeof(SpriteInstance));
+
+		// Submit draws, the render queue takes care of ordering them so pipelines and materials only get bound when they actually change
+		RenderQueue& renderQueue = renderer->GetRenderQueue();
+
+		for (const Batch& batch: _batches)
+		{
+			// Only touch the descriptor if the instance buffer of this frame changed since the last time the shader was drawn
+			Shader::Properties& properties = batch.Shader->GetProperties();
+			if (properties.GetBufferInfo(_instanceBufferBindingPoint).buffer != instanceBuffer.GetVkBuffer())
+			{
+				properties.SetBuffer(_instanceBufferBindingPoint, instanceBuffer, 0, instanceBuffer.GetSizeInBytes());
+			}
+
+			renderQueue.Submit({ batch.Shader, batch.Material, nullptr, 6, batch.NumInstances, batch.FirstInstance });
+		}
+	}
+
+	void SpriteRenderingSystem::Destroy(ECS::ContextProvider& contextProvider) { for (Vulkan::Buffer& instanceBuffer: _instanceBuffers.GetDataVector()) { instanceBuffer.Destroy(); } }
+
+	Vulkan::Buffer& SpriteRenderingSystem::GetInstanceBuffer(const size_t numInstances)
+	{
+		Vulkan::Buffer& instanceBuffer = _instanceBuffers.Get();
+
+		const vk::DeviceSize requiredSizeInBytes = numInstances * sizeof(SpriteInstance);
+		if (instanceBuffer.GetVkBuffer() != VK_NULL_HANDLE && instanceBuffer.GetSizeInBytes() >= requiredSizeInBytes) { return instanceBuffer; }
+
+		// The fence of this frame has already been waited on during BeginRendering so the old buffer is no longer in use
+		instanceBuffer.Destroy();
+		instanceBuffer = Vulkan::BufferFactory::CreateStorageBuffer(&Vulkan::Instance::Get().GetPhysicalDevice().GetDevice(), std::bit_ceil(numInstances) * sizeof(SpriteInstance));
+
+		return instanceBuffer;
+	}
+}
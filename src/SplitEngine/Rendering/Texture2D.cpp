@@ -1,6 +1,8 @@
 #include "SplitEngine/Rendering/Texture2D.hpp"
 
+#include "SplitEngine/ErrorHandler.hpp"
 #include "SplitEngine/Rendering/Vulkan/Instance.hpp"
+#include "SplitEngine/Rendering/Vulkan/PhysicalDevice.hpp"
 
 namespace SplitEngine::Rendering
 {
@@ -8,20 +10,77 @@ namespace SplitEngine::Rendering
 		_ioImage(createInfo.IoImage),
 		_vulkanImage(Vulkan::Image(&Vulkan::Instance::Get().GetPhysicalDevice().GetDevice(),
 		                           _ioImage.Pixels.data(),
-		                           _ioImage.Width * _ioImage.Height * _ioImage.Channels,
+		                           _ioImage.Pixels.size(),
 		                           { _ioImage.Width, _ioImage.Height, 1 },
-		                           { .Format = GetVulkanFormat(_ioImage) })),
+		                           {
+			                           .Format          = GetVulkanFormat(_ioImage),
+			                           .MipLevels       = ShouldGenerateMipmaps(createInfo) ? Vulkan::Image::FULL_MIP_CHAIN : _ioImage.MipLevels,
+			                           .GenerateMipmaps = ShouldGenerateMipmaps(createInfo)
+		                           })),
 		_sampler(Vulkan::Instance::Get().GetAllocator().AllocateSampler(createInfo.TextureSettings)),
-		_textureSettings(createInfo.TextureSettings) {}
+		_textureSettings(createInfo.TextureSettings)
+	{
+		_bindlessIndex = Vulkan::Instance::Get().GetBindlessTextureTable().Register(vk::DescriptorImageInfo(*_sampler, _vulkanImage.GetView(), _vulkanImage.GetLayout()));
+	}
 
-	Texture2D::~Texture2D() { _vulkanImage.Destroy(); }
+	Texture2D::~Texture2D()
+	{
+		Vulkan::Instance::Get().GetBindlessTextureTable().Unregister(_bindlessIndex);
+		_vulkanImage.Destroy();
+	}
 
 	const Vulkan::Image& Texture2D::GetImage() const { return _vulkanImage; }
 
 	const vk::Sampler* Texture2D::GetSampler() const { return _sampler; }
 
+	uint32_t Texture2D::GetBindlessIndex() const { return _bindlessIndex; }
+
+	bool Texture2D::IsSupported(const IO::Image::BlockCompression compression)
+	{
+		if (compression == IO::Image::BlockCompression::None) { return true; }
+
+		// The sRGB and UNORM variants of a compression are always supported together
+		const vk::FormatProperties formatProperties = Vulkan::Instance::Get().GetPhysicalDevice().GetVkPhysicalDevice().getFormatProperties(GetVulkanFormat(compression, true));
+
+		return static_cast<bool>(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage);
+	}
+
+	std::filesystem::path Texture2D::SelectSupportedImage(const std::vector<std::filesystem::path>& candidates)
+	{
+		for (const std::filesystem::path& candidate: candidates) { if (IsSupported(IO::ImageLoader::ReadBlockCompression(candidate))) { return candidate; } }
+
+		return candidates.empty() ? std::filesystem::path() : candidates.back();
+	}
+
+	bool Texture2D::ShouldGenerateMipmaps(const CreateInfo& createInfo)
+	{
+		return createInfo.GenerateMipmaps && createInfo.IoImage.MipLevels == 1 && createInfo.IoImage.Compression == IO::Image::BlockCompression::None;
+	}
+
+	vk::Format Texture2D::GetVulkanFormat(const IO::Image::BlockCompression compression, const bool srgb)
+	{
+		switch (compression)
+		{
+			case IO::Image::BlockCompression::BC1:
+				return srgb ? vk::Format::eBc1RgbaSrgbBlock : vk::Format::eBc1RgbaUnormBlock;
+			case IO::Image::BlockCompression::BC7:
+				return srgb ? vk::Format::eBc7SrgbBlock : vk::Format::eBc7UnormBlock;
+			case IO::Image::BlockCompression::ASTC4x4:
+				return srgb ? vk::Format::eAstc4x4SrgbBlock : vk::Format::eAstc4x4UnormBlock;
+			default:
+				return vk::Format::eUndefined;
+		}
+	}
+
 	vk::Format Texture2D::GetVulkanFormat(const IO::Image& image)
 	{
+		if (image.Compression != IO::Image::BlockCompression::None)
+		{
+			if (!IsSupported(image.Compression)) { ErrorHandler::ThrowRuntimeError("Device doesn't support the block compression of the texture, use SelectSupportedImage to pick a fallback"); }
+
+			return GetVulkanFormat(image.Compression, image.Srgb);
+		}
+
 		vk::Format format{};
 		switch (image.Channels)
 		{
@@ -32,10 +91,10 @@ namespace SplitEngine::Rendering
 				format = vk::Format::eR8G8Unorm;
 				break;
 			case 4:
-				format = vk::Format::eR8G8B8A8Srgb;
+				format = image.Srgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm;
 				break;
 			default:
-				format = vk::Format::eR8G8B8A8Srgb;
+				format = image.Srgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm;
 		}
 
 		return format;
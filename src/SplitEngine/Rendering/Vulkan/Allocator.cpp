@@ -4,6 +4,8 @@
 #include "SplitEngine/Rendering/Vulkan/Device.hpp"
 #include "SplitEngine/Rendering/Vulkan/Instance.hpp"
 
+#include <algorithm>
+
 namespace SplitEngine::Rendering::Vulkan
 {
 	Allocator::Allocator(const Instance& instance):
@@ -16,7 +18,202 @@ namespace SplitEngine::Rendering::Vulkan
 		vmaAllocatorCreateInfo.physicalDevice         = instance.GetPhysicalDevice().GetVkPhysicalDevice();
 		vmaAllocatorCreateInfo.instance               = instance.GetVkInstance();
 
+		// Without the extension VMA estimates the budget from the heap sizes and only knows about its own allocations
+		if (instance.GetPhysicalDevice().IsExtensionEnabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) { vmaAllocatorCreateInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT; }
+
 		vmaCreateAllocator(&vmaAllocatorCreateInfo, &_vmaAllocator);
+
+		UpdateHeapStatistics();
+	}
+
+	void Allocator::Update(const bool canDefragment)
+	{
+		vmaSetCurrentFrameIndex(_vmaAllocator, ++_frameIndex);
+
+		UpdateHeapStatistics();
+
+		const RenderingSettings& renderingSettings = _instance.GetRenderingSettings();
+		if (renderingSettings.DefragmentationThresholdInBytes == 0) { return; }
+
+		_framesSinceDefragmentationPass++;
+		if (!canDefragment || _framesSinceDefragmentationPass < renderingSettings.DefragmentationPassInterval) { return; }
+
+		if (_defragmentationContext == nullptr)
+		{
+			// Allocations that can't be moved keep some of the space unused, so only what was added since the last defragmentation counts
+			const uint64_t unusedBytes = GetUnusedBytes();
+			_unusedBytesAfterDefragmentation = std::min(_unusedBytesAfterDefragmentation, unusedBytes);
+
+			if (unusedBytes < _unusedBytesAfterDefragmentation + renderingSettings.DefragmentationThresholdInBytes) { return; }
+
+			VmaDefragmentationInfo defragmentationInfo = VmaDefragmentationInfo();
+			defragmentationInfo.flags                  = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+			defragmentationInfo.maxBytesPerPass        = renderingSettings.DefragmentationBytesPerPass;
+
+			if (vmaBeginDefragmentation(_vmaAllocator, &defragmentationInfo, &_defragmentationContext) != VK_SUCCESS)
+			{
+				_defragmentationContext = nullptr;
+				return;
+			}
+
+			LOG("Starting defragmentation, {0} bytes of device memory are allocated but unused", unusedBytes);
+		}
+
+		{
+			// Mesh blocks get swapped out during the pass, so no model may allocate and record an upload into them until it's done.
+			// The arena locks before the upload manager when allocating, so they're taken in the same order here
+			std::unique_lock<std::mutex>           meshArenaLock     = _instance.GetMeshArena().Lock();
+			std::unique_lock<std::recursive_mutex> uploadManagerLock = _instance.GetUploadManager().Lock();
+
+			// Something could have been uploaded since the caller checked
+			if (!_instance.GetUploadManager().IsIdle()) { return; }
+
+			RunDefragmentationPass();
+		}
+
+		_framesSinceDefragmentationPass = 0;
+	}
+
+	void Allocator::UpdateHeapStatistics()
+	{
+		const vk::PhysicalDeviceMemoryProperties& memoryProperties = _instance.GetPhysicalDevice().GetDevice().GetMemoryProperties();
+
+		_budgets.resize(memoryProperties.memoryHeapCount);
+		_heapStatistics.resize(memoryProperties.memoryHeapCount);
+		_heapWarningLevels.resize(memoryProperties.memoryHeapCount, 0);
+
+		vmaGetHeapBudgets(_vmaAllocator, _budgets.data());
+
+		const std::vector<float>& warningThresholds = _instance.GetRenderingSettings().MemoryBudgetWarningThresholds;
+
+		for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i)
+		{
+			const VmaBudget&         budget         = _budgets[i];
+			GpuMemoryHeapStatistics& heapStatistics = _heapStatistics[i];
+
+			heapStatistics.UsageInBytes     = budget.usage;
+			heapStatistics.BudgetInBytes    = budget.budget;
+			heapStatistics.ReservedInBytes  = budget.statistics.blockBytes;
+			heapStatistics.AllocatedInBytes = budget.statistics.allocationBytes;
+			heapStatistics.DeviceLocal      = static_cast<bool>(memoryProperties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+
+			const float  usage        = budget.budget > 0 ? static_cast<float>(budget.usage) / static_cast<float>(budget.budget) : 0.0f;
+			const size_t warningLevel = std::ranges::count_if(warningThresholds, [usage](const float threshold) { return usage >= threshold; });
+
+			if (warningLevel > _heapWarningLevels[i])
+			{
+				LOG_WARNING("Memory heap {0} uses {1} of its {2} byte budget ({3:.0f}%)", i, budget.usage, budget.budget, usage * 100.0f);
+			}
+
+			_heapWarningLevels[i] = warningLevel;
+		}
+	}
+
+	void Allocator::RunDefragmentationPass()
+	{
+		VmaDefragmentationPassMoveInfo passInfo = VmaDefragmentationPassMoveInfo();
+		if (vmaBeginDefragmentationPass(_vmaAllocator, _defragmentationContext, &passInfo) == VK_SUCCESS)
+		{
+			EndDefragmentation();
+			return;
+		}
+
+		Device&           device   = _instance.GetPhysicalDevice().GetDevice();
+		const vk::Device& vkDevice = device.GetVkDevice();
+
+		std::lock_guard<std::mutex> lock(_movableBufferMutex);
+
+		std::vector<MovableBuffer*> movedBuffers{};
+
+		for (uint32_t i = 0; i < passInfo.moveCount; ++i)
+		{
+			VmaDefragmentationMove& move = passInfo.pMoves[i];
+
+			// Everything else might be referenced by descriptors, image views or framebuffers that would all need to be recreated
+			const auto it = _movableBuffers.find(move.srcAllocation);
+			if (it == _movableBuffers.end()) { move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE; }
+			else { movedBuffers.push_back(&it->second); }
+		}
+
+		// Nothing to copy, so there is no need to wait for the gpu either
+		if (!movedBuffers.empty())
+		{
+			QueueFamily&            graphicsQueueFamily = device.GetQueueFamily(QueueType::Graphics);
+			const vk::CommandBuffer commandBuffer       = graphicsQueueFamily.BeginOneshotCommands();
+
+			// Buffers that are about to be copied might still be written by earlier submissions
+			const vk::MemoryBarrier memoryBarrier = vk::MemoryBarrier(vk::AccessFlagBits::eMemoryWrite, vk::AccessFlagBits::eTransferRead);
+			commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, memoryBarrier, nullptr, nullptr);
+
+			std::vector<vk::Buffer> oldBuffers{};
+			oldBuffers.reserve(movedBuffers.size());
+
+			size_t movedBufferIndex = 0;
+			for (uint32_t i = 0; i < passInfo.moveCount; ++i)
+			{
+				const VmaDefragmentationMove& move = passInfo.pMoves[i];
+				if (move.operation == VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE) { continue; }
+
+				const MovableBuffer& movableBuffer = *movedBuffers[movedBufferIndex++];
+
+				const vk::Buffer newBuffer = vkDevice.createBuffer(movableBuffer.CreateInfo);
+				vmaBindBufferMemory(_vmaAllocator, move.dstTmpAllocation, newBuffer);
+
+				const vk::BufferCopy copyRegion = vk::BufferCopy(0, 0, movableBuffer.CreateInfo.size);
+				commandBuffer.copyBuffer(movableBuffer.Allocation->Buffer, newBuffer, 1, &copyRegion);
+
+				oldBuffers.push_back(movableBuffer.Allocation->Buffer);
+				movableBuffer.Allocation->Buffer = newBuffer;
+			}
+
+			// Waits for the copies and every frame still in flight, so nothing uses the old buffers anymore
+			graphicsQueueFamily.EndOneshotCommands();
+
+			for (const vk::Buffer& oldBuffer: oldBuffers) { vkDevice.destroy(oldBuffer); }
+		}
+
+		const VkResult result = vmaEndDefragmentationPass(_vmaAllocator, _defragmentationContext, &passInfo);
+
+		// Persistently mapped allocations get mapped again at their new place
+		for (const MovableBuffer* movedBuffer: movedBuffers)
+		{
+			VmaAllocationInfo allocationInfo;
+			vmaGetAllocationInfo(_vmaAllocator, movedBuffer->Allocation->VmaAllocation, &allocationInfo);
+
+			movedBuffer->Allocation->AllocationInfo.MappedData = allocationInfo.pMappedData;
+		}
+
+		if (result != VK_INCOMPLETE) { EndDefragmentation(); }
+	}
+
+	void Allocator::EndDefragmentation()
+	{
+		VmaDefragmentationStats defragmentationStats = VmaDefragmentationStats();
+		vmaEndDefragmentation(_vmaAllocator, _defragmentationContext, &defragmentationStats);
+
+		_defragmentationContext = nullptr;
+
+		UpdateHeapStatistics();
+		_unusedBytesAfterDefragmentation = GetUnusedBytes();
+
+		LOG("Finished defragmentation, moved {0} bytes and freed {1} bytes", defragmentationStats.bytesMoved, defragmentationStats.bytesFreed);
+	}
+
+	uint64_t Allocator::GetUnusedBytes() const
+	{
+		uint64_t unusedBytes = 0;
+		for (const GpuMemoryHeapStatistics& heapStatistics: _heapStatistics) { unusedBytes += heapStatistics.ReservedInBytes - heapStatistics.AllocatedInBytes; }
+
+		return unusedBytes;
+	}
+
+	const std::vector<GpuMemoryHeapStatistics>& Allocator::GetMemoryHeapStatistics() const { return _heapStatistics; }
+
+	void Allocator::EnableDefragmentation(BufferAllocation& bufferAllocation, const vk::BufferCreateInfo& bufferCreateInfo)
+	{
+		std::lock_guard<std::mutex> lock(_movableBufferMutex);
+
+		_movableBuffers[bufferAllocation.VmaAllocation] = { &bufferAllocation, bufferCreateInfo };
 	}
 
 	Allocator::BufferAllocation Allocator::CreateBuffer(const vk::BufferCreateInfo& bufferCreateInfo, const Allocator::MemoryAllocationCreateInfo& memoryAllocationCreateInfo)
@@ -65,6 +262,11 @@ namespace SplitEngine::Rendering::Vulkan
 	{
 		if (bufferAllocation.Buffer != VK_NULL_HANDLE)
 		{
+			{
+				std::lock_guard<std::mutex> lock(_movableBufferMutex);
+				_movableBuffers.erase(bufferAllocation.VmaAllocation);
+			}
+
 			vmaDestroyBuffer(_vmaAllocator, bufferAllocation.Buffer, bufferAllocation.VmaAllocation);
 			_buffersAllocated--;
 		}
@@ -92,6 +294,8 @@ namespace SplitEngine::Rendering::Vulkan
 		LOG("Leaked buffers {0}", _buffersAllocated);
 		LOG("Leaked images {0}", _imagesAllocated);
 
+		if (_defragmentationContext != nullptr) { EndDefragmentation(); }
+
 		vmaDestroyAllocator(_vmaAllocator);
 	}
 
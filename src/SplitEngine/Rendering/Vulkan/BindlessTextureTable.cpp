@@ -0,0 +1,143 @@
+#include "SplitEngine/Rendering/Vulkan/BindlessTextureTable.hpp"
+
+#include "SplitEngine/Debug/Log.hpp"
+#include "SplitEngine/Rendering/Vulkan/Device.hpp"
+#include "SplitEngine/Rendering/Vulkan/PhysicalDevice.hpp"
+
+#include <algorithm>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	BindlessTextureTable::BindlessTextureTable(Device* device, const uint32_t maxTextures) :
+		DeviceObject(device),
+		_isSupported(device->SupportsBindlessTextures())
+	{
+		if (!_isSupported)
+		{
+			LOG_WARNING("Device doesn't support descriptor indexing, bindless textures are disabled");
+			return;
+		}
+
+		const auto properties = device->GetPhysicalDevice().GetVkPhysicalDevice().getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceDescriptorIndexingProperties>();
+		const vk::PhysicalDeviceDescriptorIndexingProperties& descriptorIndexingProperties = properties.get<vk::PhysicalDeviceDescriptorIndexingProperties>();
+
+		_capacity = std::min({ maxTextures,
+		                       descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+		                       descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+		                       descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers });
+
+		if (_capacity < maxTextures) { LOG_WARNING("Bindless texture table was limited to {0} textures by the device", _capacity); }
+
+		_imageInfos.resize(_capacity);
+		_retiredIndices = device->CreateInFlightResource<std::vector<uint32_t>>();
+		_pendingWrites  = device->CreateInFlightResource<std::vector<uint32_t>>();
+	}
+
+	uint32_t BindlessTextureTable::Register(const vk::DescriptorImageInfo& imageInfo)
+	{
+		if (!_isSupported) { return -1u; }
+
+		uint32_t index;
+		if (!_freeIndices.empty())
+		{
+			index = _freeIndices.back();
+			_freeIndices.pop_back();
+		}
+		else
+		{
+			if (_nextIndex == _capacity)
+			{
+				LOG_WARNING("Bindless texture table is full ({0} textures)", _capacity);
+				return -1u;
+			}
+
+			index = _nextIndex++;
+		}
+
+		_imageInfos[index] = imageInfo;
+
+		QueueWrites(index, 1);
+
+		return index;
+	}
+
+	void BindlessTextureTable::Unregister(const uint32_t index)
+	{
+		if (index == -1u) { return; }
+
+		_imageInfos[index] = vk::DescriptorImageInfo();
+		_unregisteredIndices.push_back(index);
+	}
+
+	void BindlessTextureTable::Update()
+	{
+		if (!_isSupported) { return; }
+
+		std::vector<uint32_t>& retiredIndices = _retiredIndices.Get();
+
+		_freeIndices.insert(_freeIndices.end(), retiredIndices.begin(), retiredIndices.end());
+
+		retiredIndices.swap(_unregisteredIndices);
+		_unregisteredIndices.clear();
+
+		_isCurrentFrameWritable = true;
+		FlushPendingWrites();
+	}
+
+	void BindlessTextureTable::EndFrame() { _isCurrentFrameWritable = false; }
+
+	void BindlessTextureTable::Attach(const std::vector<vk::DescriptorSet>& descriptorSets, const uint32_t binding)
+	{
+		_descriptorSets = GetDevice()->CreateInFlightResource<vk::DescriptorSet>(std::vector<vk::DescriptorSet>(descriptorSets));
+		_binding        = binding;
+
+		QueueWrites(0, _nextIndex);
+	}
+
+	bool BindlessTextureTable::IsSupported() const { return _isSupported; }
+
+	uint32_t BindlessTextureTable::GetCapacity() const { return _capacity; }
+
+	void BindlessTextureTable::Destroy()
+	{
+		_descriptorSets = {};
+		_freeIndices.clear();
+		_unregisteredIndices.clear();
+	}
+
+	void BindlessTextureTable::QueueWrites(const uint32_t firstIndex, const uint32_t count)
+	{
+		// Everything registered so far gets queued once the sets are attached
+		if (!_descriptorSets.IsValid() || count == 0) { return; }
+
+		for (uint32_t frameIndex = 0; frameIndex < GetDevice()->GetNumFramesInFlight(); ++frameIndex)
+		{
+			std::vector<uint32_t>& pendingWrites = _pendingWrites[frameIndex];
+			for (uint32_t index = firstIndex; index < firstIndex + count; ++index) { pendingWrites.push_back(index); }
+		}
+
+		if (_isCurrentFrameWritable) { FlushPendingWrites(); }
+	}
+
+	void BindlessTextureTable::FlushPendingWrites()
+	{
+		std::vector<uint32_t>& pendingWrites = _pendingWrites.Get();
+		if (!_descriptorSets.IsValid() || pendingWrites.empty()) { return; }
+
+		std::vector<vk::WriteDescriptorSet> writeDescriptorSets{};
+		writeDescriptorSets.reserve(pendingWrites.size());
+
+		// Entries without an image (freed or never used) are skipped, the binding is partially bound so they can just stay stale.
+		// An index that got reused before the write happened is written with whatever image it holds now.
+		for (const uint32_t index: pendingWrites)
+		{
+			if (_imageInfos[index].imageView == VK_NULL_HANDLE) { continue; }
+
+			writeDescriptorSets.emplace_back(_descriptorSets.Get(), _binding, index, 1, vk::DescriptorType::eCombinedImageSampler, &_imageInfos[index]);
+		}
+
+		if (!writeDescriptorSets.empty()) { GetDevice()->GetVkDevice().updateDescriptorSets(writeDescriptorSets, nullptr); }
+
+		pendingWrites.clear();
+	}
+}
@@ -93,6 +93,9 @@ namespace SplitEngine::Rendering::Vulkan
 	                          const Allocator::MemoryAllocationCreateInfo allocationCreateInfo,
 	                          const char* const*                          data) -> void
 	{
+		_usage       = usage;
+		_sharingMode = sharingMode;
+
 		const vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo({}, _bufferSize, usage, sharingMode);
 
 		_bufferAllocation = GetDevice()->GetPhysicalDevice().GetInstance().GetAllocator().CreateBuffer(bufferCreateInfo, allocationCreateInfo);
@@ -168,10 +171,23 @@ namespace SplitEngine::Rendering::Vulkan
 
 	void Buffer::Stage(const char** data) const
 	{
-		Buffer stagingBuffer = Buffer(GetDevice(), vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive, { Allocator::CpuOnly, }, data, *this);
+		UploadManager& uploadManager = GetDevice()->GetPhysicalDevice().GetInstance().GetUploadManager();
+
+		UploadManager::Ticket ticket{};
+		for (int i = 0; i < _subBuffers.size(); i++)
+		{
+			if (data[i] == nullptr) { continue; }
+
+			ticket = uploadManager.UploadBuffer(*this, reinterpret_cast<const std::byte*>(data[i]), _subBuffers[i].SizeInBytes, _subBuffers[i].OffsetInBytes);
+		}
+
+		// Staged buffers are expected to be usable without polling, so the frame waits for the batch before it's submitted instead of every call blocking on its own copy
+		uploadManager.RequireForFrame(ticket);
+	}
 
-		stagingBuffer.Copy(*this);
-		stagingBuffer.Destroy();
+	void Buffer::EnableDefragmentation()
+	{
+		GetDevice()->GetPhysicalDevice().GetInstance().GetAllocator().EnableDefragmentation(_bufferAllocation, vk::BufferCreateInfo({}, _bufferSize, _usage, _sharingMode));
 	}
 
 	void* Buffer::GetMappedData() const { return _bufferAllocation.AllocationInfo.MappedData; }
@@ -4,13 +4,15 @@
 
 namespace SplitEngine::Rendering::Vulkan
 {
-	CommandBuffer::CommandBuffer(Device* device, QueueType type, InFlightResource<vk::CommandBuffer>&& commandBuffers):
+	CommandBuffer::CommandBuffer(Device* device, QueueType type, InFlightResource<vk::CommandBuffer>&& commandBuffers, vk::CommandPool commandPool):
 		DeviceObject(device),
 		_commandBuffers(std::move(commandBuffers)),
-		_queueType(type) {}
+		_queueType(type),
+		_commandPool(commandPool) {}
 
 	vk::CommandBuffer&                   CommandBuffer::GetVkCommandBuffer(const uint32_t fifIndex) { return fifIndex == -1 ? _commandBuffers.Get() : _commandBuffers[fifIndex]; }
 	InFlightResource<vk::CommandBuffer>& CommandBuffer::GetVkCommandBufferRaw() { return _commandBuffers; }
+	const vk::CommandPool&               CommandBuffer::GetCommandPool() const { return _commandPool; }
 
 	void CommandBuffer::Destroy() { GetDevice()->GetQueueFamily(_queueType).DeallocateCommandBuffer(*this); }
 }
@@ -0,0 +1,92 @@
+#include "SplitEngine/Rendering/Vulkan/DescriptorBufferArena.hpp"
+
+#include "SplitEngine/Rendering/Vulkan/Device.hpp"
+
+#include <algorithm>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	DescriptorBufferArena::DescriptorBufferArena(Device* device, const vk::DeviceSize blockSizeInBytes) :
+		DeviceObject(device),
+		_blockSizeInBytes(blockSizeInBytes),
+		_retiredRanges(device->CreateInFlightResource<std::vector<Range>>()) {}
+
+	DescriptorBufferArena::Range DescriptorBufferArena::Allocate(const vk::BufferUsageFlags                   usage,
+	                                                             const Allocator::MemoryAllocationCreateInfo& allocationCreateInfo,
+	                                                             const vk::DeviceSize                         sizeInBytes,
+	                                                             const vk::DeviceSize                         alignment)
+	{
+		// Materials can be created while pipelines are built on worker threads
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		const uint32_t poolIndex = GetPoolIndex(usage, allocationCreateInfo);
+		Pool&          pool      = _pools[poolIndex];
+
+		vk::DeviceSize offsetInBytes = 0;
+		for (uint32_t blockIndex = 0; blockIndex < pool.Blocks.size(); ++blockIndex)
+		{
+			Block& block = pool.Blocks[blockIndex];
+			// First fit, blocks only ever hold a handful of different sizes so this doesn't fragment much
+			if (block.FreeRanges.TryAllocate(sizeInBytes, alignment, offsetInBytes)) { return { &block.Buffer, offsetInBytes, sizeInBytes, poolIndex, blockIndex }; }
+		}
+
+		const vk::DeviceSize blockSizeInBytes = std::max(_blockSizeInBytes, sizeInBytes);
+
+		Block& block = pool.Blocks.emplace_back();
+		block.Buffer = Buffer(GetDevice(), pool.Usage, vk::SharingMode::eExclusive, pool.AllocationCreateInfo, 1u, blockSizeInBytes);
+		block.FreeRanges = FreeRangeList(blockSizeInBytes);
+
+		LOG("Allocated descriptor buffer block {0} of {1} bytes", pool.Blocks.size(), blockSizeInBytes);
+
+		// A fresh block starts at offset 0, which satisfies every alignment
+		static_cast<void>(block.FreeRanges.TryAllocate(sizeInBytes, alignment, offsetInBytes));
+
+		return { &block.Buffer, offsetInBytes, sizeInBytes, poolIndex, static_cast<uint32_t>(pool.Blocks.size() - 1) };
+	}
+
+	void DescriptorBufferArena::Free(const Range& range)
+	{
+		if (range.PoolIndex == -1u) { return; }
+
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_freedRanges.push_back(range);
+	}
+
+	void DescriptorBufferArena::Update()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		// The fence of this frame covers everything submitted before it, so nothing reads these ranges anymore
+		std::vector<Range>& retiredRanges = _retiredRanges.Get();
+		for (const Range& range: retiredRanges) { _pools[range.PoolIndex].Blocks[range.BlockIndex].FreeRanges.Free(range.OffsetInBytes, range.SizeInBytes); }
+
+		retiredRanges.swap(_freedRanges);
+		_freedRanges.clear();
+	}
+
+	uint32_t DescriptorBufferArena::GetPoolIndex(const vk::BufferUsageFlags usage, const Allocator::MemoryAllocationCreateInfo& allocationCreateInfo)
+	{
+		for (uint32_t i = 0; i < _pools.size(); ++i)
+		{
+			const Pool& pool = _pools[i];
+			if (pool.Usage == usage &&
+			    pool.AllocationCreateInfo.Usage == allocationCreateInfo.Usage &&
+			    pool.AllocationCreateInfo.Flags == allocationCreateInfo.Flags &&
+			    pool.AllocationCreateInfo.RequiredFlags == allocationCreateInfo.RequiredFlags) { return i; }
+		}
+
+		_pools.push_back({ usage, allocationCreateInfo });
+
+		return static_cast<uint32_t>(_pools.size() - 1);
+	}
+
+	void DescriptorBufferArena::Destroy()
+	{
+		for (Pool& pool: _pools) { for (Block& block: pool.Blocks) { block.Buffer.Destroy(); } }
+
+		_pools.clear();
+		_freedRanges.clear();
+		_retiredRanges = {};
+	}
+}
@@ -1,10 +1,11 @@
 #include "SplitEngine/Rendering/Vulkan/DescriptorSetAllocator.hpp"
+#include "SplitEngine/ErrorHandler.hpp"
 #include "SplitEngine/Rendering/Vulkan/Buffer.hpp"
 #include "SplitEngine/Rendering/Vulkan/BufferFactory.hpp"
 #include "SplitEngine/Rendering/Vulkan/Device.hpp"
 #include "SplitEngine/Rendering/Vulkan/Utility.hpp"
 
-#include <numeric>
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -13,6 +14,55 @@
 
 namespace SplitEngine::Rendering::Vulkan
 {
+	namespace
+	{
+		vk::BufferUsageFlags GetBufferUsage(const vk::DescriptorType descriptorType, const DescriptorSetAllocator::DescriptorCreateInfo& descriptorCreateInfo)
+		{
+			vk::BufferUsageFlags usage = descriptorType == vk::DescriptorType::eUniformBuffer || descriptorType == vk::DescriptorType::eUniformBufferDynamic
+				                             ? vk::BufferUsageFlagBits::eUniformBuffer
+				                             : vk::BufferUsageFlagBits::eStorageBuffer;
+
+			if (descriptorCreateInfo.TransferSrc) { usage |= vk::BufferUsageFlagBits::eTransferSrc; }
+
+			if (descriptorCreateInfo.TransferDst) { usage |= vk::BufferUsageFlagBits::eTransferDst; }
+
+			return usage;
+		}
+
+		Allocator::MemoryAllocationCreateInfo GetAllocationCreateInfo(const DescriptorSetAllocator::DescriptorCreateInfo& descriptorCreateInfo)
+		{
+			vk::Flags<Allocator::MemoryAllocationCreateFlagBits> flags{};
+			vk::Flags<Allocator::MemoryPropertyFlagBits>         requiredFlags{};
+
+			// Always try to presistent map and be coherant
+			if (!descriptorCreateInfo.DeviceLocal)
+			{
+				flags |= Allocator::PersistentMap;
+				requiredFlags |= Allocator::HostVisible;
+				if (!descriptorCreateInfo.NoCoherant) { requiredFlags |= Allocator::HostCoherant; }
+			}
+
+			if (descriptorCreateInfo.DeviceLocalHostVisible)
+			{
+				requiredFlags |= Allocator::LocalDevice;
+				requiredFlags |= Allocator::HostVisible;
+				flags |= Allocator::WriteSequentially;
+			}
+			else if (descriptorCreateInfo.DeviceLocal) { requiredFlags |= Allocator::LocalDevice; }
+			else
+			{
+				if (descriptorCreateInfo.Cached)
+				{
+					requiredFlags |= Allocator::HostCached;
+					flags |= Allocator::RandomAccess;
+				}
+				else { flags |= Allocator::WriteSequentially; }
+			}
+
+			return { Allocator::Auto, flags, requiredFlags };
+		}
+	}
+
 	std::unordered_map<std::string, Descriptor> DescriptorSetAllocator::_sharedDescriptors = std::unordered_map<std::string, Descriptor>();
 
 	uint32_t DescriptorSetAllocator::_descriptorIdCounter = 0;
@@ -22,76 +72,143 @@ namespace SplitEngine::Rendering::Vulkan
 		_descriptorPoolSizes(std::move(descriptorSetInfo.DescriptorPoolSizes)),
 		_writeDescriptorSets(std::move(descriptorSetInfo.WriteDescriptorSets)),
 		_descriptorCreateInfo(std::move(descriptorSetInfo.DescriptorCreateInfos)),
-		_maxSetsPerPool(maxSetsPerPool * Device::MAX_FRAMES_IN_FLIGHT)
+		_maxSetsPerPool(maxSetsPerPool * GetDevice()->GetNumFramesInFlight())
 	{
-		const vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo({}, descriptorSetInfo.DescriptorLayoutBindings);
-		_descriptorSetLayout                                                  = GetDevice()->GetVkDevice().createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
+		// Bindless bindings get written while the set is in use, which needs the whole layout and pool to be update after bind
+		std::vector<vk::DescriptorBindingFlags> bindingFlags{};
+		bindingFlags.reserve(_descriptorCreateInfo.size());
+		for (const DescriptorCreateInfo& descriptorCreateInfo: _descriptorCreateInfo)
+		{
+			if (descriptorCreateInfo.Bindless)
+			{
+				bindingFlags.push_back(vk::DescriptorBindingFlagBits::ePartiallyBound | vk::DescriptorBindingFlagBits::eUpdateAfterBind);
+				_updateAfterBind = true;
+			}
+			else { bindingFlags.emplace_back(); }
+		}
+
+		const vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo = vk::DescriptorSetLayoutBindingFlagsCreateInfo(bindingFlags);
+
+		const vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo(_updateAfterBind
+			                                                                                                          ? vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool
+			                                                                                                          : vk::DescriptorSetLayoutCreateFlags(),
+		                                                                                                          descriptorSetInfo.DescriptorLayoutBindings,
+		                                                                                                          _updateAfterBind ? &bindingFlagsCreateInfo : nullptr);
+		_descriptorSetLayout = GetDevice()->GetVkDevice().createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
+
+		_updateTemplate = GetDevice()->GetPhysicalDevice().GetInstance().GetDescriptorWriteBatch().CreateUpdateTemplate(_descriptorSetLayout,
+		                                                                                                               descriptorSetInfo.DescriptorLayoutBindings,
+		                                                                                                               _updateAfterBind);
 
 		for (const auto& binding: descriptorSetInfo.Bindings) { _bindings.push_back(binding); }
 
-		_descriptorSetLayouts = std::vector<vk::DescriptorSetLayout>(Device::MAX_FRAMES_IN_FLIGHT, _descriptorSetLayout);
+		for (int i = 0; i < _bindings.size(); ++i) { if (_descriptorCreateInfo[i].Dynamic) { _dynamicBindings.push_back(_bindings[i]); } }
+		std::ranges::sort(_dynamicBindings);
+
+		// A single allocate call can fill a whole pool
+		_descriptorSetLayouts = std::vector<vk::DescriptorSetLayout>(_maxSetsPerPool, _descriptorSetLayout);
+
+		// Pool sizes describe a single allocation, pools need room for every allocation they can hold
+		for (vk::DescriptorPoolSize& descriptorPoolSize: _descriptorPoolSizes) { descriptorPoolSize.descriptorCount *= maxSetsPerPool; }
+
+		// Unique buffers are suballocated from the descriptor buffer arena instead of getting their own buffer
+		_bufferLayoutLookup = std::vector<uint32_t>(_writeDescriptorSets.size(), -1u);
+		for (int i = 0; i < _writeDescriptorSets.size(); ++i)
+		{
+			const DescriptorCreateInfo&   descriptorCreateInfo = _descriptorCreateInfo[i];
+			const vk::WriteDescriptorSet& lastWriteDescriptor  = _writeDescriptorSets[i].back();
+
+			if (!descriptorCreateInfo.Shared) { _numUniqueDescriptors++; }
+
+			if (lastWriteDescriptor.pBufferInfo == nullptr || descriptorCreateInfo.Shared || descriptorCreateInfo.NoAllocation) { continue; }
+
+			const vk::BufferUsageFlags usage        = GetBufferUsage(lastWriteDescriptor.descriptorType, descriptorCreateInfo);
+			const vk::DeviceSize       minAlignment = std::max<vk::DeviceSize>(usage & vk::BufferUsageFlagBits::eUniformBuffer
+				                                                                   ? device->GetPhysicalDevice().GetProperties().limits.minUniformBufferOffsetAlignment
+				                                                                   : device->GetPhysicalDevice().GetProperties().limits.minStorageBufferOffsetAlignment,
+			                                                                   1);
+
+			const uint32_t numSubBuffers = descriptorCreateInfo.SingleInstance ? 1 : GetDevice()->GetNumFramesInFlight();
+
+			BufferLayout bufferLayout{};
+			bufferLayout.Usage                = usage;
+			bufferLayout.AllocationCreateInfo = GetAllocationCreateInfo(descriptorCreateInfo);
+			bufferLayout.SizeInBytes          = lastWriteDescriptor.pBufferInfo->range * numSubBuffers;
+			bufferLayout.Alignment            = minAlignment;
+
+			_bufferLayoutLookup[i] = static_cast<uint32_t>(_bufferLayouts.size());
+			_bufferLayouts.push_back(bufferLayout);
+		}
 
 		AllocateNewDescriptorPool();
+		_currentDescriptorPool = 0;
 	}
 
-	DescriptorSetAllocator::Allocation DescriptorSetAllocator::AllocateDescriptorSet()
+	DescriptorSetAllocator::Allocation DescriptorSetAllocator::AllocateDescriptorSet() { return std::move(AllocateDescriptorSets(1).front()); }
+
+	std::vector<DescriptorSetAllocator::Allocation> DescriptorSetAllocator::AllocateDescriptorSets(const uint32_t count)
 	{
-		// Find pool with available space
-		DescriptorPoolInstance* validDescriptorPoolInstance;
-		uint32_t                descriptorPoolIndex = -1;
-		for (uint32_t i = 0; i < _descriptorPoolInstances.size(); i++)
-		{
-			if (_descriptorPoolInstances[i].Available.GetSize() >= Device::MAX_FRAMES_IN_FLIGHT)
-			{
-				validDescriptorPoolInstance = &_descriptorPoolInstances[i];
-				descriptorPoolIndex         = i;
-				break;
-			}
-		}
+		std::vector<Allocation> descriptorSetAllocations = std::vector<Allocation>(count);
+
+		// Writes of all allocations are collected and submitted in one go
+		std::vector<vk::WriteDescriptorSet> writeDescriptorSets{};
+		writeDescriptorSets.reserve(static_cast<size_t>(count) * _writeDescriptorSets.size() * GetDevice()->GetNumFramesInFlight());
 
-		// Allocate new pool if existing are full
-		if (descriptorPoolIndex == -1)
+		std::vector<vk::DescriptorSet> descriptorSets{};
+
+		uint32_t allocationIndex = 0;
+		while (allocationIndex < count)
 		{
-			AllocateNewDescriptorPool();
-			validDescriptorPoolInstance = &_descriptorPoolInstances.back();
-			descriptorPoolIndex         = _descriptorPoolInstances.size() - 1;
-		}
+			const uint32_t          descriptorPoolIndex    = AcquireDescriptorPool();
+			DescriptorPoolInstance& descriptorPoolInstance = _descriptorPoolInstances[descriptorPoolIndex];
 
+			const uint32_t numAllocations = std::min(count - allocationIndex, (_maxSetsPerPool - descriptorPoolInstance.NumAllocatedSets) / GetDevice()->GetNumFramesInFlight());
+			const uint32_t numSets        = numAllocations * GetDevice()->GetNumFramesInFlight();
 
-		// Allocate descriptor set
-		std::vector<vk::DescriptorSet> descriptorSets            = std::vector<vk::DescriptorSet>(Device::MAX_FRAMES_IN_FLIGHT);
-		vk::DescriptorSetAllocateInfo  descriptorSetAllocateInfo = vk::DescriptorSetAllocateInfo(validDescriptorPoolInstance->DescriptorPool,
-		                                                                                         Device::MAX_FRAMES_IN_FLIGHT,
-		                                                                                         _descriptorSetLayouts.data());
+			descriptorSets.resize(numSets);
+			const vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo = vk::DescriptorSetAllocateInfo(descriptorPoolInstance.DescriptorPool, numSets, _descriptorSetLayouts.data());
 
-		GetDevice()->GetVkDevice().allocateDescriptorSets(&descriptorSetAllocateInfo, descriptorSets.data());
+			const vk::Result result = GetDevice()->GetVkDevice().allocateDescriptorSets(&descriptorSetAllocateInfo, descriptorSets.data());
+			if (result != vk::Result::eSuccess) { ErrorHandler::ThrowRuntimeError("Failed to allocate descriptor sets!"); }
 
-		std::vector<DescriptorPoolAllocation> poolAllocations;
-		for (int i = 0; i < Device::MAX_FRAMES_IN_FLIGHT; ++i)
-		{
-			uint32_t insertionIndex                                     = validDescriptorPoolInstance->Available.Pop();
-			validDescriptorPoolInstance->DescriptorSets[insertionIndex] = descriptorSets[i];
-			poolAllocations.emplace_back(descriptorPoolIndex, insertionIndex);
-		}
+			descriptorPoolInstance.NumAllocatedSets += numSets;
+			descriptorPoolInstance.NumLiveAllocations += numAllocations;
+
+			for (uint32_t i = 0; i < numAllocations; ++i)
+			{
+				Allocation& descriptorSetAllocation = descriptorSetAllocations[allocationIndex + i];
+
+				const auto firstSet = descriptorSets.begin() + i * GetDevice()->GetNumFramesInFlight();
+
+				descriptorSetAllocation._descriptorPoolIndex = descriptorPoolIndex;
+				descriptorSetAllocation.UpdateTemplate       = _updateTemplate;
+				descriptorSetAllocation.DescriptorSets       = InFlightResource<vk::DescriptorSet>(GetDevice()->GetCurrentFramePtr(),
+				                                                                                   std::vector<vk::DescriptorSet>(firstSet, firstSet + GetDevice()->GetNumFramesInFlight()));
 
-		Allocation descriptorSetAllocation;
+				CreateDescriptors(descriptorSetAllocation, writeDescriptorSets);
+			}
+
+			allocationIndex += numAllocations;
+		}
 
-		int numUniqueDescriptors = 0;
-		for (DescriptorCreateInfo createInfo: _descriptorCreateInfo) { if (!createInfo.Shared) { numUniqueDescriptors++; } }
+		if (!writeDescriptorSets.empty()) { GetDevice()->GetVkDevice().updateDescriptorSets(writeDescriptorSets, nullptr); }
 
-		// Create allocation object
-		descriptorSetAllocation.DescriptorSets = InFlightResource<vk::DescriptorSet>(GetDevice()->GetCurrentFramePtr(), std::move(descriptorSets));
+		return descriptorSetAllocations;
+	}
 
-		descriptorSetAllocation._uniqueDescriptors.reserve(numUniqueDescriptors);
+	void DescriptorSetAllocator::CreateDescriptors(Allocation& descriptorSetAllocation, std::vector<vk::WriteDescriptorSet>& writeDescriptorSets)
+	{
+		// Entries point into this vector, so it can't ever reallocate
+		descriptorSetAllocation._uniqueDescriptors.reserve(_numUniqueDescriptors);
 
 		// Create descriptor resources
 		for (int i = 0; i < _writeDescriptorSets.size(); ++i)
 		{
-			Descriptor                           descriptor{};
-			uint32_t                             bindingPoint         = _bindings[i];
-			std::vector<vk::WriteDescriptorSet>& writeDescriptorSets  = _writeDescriptorSets[i];
-			vk::WriteDescriptorSet&              lastWriteDescriptor  = writeDescriptorSets.back();
-			DescriptorCreateInfo&                descriptorCreateInfo = _descriptorCreateInfo[i];
+			Descriptor                                 descriptor{};
+			uint32_t                                   bindingPoint                = _bindings[i];
+			const std::vector<vk::WriteDescriptorSet>& templateWriteDescriptorSets = _writeDescriptorSets[i];
+			const vk::WriteDescriptorSet&              lastWriteDescriptor         = templateWriteDescriptorSets.back();
+			const DescriptorCreateInfo&                descriptorCreateInfo        = _descriptorCreateInfo[i];
 
 			descriptor.SingleInstance = descriptorCreateInfo.SingleInstance;
 
@@ -101,7 +218,7 @@ namespace SplitEngine::Rendering::Vulkan
 				descriptorSetAllocation.DescriptorEntries.emplace_back(bindingPoint, &_sharedDescriptors[descriptorCreateInfo.Name]);
 				descriptorSetAllocation.WriteDescriptorSets.push_back(_sharedDescriptors[descriptorCreateInfo.Name].WriteDescriptorSets);
 
-				for (int fifIndex = 0; fifIndex < Device::MAX_FRAMES_IN_FLIGHT; ++fifIndex)
+				for (uint32_t fifIndex = 0; fifIndex < GetDevice()->GetNumFramesInFlight(); ++fifIndex)
 				{
 					vk::WriteDescriptorSet& writeDescriptor = descriptorSetAllocation.WriteDescriptorSets.back().GetDataVector()[fifIndex];
 					writeDescriptor.dstSet                  = descriptorSetAllocation.DescriptorSets[fifIndex];
@@ -116,75 +233,60 @@ namespace SplitEngine::Rendering::Vulkan
 				{
 					case vk::DescriptorType::eUniformBuffer:
 					case vk::DescriptorType::eStorageBuffer:
+					case vk::DescriptorType::eUniformBufferDynamic:
+					case vk::DescriptorType::eStorageBufferDynamic:
 					{
 						descriptor.Type = Descriptor::Type::Buffer;
 
-						vk::Flags<vk::BufferUsageFlagBits> usage = lastWriteDescriptor.descriptorType == vk::DescriptorType::eUniformBuffer
-							                                           ? vk::BufferUsageFlagBits::eUniformBuffer
-							                                           : vk::BufferUsageFlagBits::eStorageBuffer;
-
-						if (descriptorCreateInfo.TransferSrc) { usage |= vk::BufferUsageFlagBits::eTransferSrc; }
+						uint32_t       numSubBuffers = descriptorCreateInfo.SingleInstance ? 1 : GetDevice()->GetNumFramesInFlight();
+						vk::DeviceSize slotOffset    = 0;
 
-						if (descriptorCreateInfo.TransferDst) { usage |= vk::BufferUsageFlagBits::eTransferDst; }
-
-						uint32_t                                             numSubBuffers = descriptorCreateInfo.SingleInstance ? 1 : Device::MAX_FRAMES_IN_FLIGHT;
-						vk::Flags<Allocator::MemoryAllocationCreateFlagBits> flags{};
-						vk::Flags<Allocator::MemoryPropertyFlagBits>         requiredFlags{};
-
-						// Always try to presistent map and be coherant
-						if (!descriptorCreateInfo.DeviceLocal)
+						if (_bufferLayoutLookup[i] != -1u)
 						{
-							flags |= Allocator::PersistentMap;
-							requiredFlags |= Allocator::HostVisible;
-							if (!descriptorCreateInfo.NoCoherant) { requiredFlags |= Allocator::HostCoherant; }
-						}
+							const BufferLayout&    bufferLayout          = _bufferLayouts[_bufferLayoutLookup[i]];
+							DescriptorBufferArena& descriptorBufferArena = GetDevice()->GetPhysicalDevice().GetInstance().GetDescriptorBufferArena();
 
-						if (descriptorCreateInfo.DeviceLocalHostVisible)
-						{
-							requiredFlags |= Allocator::LocalDevice;
-							requiredFlags |= Allocator::HostVisible;
-							flags |= Allocator::WriteSequentially;
-						}
-						else if (descriptorCreateInfo.DeviceLocal) { requiredFlags |= Allocator::LocalDevice; }
-						else
-						{
-							if (descriptorCreateInfo.Cached)
-							{
-								requiredFlags |= Allocator::HostCached;
-								flags |= Allocator::RandomAccess;
-							}
-							else { flags |= Allocator::WriteSequentially; }
-						}
+							const DescriptorBufferArena::Range bufferRange = descriptorBufferArena.Allocate(bufferLayout.Usage,
+							                                                                                bufferLayout.AllocationCreateInfo,
+							                                                                                bufferLayout.SizeInBytes,
+							                                                                                bufferLayout.Alignment);
 
-						Allocator::MemoryAllocationCreateInfo allocationCreateInfo = { Allocator::Auto, flags, requiredFlags };
+							descriptor.BlockBuffer = bufferRange.Buffer;
+							descriptor.BlockOffset = bufferRange.OffsetInBytes;
+							slotOffset             = bufferRange.OffsetInBytes;
 
-						if (!descriptorCreateInfo.NoAllocation)
+							descriptorSetAllocation._bufferRanges.push_back(bufferRange);
+						}
+						else if (!descriptorCreateInfo.NoAllocation)
 						{
 							descriptor.Buffer = std::move(Buffer(GetDevice(),
-							                                     usage,
+							                                     GetBufferUsage(lastWriteDescriptor.descriptorType, descriptorCreateInfo),
 							                                     vk::SharingMode::eExclusive,
-							                                     allocationCreateInfo,
+							                                     GetAllocationCreateInfo(descriptorCreateInfo),
 							                                     numSubBuffers,
 							                                     lastWriteDescriptor.pBufferInfo->range));
 						}
 
+						const Buffer& buffer = descriptor.BlockBuffer != nullptr ? *descriptor.BlockBuffer : descriptor.Buffer;
+
 						descriptor.BufferInfos = GetDevice()->CreateInFlightResource<vk::DescriptorBufferInfo>(descriptorCreateInfo.SingleInstance);
 						descriptor.BufferPtrs  = GetDevice()->CreateInFlightResource<std::byte*>(descriptorCreateInfo.SingleInstance, nullptr);
 
-						size_t offset   = 0;
+						size_t offset   = slotOffset;
 						int    fifIndex = 0;
-						for (int j = 0; j < Device::MAX_FRAMES_IN_FLIGHT; ++j)
+						for (uint32_t j = 0; j < GetDevice()->GetNumFramesInFlight(); ++j)
 						{
-							descriptor.BufferInfos[fifIndex] = vk::DescriptorBufferInfo(*writeDescriptorSets[j].pBufferInfo);
+							descriptor.BufferInfos[fifIndex] = vk::DescriptorBufferInfo(*templateWriteDescriptorSets[j].pBufferInfo);
 
 							if (!descriptorCreateInfo.NoAllocation)
 							{
-								descriptor.BufferInfos[fifIndex].buffer = descriptor.Buffer.GetVkBuffer();
-								if (!descriptorCreateInfo.DeviceLocal) { descriptor.BufferPtrs[fifIndex] = descriptor.Buffer.GetMappedData<std::byte>() + offset; }
+								descriptor.BufferInfos[fifIndex].buffer = buffer.GetVkBuffer();
+								descriptor.BufferInfos[fifIndex].offset += slotOffset;
+								if (!descriptorCreateInfo.DeviceLocal) { descriptor.BufferPtrs[fifIndex] = buffer.GetMappedData<std::byte>() + offset; }
 							}
 							else { descriptor.BufferPtrs[fifIndex] = nullptr; }
 
-							descriptor.WriteDescriptorSets[j] = writeDescriptorSets[j];
+							descriptor.WriteDescriptorSets[j] = templateWriteDescriptorSets[j];
 
 							descriptor.WriteDescriptorSets[j].dstSet      = descriptorSetAllocation.DescriptorSets[j];
 							descriptor.WriteDescriptorSets[j].pBufferInfo = &descriptor.BufferInfos[fifIndex];
@@ -204,10 +306,11 @@ namespace SplitEngine::Rendering::Vulkan
 						descriptor.ImageInfos = GetDevice()->CreateInFlightResource<std::vector<vk::DescriptorImageInfo>>(descriptorCreateInfo.SingleInstance,
 							std::vector<vk::DescriptorImageInfo>());
 
+						// Bindless arrays are written by the BindlessTextureTable, filling them with defaults would just waste memory
 						int fifIndex = 0;
-						for (int j = 0; j < Device::MAX_FRAMES_IN_FLIGHT; ++j)
+						for (uint32_t j = 0; j < GetDevice()->GetNumFramesInFlight(); ++j)
 						{
-							if (!descriptorCreateInfo.SingleInstance || (descriptorCreateInfo.SingleInstance && j == 0))
+							if (!descriptorCreateInfo.Bindless && (!descriptorCreateInfo.SingleInstance || (descriptorCreateInfo.SingleInstance && j == 0)))
 							{
 								for (int imageIndex = 0; imageIndex < lastWriteDescriptor.descriptorCount; ++imageIndex)
 								{
@@ -217,7 +320,7 @@ namespace SplitEngine::Rendering::Vulkan
 								}
 							}
 
-							descriptor.WriteDescriptorSets[j]            = writeDescriptorSets[j];
+							descriptor.WriteDescriptorSets[j]            = templateWriteDescriptorSets[j];
 							descriptor.WriteDescriptorSets[j].dstSet     = descriptorSetAllocation.DescriptorSets[j];
 							descriptor.WriteDescriptorSets[j].pImageInfo = descriptor.ImageInfos[fifIndex].data();
 
@@ -245,39 +348,49 @@ namespace SplitEngine::Rendering::Vulkan
 
 			if (!descriptorCreateInfo.NoAllocation)
 			{
-				GetDevice()->GetVkDevice().updateDescriptorSets(Device::MAX_FRAMES_IN_FLIGHT, descriptorSetAllocation.WriteDescriptorSets.back().GetDataPtr(), 0, nullptr);
+				const std::vector<vk::WriteDescriptorSet>& descriptorWrites = descriptorSetAllocation.WriteDescriptorSets.back().GetDataVector();
+				writeDescriptorSets.insert(writeDescriptorSets.end(), descriptorWrites.begin(), descriptorWrites.end());
 			}
 			descriptorSetAllocation.SparseDescriptorLookup[bindingPoint] = descriptorSetAllocation.DescriptorEntries.size() - 1;
 		}
 
-		descriptorSetAllocation._descriptorPoolAllocations = std::move(poolAllocations);
-
-		return descriptorSetAllocation;
+		descriptorSetAllocation.DynamicOffsets = std::vector<uint32_t>(_dynamicBindings.size(), 0);
+		for (uint32_t i = 0; i < _dynamicBindings.size(); ++i) { descriptorSetAllocation.SparseDynamicOffsetLookup[_dynamicBindings[i]] = i; }
 	}
 
 	void DescriptorSetAllocator::AllocateNewDescriptorPool()
 	{
-		const vk::DescriptorPoolCreateInfo descriptorPoolCreateInfo = vk::DescriptorPoolCreateInfo(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
-		                                                                                           _maxSetsPerPool,
-		                                                                                           _descriptorPoolSizes);
+		// Sets are never freed individually, which lets the driver allocate them linearly
+		const vk::DescriptorPoolCreateFlags descriptorPoolCreateFlags = _updateAfterBind ? vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind : vk::DescriptorPoolCreateFlags();
 
-		AvailableStack<uint32_t> availableStack = AvailableStack<uint32_t>(_maxSetsPerPool);
+		const vk::DescriptorPoolCreateInfo descriptorPoolCreateInfo = vk::DescriptorPoolCreateInfo(descriptorPoolCreateFlags, _maxSetsPerPool, _descriptorPoolSizes);
 
-		// Fill from 0 to size - 1
-		std::iota(availableStack.begin(), availableStack.end(), 0);
+		_descriptorPoolInstances.push_back({ GetDevice()->GetVkDevice().createDescriptorPool(descriptorPoolCreateInfo) });
+	}
+
+	uint32_t DescriptorSetAllocator::AcquireDescriptorPool()
+	{
+		if (_descriptorPoolInstances[_currentDescriptorPool].NumAllocatedSets + GetDevice()->GetNumFramesInFlight() <= _maxSetsPerPool) { return _currentDescriptorPool; }
 
-		DescriptorPoolInstance descriptorPoolInstance = {
-			GetDevice()->GetVkDevice().createDescriptorPool(descriptorPoolCreateInfo),
-			std::vector<vk::DescriptorSet>(_maxSetsPerPool, VK_NULL_HANDLE),
-			std::move(availableStack)
-		};
+		// Current pool is full, continue with one that has been reset or allocate a new one
+		if (!_availableDescriptorPools.empty())
+		{
+			_currentDescriptorPool = _availableDescriptorPools.back();
+			_availableDescriptorPools.pop_back();
+		}
+		else
+		{
+			AllocateNewDescriptorPool();
+			_currentDescriptorPool = static_cast<uint32_t>(_descriptorPoolInstances.size() - 1);
+		}
 
-		_descriptorPoolInstances.push_back(std::move(descriptorPoolInstance));
+		return _currentDescriptorPool;
 	}
 
 	void DescriptorSetAllocator::Destroy()
 	{
 		Utility::DeleteDeviceHandle(GetDevice(), _descriptorSetLayout);
+		GetDevice()->GetPhysicalDevice().GetInstance().GetDescriptorWriteBatch().DestroyUpdateTemplate(_updateTemplate);
 		for (const DescriptorPoolInstance& descriptorPoolInstance: _descriptorPoolInstances) { Utility::DeleteDeviceHandle(GetDevice(), descriptorPoolInstance.DescriptorPool); }
 
 		for (std::vector<vk::WriteDescriptorSet>& writeDescriptorSets: _writeDescriptorSets)
@@ -290,22 +403,42 @@ namespace SplitEngine::Rendering::Vulkan
 	{
 		if (descriptorSetAllocation.DescriptorSets.IsValid())
 		{
-			for (const auto& poolAllocation: descriptorSetAllocation._descriptorPoolAllocations)
-			{
-				DescriptorPoolInstance& descriptorPoolInstance = _descriptorPoolInstances[poolAllocation.DescriptorPoolIndex];
+			DescriptorPoolInstance& descriptorPoolInstance = _descriptorPoolInstances[descriptorSetAllocation._descriptorPoolIndex];
 
-				GetDevice()->GetVkDevice().freeDescriptorSets(descriptorPoolInstance.DescriptorPool, 1, &descriptorPoolInstance.DescriptorSets[poolAllocation.DescriptorSetIndex]);
+			DescriptorWriteBatch& descriptorWriteBatch = GetDevice()->GetPhysicalDevice().GetInstance().GetDescriptorWriteBatch();
+			for (const vk::DescriptorSet& descriptorSet: descriptorSetAllocation.DescriptorSets.GetDataVector()) { descriptorWriteBatch.Discard(descriptorSet); }
 
-				for (int i = 0; i < Device::MAX_FRAMES_IN_FLIGHT; ++i)
-				{
-					descriptorPoolInstance.DescriptorSets[poolAllocation.DescriptorSetIndex] = VK_NULL_HANDLE;
-					descriptorPoolInstance.Available.Push(poolAllocation.DescriptorSetIndex);
-				}
+			// Once nothing references the pool anymore all of its sets are released at once
+			if (--descriptorPoolInstance.NumLiveAllocations == 0)
+			{
+				GetDevice()->GetVkDevice().resetDescriptorPool(descriptorPoolInstance.DescriptorPool);
+				descriptorPoolInstance.NumAllocatedSets = 0;
+
+				if (descriptorSetAllocation._descriptorPoolIndex != _currentDescriptorPool) { _availableDescriptorPools.push_back(descriptorSetAllocation._descriptorPoolIndex); }
 			}
 
+			DescriptorBufferArena& descriptorBufferArena = GetDevice()->GetPhysicalDevice().GetInstance().GetDescriptorBufferArena();
+			for (const DescriptorBufferArena::Range& bufferRange: descriptorSetAllocation._bufferRanges) { descriptorBufferArena.Free(bufferRange); }
+
 			for (auto& descriptor: descriptorSetAllocation._uniqueDescriptors) { if (descriptor.Type == Descriptor::Type::Buffer) { descriptor.Buffer.Destroy(); } }
 		}
 	}
 
 	const vk::DescriptorSetLayout& DescriptorSetAllocator::GetDescriptorSetLayout() const { return _descriptorSetLayout; }
+
+	void DescriptorSetAllocator::Allocation::FreeBlockRange(const Descriptor& descriptor)
+	{
+		if (descriptor.BlockBuffer == nullptr) { return; }
+
+		const auto it = std::ranges::find_if(_bufferRanges,
+		                                     [&descriptor](const DescriptorBufferArena::Range& bufferRange)
+		                                     {
+			                                     return bufferRange.Buffer == descriptor.BlockBuffer && bufferRange.OffsetInBytes == descriptor.BlockOffset;
+		                                     });
+
+		if (it == _bufferRanges.end()) { return; }
+
+		Instance::Get().GetDescriptorBufferArena().Free(*it);
+		_bufferRanges.erase(it);
+	}
 }
@@ -0,0 +1,184 @@
+#include "SplitEngine/Rendering/Vulkan/DescriptorWriteBatch.hpp"
+
+#include "SplitEngine/Rendering/Vulkan/Device.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	namespace
+	{
+		size_t GetInfoSize(const vk::DescriptorType descriptorType)
+		{
+			switch (descriptorType)
+			{
+				case vk::DescriptorType::eUniformBuffer:
+				case vk::DescriptorType::eStorageBuffer:
+				case vk::DescriptorType::eUniformBufferDynamic:
+				case vk::DescriptorType::eStorageBufferDynamic:
+					return sizeof(vk::DescriptorBufferInfo);
+				case vk::DescriptorType::eSampler:
+				case vk::DescriptorType::eCombinedImageSampler:
+				case vk::DescriptorType::eSampledImage:
+				case vk::DescriptorType::eStorageImage:
+				case vk::DescriptorType::eInputAttachment:
+					return sizeof(vk::DescriptorImageInfo);
+				default:
+					return 0;
+			}
+		}
+	}
+
+	DescriptorWriteBatch::DescriptorWriteBatch(Device* device) :
+		DeviceObject(device) {}
+
+	const DescriptorWriteBatch::UpdateTemplate* DescriptorWriteBatch::CreateUpdateTemplate(const vk::DescriptorSetLayout&                     descriptorSetLayout,
+	                                                                                       const std::vector<vk::DescriptorSetLayoutBinding>& bindings,
+	                                                                                       const bool                                         bindless)
+	{
+		if (bindless || bindings.empty()) { return nullptr; }
+
+		std::unique_ptr<UpdateTemplate>               updateTemplate = std::make_unique<UpdateTemplate>();
+		std::vector<vk::DescriptorUpdateTemplateEntry> entries{};
+		entries.reserve(bindings.size());
+
+		for (const vk::DescriptorSetLayoutBinding& binding: bindings)
+		{
+			const size_t infoSize = GetInfoSize(binding.descriptorType);
+			if (infoSize == 0) { return nullptr; }
+
+			entries.emplace_back(binding.binding, 0, binding.descriptorCount, binding.descriptorType, updateTemplate->SizeInBytes, infoSize);
+
+			updateTemplate->Bindings.push_back(binding.binding);
+			updateTemplate->Offsets.push_back(updateTemplate->SizeInBytes);
+			updateTemplate->SizeInBytes += binding.descriptorCount * infoSize;
+		}
+
+		const vk::DescriptorUpdateTemplateCreateInfo createInfo = vk::DescriptorUpdateTemplateCreateInfo({},
+		                                                                                                  entries,
+		                                                                                                  vk::DescriptorUpdateTemplateType::eDescriptorSet,
+		                                                                                                  descriptorSetLayout);
+
+		updateTemplate->Template = GetDevice()->GetVkDevice().createDescriptorUpdateTemplate(createInfo);
+
+		// Pipelines get created on worker threads
+		std::lock_guard<std::mutex> lock(_updateTemplateMutex);
+		_updateTemplates.push_back(std::move(updateTemplate));
+
+		return _updateTemplates.back().get();
+	}
+
+	void DescriptorWriteBatch::DestroyUpdateTemplate(const UpdateTemplate* updateTemplate)
+	{
+		if (updateTemplate == nullptr) { return; }
+
+		std::lock_guard<std::mutex> lock(_updateTemplateMutex);
+
+		const auto it = std::ranges::find_if(_updateTemplates, [updateTemplate](const std::unique_ptr<UpdateTemplate>& entry) { return entry.get() == updateTemplate; });
+		if (it == _updateTemplates.end()) { return; }
+
+		GetDevice()->GetVkDevice().destroy((*it)->Template);
+		_updateTemplates.erase(it);
+	}
+
+	void DescriptorWriteBatch::Add(const vk::WriteDescriptorSet& writeDescriptorSet, const UpdateTemplate* updateTemplate)
+	{
+		const auto [lookupIt, inserted] = _pendingSetLookup.try_emplace(static_cast<VkDescriptorSet>(writeDescriptorSet.dstSet), _numPendingSets);
+
+		if (inserted)
+		{
+			// Pending sets are reused between flushes so their write vectors keep their capacity
+			if (_numPendingSets == _pendingSets.size()) { _pendingSets.emplace_back(); }
+
+			PendingSet& pendingSet    = _pendingSets[_numPendingSets++];
+			pendingSet.DescriptorSet  = writeDescriptorSet.dstSet;
+			pendingSet.UpdateTemplate = updateTemplate;
+			pendingSet.Writes.clear();
+		}
+
+		std::vector<vk::WriteDescriptorSet>& writes = _pendingSets[lookupIt->second].Writes;
+
+		const auto writeIt = std::ranges::find_if(writes, [&writeDescriptorSet](const vk::WriteDescriptorSet& write) { return write.dstBinding == writeDescriptorSet.dstBinding; });
+		if (writeIt != writes.end()) { *writeIt = writeDescriptorSet; }
+		else { writes.push_back(writeDescriptorSet); }
+	}
+
+	void DescriptorWriteBatch::Discard(const vk::DescriptorSet& descriptorSet)
+	{
+		const auto it = _pendingSetLookup.find(static_cast<VkDescriptorSet>(descriptorSet));
+		if (it == _pendingSetLookup.end()) { return; }
+
+		_pendingSets[it->second].DescriptorSet = VK_NULL_HANDLE;
+		_pendingSetLookup.erase(it);
+	}
+
+	void DescriptorWriteBatch::Flush()
+	{
+		if (_numPendingSets == 0) { return; }
+
+		_writeDescriptorSets.clear();
+
+		for (uint32_t i = 0; i < _numPendingSets; ++i)
+		{
+			const PendingSet& pendingSet = _pendingSets[i];
+			if (pendingSet.DescriptorSet) { WritePendingSet(pendingSet); }
+		}
+
+		if (!_writeDescriptorSets.empty()) { GetDevice()->GetVkDevice().updateDescriptorSets(_writeDescriptorSets, nullptr); }
+
+		_numPendingSets = 0;
+		_pendingSetLookup.clear();
+	}
+
+	void DescriptorWriteBatch::Flush(const vk::DescriptorSet& descriptorSet)
+	{
+		const auto it = _pendingSetLookup.find(static_cast<VkDescriptorSet>(descriptorSet));
+		if (it == _pendingSetLookup.end()) { return; }
+
+		_writeDescriptorSets.clear();
+
+		PendingSet& pendingSet = _pendingSets[it->second];
+		WritePendingSet(pendingSet);
+
+		if (!_writeDescriptorSets.empty()) { GetDevice()->GetVkDevice().updateDescriptorSets(_writeDescriptorSets, nullptr); }
+
+		// Same as discarding, the slot stays in use until the next full flush so the indices of the other sets don't change
+		pendingSet.DescriptorSet = VK_NULL_HANDLE;
+		_pendingSetLookup.erase(it);
+	}
+
+	bool DescriptorWriteBatch::HasPendingWrites() const { return _numPendingSets > 0; }
+
+	void DescriptorWriteBatch::WritePendingSet(const PendingSet& pendingSet)
+	{
+		const UpdateTemplate* updateTemplate = pendingSet.UpdateTemplate;
+		if (updateTemplate == nullptr || pendingSet.Writes.size() != updateTemplate->Bindings.size())
+		{
+			_writeDescriptorSets.insert(_writeDescriptorSets.end(), pendingSet.Writes.begin(), pendingSet.Writes.end());
+			return;
+		}
+
+		_templateData.resize(updateTemplate->SizeInBytes);
+
+		for (const vk::WriteDescriptorSet& write: pendingSet.Writes)
+		{
+			const size_t bindingIndex = std::ranges::find(updateTemplate->Bindings, write.dstBinding) - updateTemplate->Bindings.begin();
+			std::byte*   destination  = _templateData.data() + updateTemplate->Offsets[bindingIndex];
+
+			if (write.pBufferInfo != nullptr) { std::memcpy(destination, write.pBufferInfo, write.descriptorCount * sizeof(vk::DescriptorBufferInfo)); }
+			else { std::memcpy(destination, write.pImageInfo, write.descriptorCount * sizeof(vk::DescriptorImageInfo)); }
+		}
+
+		GetDevice()->GetVkDevice().updateDescriptorSetWithTemplate(pendingSet.DescriptorSet, updateTemplate->Template, _templateData.data());
+	}
+
+	void DescriptorWriteBatch::Destroy()
+	{
+		for (const std::unique_ptr<UpdateTemplate>& updateTemplate: _updateTemplates) { GetDevice()->GetVkDevice().destroy(updateTemplate->Template); }
+
+		_updateTemplates.clear();
+		_numPendingSets = 0;
+		_pendingSetLookup.clear();
+	}
+}
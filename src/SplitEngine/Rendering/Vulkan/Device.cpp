@@ -1,6 +1,10 @@
 #include "SplitEngine/Rendering/Vulkan/Device.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <set>
 #include "SplitEngine/ErrorHandler.hpp"
+#include "SplitEngine/IO/Stream.hpp"
 #include "SplitEngine/Rendering/Vulkan/Instance.hpp"
 #include "SplitEngine/Rendering/Vulkan/PhysicalDevice.hpp"
 
@@ -9,8 +13,16 @@ namespace SplitEngine::Rendering::Vulkan
 	Device::Device(PhysicalDevice& physicalDevice):
 		_physicalDevice(physicalDevice)
 	{
+		// Everything sized per frame in flight reads the count from here, so it has to be known before anything else gets created
+		const uint32_t framesInFlight = physicalDevice.GetInstance().GetRenderingSettings().FramesInFlight;
+
+		_numFramesInFlight = std::clamp(framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+		if (_numFramesInFlight != framesInFlight) { LOG_WARNING("{0} frames in flight aren't supported, using {1} instead", framesInFlight, _numFramesInFlight); }
+
 		CreateLogicalDevice(physicalDevice);
 
+		CreatePipelineCache();
+
 		CreateRenderPass();
 
 		CreateSyncObjects();
@@ -45,9 +57,21 @@ namespace SplitEngine::Rendering::Vulkan
 			previousIndex = queueFamily.Index;
 		}
 
+		// Only enable the descriptor indexing features needed for bindless textures and the indirect count draws used by gpu culling, and only as far as they're supported
+		const auto supportedFeatures = physicalDevice.GetVkPhysicalDevice().getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+		const vk::PhysicalDeviceVulkan12Features& supportedVulkan12Features = supportedFeatures.get<vk::PhysicalDeviceVulkan12Features>();
+
+		_vulkan12Features.shaderSampledImageArrayNonUniformIndexing    = supportedVulkan12Features.shaderSampledImageArrayNonUniformIndexing;
+		_vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = supportedVulkan12Features.descriptorBindingSampledImageUpdateAfterBind;
+		_vulkan12Features.descriptorBindingPartiallyBound              = supportedVulkan12Features.descriptorBindingPartiallyBound;
+		_vulkan12Features.runtimeDescriptorArray                       = supportedVulkan12Features.runtimeDescriptorArray;
+		_vulkan12Features.drawIndirectCount                            = supportedVulkan12Features.drawIndirectCount;
+
+		_features = supportedFeatures.get<vk::PhysicalDeviceFeatures2>().features;
+
 		// Create logical device
-		vk::PhysicalDeviceFeatures deviceFeatures = physicalDevice.GetVkPhysicalDevice().getFeatures();
-		vk::DeviceCreateInfo deviceCreateInfo = vk::DeviceCreateInfo({}, queueCreateInfos, physicalDevice.GetValidationLayers(), physicalDevice.GetExtensions(), &deviceFeatures);
+		vk::PhysicalDeviceFeatures2 deviceFeatures = vk::PhysicalDeviceFeatures2(_features, &_vulkan12Features);
+		vk::DeviceCreateInfo deviceCreateInfo = vk::DeviceCreateInfo({}, queueCreateInfos, physicalDevice.GetValidationLayers(), physicalDevice.GetExtensions(), nullptr, &deviceFeatures);
 
 		vk::Result vulkanDeviceCreateResult = physicalDevice.GetVkPhysicalDevice().createDevice(&deviceCreateInfo, nullptr, &_vkDevice);
 		if (vulkanDeviceCreateResult != vk::Result::eSuccess) { ErrorHandler::ThrowRuntimeError("Failed to create logical device!"); }
@@ -81,7 +105,7 @@ namespace SplitEngine::Rendering::Vulkan
 		std::vector<vk::Semaphore> renderingFinishedSemaphores;
 		std::vector<vk::Fence>     inFlightFences;
 
-		for (int i = 0; i < Device::MAX_FRAMES_IN_FLIGHT; ++i)
+		for (uint32_t i = 0; i < _numFramesInFlight; ++i)
 		{
 			imageAvailableSemaphores.push_back(_vkDevice.createSemaphore(semaphoreCreateInfo));
 			renderingFinishedSemaphores.push_back(_vkDevice.createSemaphore(semaphoreCreateInfo));
@@ -93,6 +117,87 @@ namespace SplitEngine::Rendering::Vulkan
 		_inFlightFence           = InFlightResource<vk::Fence>(GetCurrentFramePtr(), std::move(inFlightFences));
 	}
 
+	void Device::CreatePipelineCache()
+	{
+		const std::filesystem::path& cachePath = _physicalDevice.GetInstance().GetRenderingSettings().PipelineCachePath;
+
+		std::vector<std::byte> cacheData{};
+		if (!cachePath.empty() && std::filesystem::exists(cachePath))
+		{
+			cacheData = IO::Stream::ReadRawAndClose<std::byte>(cachePath, IO::Binary);
+
+			if (IsPipelineCacheCompatible(cacheData)) { LOG("Loaded pipeline cache {0} ({1} bytes)", cachePath.string(), cacheData.size()); }
+			else
+			{
+				LOG_WARNING("Pipeline cache {0} is invalid or was created by another device/driver, starting with an empty cache", cachePath.string());
+				cacheData.clear();
+			}
+		}
+
+		const vk::PipelineCacheCreateInfo pipelineCacheCreateInfo = vk::PipelineCacheCreateInfo({}, cacheData.size(), cacheData.data());
+
+		_pipelineCache = _vkDevice.createPipelineCache(pipelineCacheCreateInfo);
+	}
+
+	bool Device::IsPipelineCacheCompatible(const std::vector<std::byte>& cacheData) const
+	{
+		// The header layout is defined by the spec (VkPipelineCacheHeaderVersionOne), drivers are supposed to reject foreign data themselves but not all of them do
+		if (cacheData.size() < sizeof(VkPipelineCacheHeaderVersionOne)) { return false; }
+
+		VkPipelineCacheHeaderVersionOne header{};
+		memcpy(&header, cacheData.data(), sizeof(VkPipelineCacheHeaderVersionOne));
+
+		const vk::PhysicalDeviceProperties& properties = _physicalDevice.GetProperties();
+
+		return header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne) &&
+		       header.headerSize <= cacheData.size() &&
+		       header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+		       header.vendorID == properties.vendorID &&
+		       header.deviceID == properties.deviceID &&
+		       memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+	}
+
+	void Device::SavePipelineCache() const
+	{
+		const std::filesystem::path& cachePath = _physicalDevice.GetInstance().GetRenderingSettings().PipelineCachePath;
+		if (cachePath.empty() || _pipelineCache == VK_NULL_HANDLE) { return; }
+
+		const std::vector<uint8_t> cacheData = _vkDevice.getPipelineCacheData(_pipelineCache);
+
+		// Write to a temporary file first so a crash while saving can't leave a truncated cache behind
+		std::filesystem::path temporaryPath = cachePath;
+		temporaryPath += ".tmp";
+
+		std::ofstream stream = std::ofstream(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!stream.is_open())
+		{
+			LOG_WARNING("Failed to write pipeline cache {0}", temporaryPath.string());
+			return;
+		}
+
+		stream.write(reinterpret_cast<const char*>(cacheData.data()), static_cast<std::streamsize>(cacheData.size()));
+		stream.close();
+
+		std::error_code errorCode;
+		std::filesystem::rename(temporaryPath, cachePath, errorCode);
+		if (errorCode) { LOG_WARNING("Failed to replace pipeline cache {0}: {1}", cachePath.string(), errorCode.message()); }
+	}
+
+	const vk::PipelineCache& Device::GetPipelineCache() const { return _pipelineCache; }
+
+	bool Device::SupportsBindlessTextures() const
+	{
+		return _vulkan12Features.descriptorBindingSampledImageUpdateAfterBind &&
+		       _vulkan12Features.descriptorBindingPartiallyBound &&
+		       _vulkan12Features.runtimeDescriptorArray;
+	}
+
+	bool Device::SupportsDrawIndirectCount() const { return _vulkan12Features.drawIndirectCount; }
+
+	bool Device::SupportsMultiDrawIndirect() const { return _features.multiDrawIndirect && _features.drawIndirectFirstInstance; }
+
+	const vk::PhysicalDeviceFeatures& Device::GetEnabledFeatures() const { return _features; }
+
 	void Device::CreateRenderPass() { _renderPass = RenderPass(this); }
 
 	void Device::CreateSwapchain(vk::SurfaceKHR surfaceKhr, glm::ivec2 size)
@@ -103,7 +208,35 @@ namespace SplitEngine::Rendering::Vulkan
 		_swapchain.reset(new Swapchain(this, surfaceKhr, { static_cast<uint32_t>(size.x), static_cast<uint32_t>(size.y) }));
 	}
 
-	void Device::DestroySwapchain() { _swapchain->Destroy(); }
+	void Device::DestroySwapchain()
+	{
+		if (_swapchain) { _swapchain->Destroy(); }
+	}
+
+	void Device::CreateOffscreenTargets(const vk::Extent2D size, uint32_t numImages, const bool readback)
+	{
+		// An image can only be rendered to again once the frame that used it last is done
+		if (numImages < _numFramesInFlight)
+		{
+			LOG_WARNING("{0} offscreen images are less than the {1} frames in flight, using {1} images instead", numImages, _numFramesInFlight);
+			numImages = _numFramesInFlight;
+		}
+
+		if (_offscreenTargets) { _offscreenTargets->Destroy(); }
+		_offscreenTargets = std::make_unique<OffscreenTargets>(this, size, numImages, readback);
+	}
+
+	void Device::DestroyOffscreenTargets()
+	{
+		if (_offscreenTargets) { _offscreenTargets->Destroy(); }
+	}
+
+	vk::Extent2D Device::GetRenderExtent() const { return _offscreenTargets ? _offscreenTargets->GetExtend() : _swapchain->GetExtend(); }
+
+	const vk::Framebuffer& Device::GetFrameBuffer(const uint32_t imageIndex) const
+	{
+		return _offscreenTargets ? _offscreenTargets->GetFrameBuffers()[imageIndex] : _swapchain->GetFrameBuffers()[imageIndex];
+	}
 
 	const vk::Device& Device::GetVkDevice() const { return _vkDevice; }
 
@@ -116,6 +249,10 @@ namespace SplitEngine::Rendering::Vulkan
 
 	const Swapchain& Device::GetSwapchain() const { return *_swapchain.get(); }
 
+	const OffscreenTargets& Device::GetOffscreenTargets() const { return *_offscreenTargets.get(); }
+
+	bool Device::IsHeadless() const { return _offscreenTargets != nullptr; }
+
 
 	const vk::PhysicalDeviceMemoryProperties& Device::GetMemoryProperties() const { return _memoryProperties; }
 
@@ -127,7 +264,7 @@ namespace SplitEngine::Rendering::Vulkan
 
 	void Device::Destroy()
 	{
-		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		for (uint32_t i = 0; i < _numFramesInFlight; ++i)
 		{
 			_vkDevice.destroy(_imageAvailableSemaphore[i]);
 			_vkDevice.destroy(_renderFinishedSemaphore[i]);
@@ -138,6 +275,9 @@ namespace SplitEngine::Rendering::Vulkan
 
 		_renderPass.Destroy();
 
+		SavePipelineCache();
+		_vkDevice.destroy(_pipelineCache);
+
 		_vkDevice.destroy();
 	}
 
@@ -157,9 +297,11 @@ namespace SplitEngine::Rendering::Vulkan
 		return memoryType;
 	}
 
+	uint32_t Device::GetNumFramesInFlight() const { return _numFramesInFlight; }
+
 	uint32_t* Device::GetCurrentFramePtr(const bool staticPtr) { return staticPtr ? &_currentStaticFrame : &_currentFrame; }
 
-	void Device::AdvanceFrame() { _currentFrame = (_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT; }
+	void Device::AdvanceFrame() { _currentFrame = (_currentFrame + 1) % _numFramesInFlight; }
 
 	void Device::WaitForIdle() { _vkDevice.waitIdle(); }
 
@@ -0,0 +1,57 @@
+#include "SplitEngine/Rendering/Vulkan/FreeRangeList.hpp"
+
+#include <iterator>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	FreeRangeList::FreeRangeList(const vk::DeviceSize sizeInBytes) { _freeRanges.emplace(0, sizeInBytes); }
+
+	bool FreeRangeList::TryAllocate(const vk::DeviceSize sizeInBytes, const vk::DeviceSize alignment, vk::DeviceSize& offsetInBytes)
+	{
+		for (auto it = _freeRanges.begin(); it != _freeRanges.end(); ++it)
+		{
+			const vk::DeviceSize rangeOffset   = it->first;
+			const vk::DeviceSize rangeSize     = it->second;
+			const vk::DeviceSize alignedOffset = (rangeOffset + alignment - 1) / alignment * alignment;
+			const vk::DeviceSize padding       = alignedOffset - rangeOffset;
+
+			if (rangeSize < padding + sizeInBytes) { continue; }
+
+			_freeRanges.erase(it);
+
+			// The padding in front stays free so it can still be merged again later
+			if (padding > 0) { _freeRanges.emplace(rangeOffset, padding); }
+			if (rangeSize > padding + sizeInBytes) { _freeRanges.emplace(alignedOffset + sizeInBytes, rangeSize - padding - sizeInBytes); }
+
+			offsetInBytes = alignedOffset;
+			return true;
+		}
+
+		return false;
+	}
+
+	void FreeRangeList::Free(const vk::DeviceSize offsetInBytes, vk::DeviceSize sizeInBytes)
+	{
+		// Merge with the free range right after this one
+		const auto next = _freeRanges.find(offsetInBytes + sizeInBytes);
+		if (next != _freeRanges.end())
+		{
+			sizeInBytes += next->second;
+			_freeRanges.erase(next);
+		}
+
+		// And with the one right before it
+		const auto following = _freeRanges.lower_bound(offsetInBytes);
+		if (following != _freeRanges.begin())
+		{
+			const auto previous = std::prev(following);
+			if (previous->first + previous->second == offsetInBytes)
+			{
+				previous->second += sizeInBytes;
+				return;
+			}
+		}
+
+		_freeRanges.emplace(offsetInBytes, sizeInBytes);
+	}
+}
@@ -1,21 +1,42 @@
 #include "SplitEngine/Rendering/Vulkan/Image.hpp"
 #include "SplitEngine/ErrorHandler.hpp"
+#include "SplitEngine/Debug/Log.hpp"
 #include "SplitEngine/Rendering/Vulkan/BufferFactory.hpp"
 #include "SplitEngine/Rendering/Vulkan/Device.hpp"
 #include "SplitEngine/Rendering/Vulkan/Instance.hpp"
 #include "SplitEngine/Rendering/Vulkan/PhysicalDevice.hpp"
 #include "SplitEngine/Rendering/Vulkan/Utility.hpp"
 
+#include <algorithm>
+#include <bit>
+
 namespace SplitEngine::Rendering::Vulkan
 {
 	Image::Image(Device* device, const std::byte* pixels, vk::DeviceSize pixelsSizeInBytes, vk::Extent3D extend, CreateInfo createInfo) :
-		DeviceObject(device)
+		DeviceObject(device),
+		_format(createInfo.Format)
 	{
+		_mipLevels = createInfo.MipLevels == FULL_MIP_CHAIN ? CalculateMipLevels(extend) : createInfo.MipLevels;
+
+		if (createInfo.GenerateMipmaps && _mipLevels > 1)
+		{
+			// Mip levels are blitted from one another with a linear filter
+			const vk::FormatFeatureFlags requiredFeatures = vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+			const vk::FormatFeatureFlags formatFeatures   = GetDevice()->GetPhysicalDevice().GetVkPhysicalDevice().getFormatProperties(createInfo.Format).optimalTilingFeatures;
+
+			if ((formatFeatures & requiredFeatures) == requiredFeatures) { createInfo.Usage |= vk::ImageUsageFlagBits::eTransferSrc; }
+			else
+			{
+				LOG_WARNING("Format {0} doesn't support linear blits, mipmaps won't be generated", vk::to_string(createInfo.Format));
+				_mipLevels = 1;
+			}
+		}
+
 		vk::ImageCreateInfo imageCreateInfo = vk::ImageCreateInfo({},
 		                                                          vk::ImageType::e2D,
 		                                                          createInfo.Format,
 		                                                          extend,
-		                                                          1,
+		                                                          _mipLevels,
 		                                                          1,
 		                                                          vk::SampleCountFlagBits::e1,
 		                                                          vk::ImageTiling::eOptimal,
@@ -27,38 +48,20 @@ namespace SplitEngine::Rendering::Vulkan
 
 		_imageAllocation = GetDevice()->GetPhysicalDevice().GetInstance().GetAllocator().CreateImage(imageCreateInfo, allocationCreateInfo);
 
-		vk::CommandBuffer commandBuffer;
-		if (createInfo.TransitionLayout != vk::ImageLayout::eDepthStencilAttachmentOptimal)
-		{
-			commandBuffer = GetDevice()->GetQueueFamily(QueueType::Graphics).BeginOneshotCommands();
-		}
-
-		// Copy pixel data to image
-		Buffer transferBuffer;
+		// Copy pixel data to image, the copy gets batched with other uploads and the frame waits for it before it's submitted
 		if (pixels)
 		{
-			transferBuffer = BufferFactory::CreateTransferBuffer(device, pixels, pixelsSizeInBytes);
-			transferBuffer.CopyData(pixels, pixelsSizeInBytes, 0);
-
-			TransitionLayout(commandBuffer, vk::ImageLayout::eTransferDstOptimal);
+			UploadManager& uploadManager = GetDevice()->GetPhysicalDevice().GetInstance().GetUploadManager();
 
-			vk::ImageSubresourceLayers imageSubresourceLayers = vk::ImageSubresourceLayers(createInfo.AspectMask, 0, 0, 1);
-			vk::BufferImageCopy        bufferImageCopy        = vk::BufferImageCopy(0, 0, 0, imageSubresourceLayers, { 0, 0, 0 }, extend);
-
-			commandBuffer.copyBufferToImage(transferBuffer.GetVkBuffer(), GetVkImage(), _layout, bufferImageCopy);
+			uploadManager.RequireForFrame(uploadManager.UploadImage(*this, pixels, pixelsSizeInBytes, extend, createInfo.AspectMask, createInfo.TransitionLayout, createInfo.GenerateMipmaps));
 		}
-
-		// TODO: Fix this hack
-		if (createInfo.TransitionLayout != vk::ImageLayout::eDepthStencilAttachmentOptimal)
+		else if (createInfo.TransitionLayout != vk::ImageLayout::eDepthStencilAttachmentOptimal && createInfo.TransitionLayout != vk::ImageLayout::eUndefined) // TODO: Fix this hack
 		{
-			TransitionLayout(commandBuffer, createInfo.TransitionLayout);
-
-			GetDevice()->GetQueueFamily(QueueType::Graphics).EndOneshotCommands();
-			transferBuffer.Destroy();
+			TransitionLayout(createInfo.TransitionLayout);
 		}
 
 		// Create image view
-		vk::ImageSubresourceRange imageSubresourceRange = vk::ImageSubresourceRange(createInfo.AspectMask, 0, 1, 0, 1);
+		vk::ImageSubresourceRange imageSubresourceRange = vk::ImageSubresourceRange(createInfo.AspectMask, 0, _mipLevels, 0, 1);
 		vk::ImageViewCreateInfo   imageViewCreateInfo   = vk::ImageViewCreateInfo({}, GetVkImage(), vk::ImageViewType::e2D, createInfo.Format, {}, imageSubresourceRange);
 
 		_view = GetDevice()->GetVkDevice().createImageView(imageViewCreateInfo);
@@ -77,7 +80,7 @@ namespace SplitEngine::Rendering::Vulkan
 	{
 		if (newLayout == vk::ImageLayout::eDepthStencilAttachmentOptimal) { return; }
 
-		constexpr vk::ImageSubresourceRange subresourceRange   = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+		const vk::ImageSubresourceRange subresourceRange   = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, _mipLevels, 0, 1);
 		vk::ImageMemoryBarrier              imageMemoryBarrier = vk::ImageMemoryBarrier({},
 		                                                                                {},
 		                                                                                _layout,
@@ -132,4 +135,10 @@ namespace SplitEngine::Rendering::Vulkan
 	const vk::ImageView& Image::GetView() const { return _view; }
 
 	const vk::ImageLayout& Image::GetLayout() const { return _layout; }
+
+	uint32_t Image::GetMipLevels() const { return _mipLevels; }
+
+	vk::Format Image::GetFormat() const { return _format; }
+
+	uint32_t Image::CalculateMipLevels(const vk::Extent3D extent) { return std::bit_width(std::max({ extent.width, extent.height, extent.depth, 1u })); }
 }
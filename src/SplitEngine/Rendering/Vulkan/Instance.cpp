@@ -20,11 +20,18 @@ namespace SplitEngine::Rendering::Vulkan
 		_shaderParserSettings(std::move(shaderParserSettings)),
 		_renderingSettings(std::move(renderingSettings))
 	{
-		uint32_t extensionCount = 0;
-		SDL_Vulkan_GetInstanceExtensions(window.GetSDLWindow(), &extensionCount, nullptr);
+		const bool headless = _renderingSettings.Headless;
 
-		std::vector<const char*> extensionNames = std::vector<const char*>(extensionCount, nullptr);
-		SDL_Vulkan_GetInstanceExtensions(window.GetSDLWindow(), &extensionCount, extensionNames.data());
+		// Without a window no surface extensions are needed, which allows running on drivers that can't present at all
+		std::vector<const char*> extensionNames{};
+		if (!headless)
+		{
+			uint32_t extensionCount = 0;
+			SDL_Vulkan_GetInstanceExtensions(window.GetSDLWindow(), &extensionCount, nullptr);
+
+			extensionNames.resize(extensionCount, nullptr);
+			SDL_Vulkan_GetInstanceExtensions(window.GetSDLWindow(), &extensionCount, extensionNames.data());
+		}
 
 		const vk::ApplicationInfo vkApplicationInfo = vk::ApplicationInfo(applicationInfo.Name.c_str(),
 		                                                                  VK_MAKE_VERSION(applicationInfo.MajorVersion, applicationInfo.MinorVersion, applicationInfo.PatchVersion),
@@ -36,18 +43,35 @@ namespace SplitEngine::Rendering::Vulkan
 		if (renderingSettings.UseVulkanValidationLayers) { validationLayers.push_back("VK_LAYER_KHRONOS_validation"); }
 		_vkInstance = vk::createInstance(vk::InstanceCreateInfo({}, &vkApplicationInfo, validationLayers, extensionNames));
 
-		VkSurfaceKHR   surfaceHandle         = VK_NULL_HANDLE;
-		const SDL_bool surfaceCreationResult = SDL_Vulkan_CreateSurface(window.GetSDLWindow(), _vkInstance, &surfaceHandle);
-		if (surfaceCreationResult == SDL_FALSE) { ErrorHandler::ThrowRuntimeError("Failed to create SDL Vulkan surface!"); }
+		if (!headless)
+		{
+			VkSurfaceKHR   surfaceHandle         = VK_NULL_HANDLE;
+			const SDL_bool surfaceCreationResult = SDL_Vulkan_CreateSurface(window.GetSDLWindow(), _vkInstance, &surfaceHandle);
+			if (surfaceCreationResult == SDL_FALSE) { ErrorHandler::ThrowRuntimeError("Failed to create SDL Vulkan surface!"); }
 
-		_vkSurface = surfaceHandle;
+			_vkSurface = surfaceHandle;
+		}
 
-		const std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME };
+		std::vector<const char*> deviceExtensions = { VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME };
+		if (!headless) { deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME); }
 
-		_physicalDevice = std::make_unique<PhysicalDevice>(*this, deviceExtensions, validationLayers);
+		// Only used to report memory usage and budget more accurately
+		const std::vector<const char*> optionalDeviceExtensions = { VK_EXT_MEMORY_BUDGET_EXTENSION_NAME };
+
+		_physicalDevice = std::make_unique<PhysicalDevice>(*this, deviceExtensions, validationLayers, optionalDeviceExtensions);
 
 		CreateAllocator();
 
+		_uploadManager = std::make_unique<UploadManager>(&_physicalDevice->GetDevice(), _renderingSettings.UploadStagingBufferSizeInBytes);
+
+		_descriptorWriteBatch = std::make_unique<DescriptorWriteBatch>(&_physicalDevice->GetDevice());
+
+		_descriptorBufferArena = std::make_unique<DescriptorBufferArena>(&_physicalDevice->GetDevice(), _renderingSettings.DescriptorBufferBlockSizeInBytes);
+
+		_meshArena = std::make_unique<MeshArena>(&_physicalDevice->GetDevice(), _renderingSettings.MeshVertexBlockSizeInBytes, _renderingSettings.MeshIndexBlockSizeInBytes);
+
+		_bindlessTextureTable = std::make_unique<BindlessTextureTable>(&_physicalDevice->GetDevice(), _renderingSettings.MaxBindlessTextures);
+
 		_defaultSampler = _allocator->AllocateSampler({});
 
 		// ImageLoader
@@ -55,7 +79,11 @@ namespace SplitEngine::Rendering::Vulkan
 
 		_defaultImage = Image(&_physicalDevice->GetDevice(), std::begin(fuchsia), 4, { 1, 1, 1 }, {});
 
-		_physicalDevice->GetDevice().CreateSwapchain(_vkSurface, window.GetSize());
+		if (headless)
+		{
+			_physicalDevice->GetDevice().CreateOffscreenTargets(_renderingSettings.HeadlessResolution, _renderingSettings.HeadlessImageCount, _renderingSettings.HeadlessReadback);
+		}
+		else { _physicalDevice->GetDevice().CreateSwapchain(_vkSurface, window.GetSize()); }
 
 		_instance = this;
 	}
@@ -89,11 +117,17 @@ namespace SplitEngine::Rendering::Vulkan
 		_defaultImage.Destroy();
 		_physicalDevice->GetDevice().GetVkDevice().destroy(*_defaultSampler);
 		_physicalDevice->GetDevice().DestroySwapchain();
+		_physicalDevice->GetDevice().DestroyOffscreenTargets();
 
+		_bindlessTextureTable->Destroy();
+		_descriptorWriteBatch->Destroy();
+		_descriptorBufferArena->Destroy();
+		_meshArena->Destroy();
+		_uploadManager->Destroy();
 		_allocator->Destroy();
 		_physicalDevice->Destroy();
 
-		_vkInstance.destroy(_vkSurface);
+		if (_vkSurface) { _vkInstance.destroy(_vkSurface); }
 		_vkInstance.destroy();
 	}
 
@@ -107,4 +141,14 @@ namespace SplitEngine::Rendering::Vulkan
 	PhysicalDevice& Instance::GetPhysicalDevice() const { return *_physicalDevice; }
 
 	Allocator& Instance::GetAllocator() const { return *_allocator; }
+
+	UploadManager& Instance::GetUploadManager() const { return *_uploadManager; }
+
+	BindlessTextureTable& Instance::GetBindlessTextureTable() const { return *_bindlessTextureTable; }
+
+	DescriptorWriteBatch& Instance::GetDescriptorWriteBatch() const { return *_descriptorWriteBatch; }
+
+	DescriptorBufferArena& Instance::GetDescriptorBufferArena() const { return *_descriptorBufferArena; }
+
+	MeshArena& Instance::GetMeshArena() const { return *_meshArena; }
 }
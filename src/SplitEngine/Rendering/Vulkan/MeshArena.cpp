@@ -0,0 +1,145 @@
+#include "SplitEngine/Rendering/Vulkan/MeshArena.hpp"
+
+#include "SplitEngine/ErrorHandler.hpp"
+#include "SplitEngine/Rendering/Vulkan/Device.hpp"
+#include "SplitEngine/Rendering/Vulkan/Instance.hpp"
+
+#include <algorithm>
+#include <format>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	namespace
+	{
+		vk::DeviceSize GetIndexSize(const vk::IndexType indexType) { return indexType == vk::IndexType::eUint32 ? sizeof(uint32_t) : sizeof(uint16_t); }
+	}
+
+	MeshArena::MeshArena(Device* device, const vk::DeviceSize vertexBlockSizeInBytes, const vk::DeviceSize indexBlockSizeInBytes) :
+		DeviceObject(device),
+		_vertexBlockSizeInBytes(vertexBlockSizeInBytes),
+		_indexBlockSizeInBytes(indexBlockSizeInBytes),
+		_retiredMeshes(device->CreateInFlightResource<std::vector<Mesh>>()) {}
+
+	MeshArena::Mesh MeshArena::Allocate(const std::byte*     vertices,
+	                                    const vk::DeviceSize verticesSizeInBytes,
+	                                    const vk::DeviceSize vertexSizeInBytes,
+	                                    const std::byte*     indices,
+	                                    const uint32_t       numIndices,
+	                                    const vk::IndexType  indexType)
+	{
+		if (vertexSizeInBytes == 0 || verticesSizeInBytes % vertexSizeInBytes != 0)
+		{
+			ErrorHandler::ThrowRuntimeError(std::format("Vertex data of {0} bytes isn't made of whole vertices of {1} bytes", verticesSizeInBytes, vertexSizeInBytes));
+		}
+
+		if (indexType != vk::IndexType::eUint16 && indexType != vk::IndexType::eUint32) { ErrorHandler::ThrowRuntimeError("Meshes only support 16 and 32 bit indices"); }
+
+		const vk::DeviceSize indexSizeInBytes = GetIndexSize(indexType);
+
+		Mesh mesh{};
+		mesh.VertexSizeInBytes = verticesSizeInBytes;
+		mesh.IndexSizeInBytes  = numIndices * indexSizeInBytes;
+		mesh.NumIndices        = numIndices;
+		mesh.IndexType         = indexType;
+
+		// Models can be loaded on worker threads
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		constexpr vk::BufferUsageFlags vertexUsage = vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer;
+		constexpr vk::BufferUsageFlags indexUsage  = vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer;
+
+		mesh.VertexBlockIndex = Allocate(_vertexBlocks, vertexUsage, _vertexBlockSizeInBytes, mesh.VertexSizeInBytes, vertexSizeInBytes, mesh.VertexOffsetInBytes);
+		mesh.IndexBlockIndex  = Allocate(_indexBlocks, indexUsage, _indexBlockSizeInBytes, mesh.IndexSizeInBytes, indexSizeInBytes, mesh.IndexOffsetInBytes);
+
+		mesh.VertexOffset = static_cast<int32_t>(mesh.VertexOffsetInBytes / vertexSizeInBytes);
+		mesh.FirstIndex   = static_cast<uint32_t>(mesh.IndexOffsetInBytes / indexSizeInBytes);
+
+		UploadManager& uploadManager = GetDevice()->GetPhysicalDevice().GetInstance().GetUploadManager();
+
+		uploadManager.UploadBuffer(_vertexBlocks[mesh.VertexBlockIndex].Buffer, vertices, mesh.VertexSizeInBytes, mesh.VertexOffsetInBytes);
+		const UploadManager::Ticket ticket = uploadManager.UploadBuffer(_indexBlocks[mesh.IndexBlockIndex].Buffer, indices, mesh.IndexSizeInBytes, mesh.IndexOffsetInBytes);
+
+		uploadManager.RequireForFrame(ticket);
+
+		return mesh;
+	}
+
+	uint32_t MeshArena::Allocate(std::deque<Block>&         blocks,
+	                             const vk::BufferUsageFlags usage,
+	                             const vk::DeviceSize       blockSizeInBytes,
+	                             const vk::DeviceSize       sizeInBytes,
+	                             const vk::DeviceSize       alignment,
+	                             vk::DeviceSize&            offsetInBytes) const
+	{
+		for (uint32_t blockIndex = 0; blockIndex < blocks.size(); ++blockIndex)
+		{
+			if (blocks[blockIndex].FreeRanges.TryAllocate(sizeInBytes, alignment, offsetInBytes)) { return blockIndex; }
+		}
+
+		const vk::DeviceSize newBlockSizeInBytes = std::max(blockSizeInBytes, sizeInBytes);
+
+		Block& block     = blocks.emplace_back();
+		block.Buffer     = Buffer(GetDevice(), usage, vk::SharingMode::eExclusive, { Allocator::GpuOnly }, 1u, newBlockSizeInBytes);
+		block.FreeRanges = FreeRangeList(newBlockSizeInBytes);
+
+		// Blocks never move inside the deque and are only referenced while recording, so they can be compacted by defragmentation
+		block.Buffer.EnableDefragmentation();
+
+		LOG("Allocated mesh block {0} of {1} bytes", blocks.size(), newBlockSizeInBytes);
+
+		static_cast<void>(block.FreeRanges.TryAllocate(sizeInBytes, alignment, offsetInBytes));
+
+		return static_cast<uint32_t>(blocks.size() - 1);
+	}
+
+	void MeshArena::Free(const Mesh& mesh)
+	{
+		if (mesh.VertexBlockIndex == -1u) { return; }
+
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_freedMeshes.push_back(mesh);
+	}
+
+	void MeshArena::Update()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		// The fence of this frame covers everything submitted before it, so nothing draws these meshes anymore
+		std::vector<Mesh>& retiredMeshes = _retiredMeshes.Get();
+		for (const Mesh& mesh: retiredMeshes)
+		{
+			_vertexBlocks[mesh.VertexBlockIndex].FreeRanges.Free(mesh.VertexOffsetInBytes, mesh.VertexSizeInBytes);
+			_indexBlocks[mesh.IndexBlockIndex].FreeRanges.Free(mesh.IndexOffsetInBytes, mesh.IndexSizeInBytes);
+		}
+
+		retiredMeshes.swap(_freedMeshes);
+		_freedMeshes.clear();
+	}
+
+	void MeshArena::Bind(const vk::CommandBuffer& commandBuffer, const Mesh& mesh) const
+	{
+		const vk::Buffer         vertexBuffers[] = { _vertexBlocks[mesh.VertexBlockIndex].Buffer.GetVkBuffer() };
+		constexpr vk::DeviceSize offsets[]       = { 0 };
+
+		commandBuffer.bindVertexBuffers(0, 1, vertexBuffers, offsets);
+		commandBuffer.bindIndexBuffer(_indexBlocks[mesh.IndexBlockIndex].Buffer.GetVkBuffer(), 0, mesh.IndexType);
+	}
+
+	const Buffer& MeshArena::GetVertexBuffer(const uint32_t blockIndex) const { return _vertexBlocks[blockIndex].Buffer; }
+
+	const Buffer& MeshArena::GetIndexBuffer(const uint32_t blockIndex) const { return _indexBlocks[blockIndex].Buffer; }
+
+	std::unique_lock<std::mutex> MeshArena::Lock() { return std::unique_lock<std::mutex>(_mutex); }
+
+	void MeshArena::Destroy()
+	{
+		for (Block& block: _vertexBlocks) { block.Buffer.Destroy(); }
+		for (Block& block: _indexBlocks) { block.Buffer.Destroy(); }
+
+		_vertexBlocks.clear();
+		_indexBlocks.clear();
+		_freedMeshes.clear();
+		_retiredMeshes = {};
+	}
+}
@@ -0,0 +1,112 @@
+#include "SplitEngine/Rendering/Vulkan/OffscreenTargets.hpp"
+
+#include "SplitEngine/ErrorHandler.hpp"
+#include "SplitEngine/Rendering/Vulkan/Device.hpp"
+#include "SplitEngine/Rendering/Vulkan/PhysicalDevice.hpp"
+#include "SplitEngine/Rendering/Vulkan/Utility.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	OffscreenTargets::OffscreenTargets(Device* device, const vk::Extent2D size, const uint32_t numImages, const bool readback) :
+		DeviceObject(device),
+		_extend(size)
+	{
+		const vk::Format format = GetDevice()->GetPhysicalDevice().GetImageFormat().format;
+
+		// The render pass takes care of the layouts, so the images don't need a transition of their own
+		Image::CreateInfo imageCreateInfo{};
+		imageCreateInfo.Usage            = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc;
+		imageCreateInfo.TransitionLayout = vk::ImageLayout::eUndefined;
+		imageCreateInfo.Format           = format;
+		imageCreateInfo.RequiredFlags    = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+		// Create depth image, frames in flight never overlap in the render pass so one is enough just like for the swapchain
+		Image::CreateInfo depthImageCreateInfo{};
+		depthImageCreateInfo.Usage            = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+		depthImageCreateInfo.TransitionLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+		depthImageCreateInfo.AspectMask       = vk::ImageAspectFlagBits::eDepth;
+		depthImageCreateInfo.Format           = GetDevice()->GetPhysicalDevice().GetDepthImageFormat();
+		depthImageCreateInfo.RequiredFlags    = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+		_depthImage = Image(GetDevice(), nullptr, 0, { _extend.width, _extend.height, 1 }, depthImageCreateInfo);
+
+		const vk::DeviceSize readbackSizeInBytes = static_cast<vk::DeviceSize>(_extend.width) * _extend.height * 4;
+
+		for (uint32_t i = 0; i < numImages; ++i)
+		{
+			_images.emplace_back(GetDevice(), nullptr, 0, vk::Extent3D(_extend.width, _extend.height, 1), imageCreateInfo);
+
+			std::vector<vk::ImageView> attachments = { _images.back().GetView(), _depthImage.GetView() };
+
+			vk::FramebufferCreateInfo framebufferInfo = vk::FramebufferCreateInfo({}, device->GetRenderPass().GetVkRenderPass(), attachments, _extend.width, _extend.height, 1);
+			_frameBuffers.push_back(device->GetVkDevice().createFramebuffer(framebufferInfo));
+
+			if (readback)
+			{
+				_readbackBuffers.emplace_back(GetDevice(),
+				                              vk::BufferUsageFlagBits::eTransferDst,
+				                              vk::SharingMode::eExclusive,
+				                              Allocator::MemoryAllocationCreateInfo{ Allocator::Auto, vk::Flags<Allocator::MemoryAllocationCreateFlagBits>(Allocator::RandomAccess | Allocator::PersistentMap) },
+				                              nullptr,
+				                              readbackSizeInBytes,
+				                              readbackSizeInBytes);
+			}
+		}
+	}
+
+	void OffscreenTargets::RecordReadback(const vk::CommandBuffer& commandBuffer, const uint32_t imageIndex) const
+	{
+		if (_readbackBuffers.empty()) { return; }
+
+		const vk::BufferImageCopy copyRegion = vk::BufferImageCopy(0, 0, 0, { vk::ImageAspectFlagBits::eColor, 0, 0, 1 }, { 0, 0, 0 }, { _extend.width, _extend.height, 1 });
+
+		commandBuffer.copyImageToBuffer(_images[imageIndex].GetVkImage(), vk::ImageLayout::eTransferSrcOptimal, _readbackBuffers[imageIndex].GetVkBuffer(), copyRegion);
+
+		// The fence of the frame only covers device access, the host needs this to see the copy
+		const vk::MemoryBarrier hostBarrier = vk::MemoryBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead);
+		commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, hostBarrier, nullptr, nullptr);
+	}
+
+	IO::Image OffscreenTargets::ReadBack(const uint32_t imageIndex) const
+	{
+		if (_readbackBuffers.empty()) { ErrorHandler::ThrowRuntimeError("Can't read back offscreen images, readback hasn't been enabled in the rendering settings"); }
+
+		const Buffer& readbackBuffer = _readbackBuffers[imageIndex];
+
+		IO::Image image{};
+		image.Width    = _extend.width;
+		image.Height   = _extend.height;
+		image.Channels = 4;
+		image.Pixels.resize(image.GetMipLevelSizeInBytes(0));
+
+		readbackBuffer.Invalidate(0, image.Pixels.size());
+		memcpy(image.Pixels.data(), readbackBuffer.GetMappedData(), image.Pixels.size());
+
+		if (_images[imageIndex].GetFormat() == vk::Format::eB8G8R8A8Srgb)
+		{
+			for (size_t i = 0; i < image.Pixels.size(); i += 4) { std::swap(image.Pixels[i], image.Pixels[i + 2]); }
+		}
+
+		return image;
+	}
+
+	const std::vector<Image>& OffscreenTargets::GetImages() const { return _images; }
+
+	const vk::Extent2D& OffscreenTargets::GetExtend() const { return _extend; }
+
+	const std::vector<vk::Framebuffer>& OffscreenTargets::GetFrameBuffers() const { return _frameBuffers; }
+
+	bool OffscreenTargets::HasReadback() const { return !_readbackBuffers.empty(); }
+
+	void OffscreenTargets::Destroy()
+	{
+		for (const vk::Framebuffer& frameBuffer: _frameBuffers) { Utility::DeleteDeviceHandle(GetDevice(), frameBuffer); }
+		for (Image& image: _images) { image.Destroy(); }
+		for (Buffer& readbackBuffer: _readbackBuffers) { readbackBuffer.Destroy(); }
+
+		_depthImage.Destroy();
+	}
+}
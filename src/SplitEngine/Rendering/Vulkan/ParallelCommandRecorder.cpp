@@ -0,0 +1,207 @@
+#include "SplitEngine/Rendering/Vulkan/ParallelCommandRecorder.hpp"
+
+#include "SplitEngine/Rendering/Vulkan/Device.hpp"
+#include "SplitEngine/Rendering/Vulkan/Instance.hpp"
+#include "SplitEngine/Rendering/Vulkan/QueueFamily.hpp"
+#include "SplitEngine/Rendering/Vulkan/Utility.hpp"
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	ParallelCommandRecorder::ParallelCommandRecorder(Device* device, const uint32_t numWorkers) :
+		DeviceObject(device)
+	{
+		const QueueFamily& queueFamily = device->GetQueueFamily(QueueType::Graphics);
+
+		_workerFrames.reserve(numWorkers + 1);
+		for (uint32_t i = 0; i < numWorkers + 1; ++i)
+		{
+			InFlightResource<WorkerFrame> workerFrames = device->CreateInFlightResource<WorkerFrame>();
+			for (WorkerFrame& workerFrame: workerFrames.GetDataVector()) { workerFrame.CommandPool = queueFamily.CreateCommandPool(vk::CommandPoolCreateFlagBits::eTransient); }
+
+			_workerFrames.push_back(std::move(workerFrames));
+		}
+
+		_inlineCommandBuffer = CommandBuffer(device, QueueType::Graphics, device->CreateInFlightResource<vk::CommandBuffer>(), VK_NULL_HANDLE);
+
+		_workers.reserve(numWorkers);
+		for (uint32_t i = 0; i < numWorkers; ++i) { _workers.emplace_back([this, i](const std::stop_token& stopToken) { WorkerLoop(stopToken, i); }); }
+	}
+
+	void ParallelCommandRecorder::BeginFrame(const vk::RenderPass&                  renderPass,
+	                                         const vk::Framebuffer&                 framebuffer,
+	                                         const vk::Viewport&                    viewport,
+	                                         const vk::Rect2D&                      scissor,
+	                                         const vk::QueryPipelineStatisticFlags& inheritedPipelineStatistics)
+	{
+		// Command buffers allocated from the pools are kept around, resetting the pool only resets their recording state
+		for (InFlightResource<WorkerFrame>& workerFrames: _workerFrames)
+		{
+			WorkerFrame& workerFrame = workerFrames.Get();
+
+			GetDevice()->GetVkDevice().resetCommandPool(workerFrame.CommandPool);
+			workerFrame.NumUsed = 0;
+		}
+
+		_inheritanceInfo = vk::CommandBufferInheritanceInfo(renderPass, 0, framebuffer, vk::False, {}, inheritedPipelineStatistics);
+		_viewport        = viewport;
+		_scissor         = scissor;
+
+		_executionOrder.clear();
+
+		BeginInlineSegment();
+	}
+
+	void ParallelCommandRecorder::EndFrame(const vk::CommandBuffer& primaryCommandBuffer)
+	{
+		EndInlineSegment();
+
+		primaryCommandBuffer.executeCommands(_executionOrder);
+	}
+
+	void ParallelCommandRecorder::Record(const uint32_t numJobs, const RecordFunction& recordFunction)
+	{
+		if (numJobs == 0) { return; }
+
+		// Everything recorded inline so far needs to run before the jobs
+		EndInlineSegment();
+
+		// Jobs only bind sets, flushing pending descriptor writes from multiple threads at once would race
+		GetDevice()->GetPhysicalDevice().GetInstance().GetDescriptorWriteBatch().Flush();
+
+		_recordFunction = &recordFunction;
+		_numJobs        = numJobs;
+		_nextJob        = 0;
+		_exception      = nullptr;
+		_jobCommandBuffers.assign(numJobs, VK_NULL_HANDLE);
+
+		if (!_workers.empty())
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_numBusyWorkers = static_cast<uint32_t>(_workers.size());
+				_generation++;
+			}
+
+			_workAvailable.notify_all();
+		}
+
+		RecordJobs(static_cast<uint32_t>(_workers.size()));
+
+		if (!_workers.empty())
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_workDone.wait(lock, [this] { return _numBusyWorkers == 0; });
+		}
+
+		_recordFunction = nullptr;
+
+		for (const vk::CommandBuffer& commandBuffer: _jobCommandBuffers) { if (commandBuffer != VK_NULL_HANDLE) { _executionOrder.push_back(commandBuffer); } }
+
+		BeginInlineSegment();
+
+		if (_exception != nullptr) { std::rethrow_exception(_exception); }
+	}
+
+	CommandBuffer& ParallelCommandRecorder::GetInlineCommandBuffer() { return _inlineCommandBuffer; }
+
+	uint32_t ParallelCommandRecorder::GetNumWorkers() const { return static_cast<uint32_t>(_workers.size()); }
+
+	void ParallelCommandRecorder::Destroy()
+	{
+		// Destroying the threads requests them to stop and joins them
+		_workers.clear();
+
+		for (InFlightResource<WorkerFrame>& workerFrames: _workerFrames)
+		{
+			for (WorkerFrame& workerFrame: workerFrames.GetDataVector())
+			{
+				// Destroying the pool also frees every command buffer allocated from it
+				Utility::DeleteDeviceHandle(GetDevice(), workerFrame.CommandPool);
+				workerFrame.CommandBuffers.clear();
+			}
+		}
+	}
+
+	void ParallelCommandRecorder::WorkerLoop(const std::stop_token& stopToken, const uint32_t workerIndex)
+	{
+		uint64_t seenGeneration = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				if (!_workAvailable.wait(lock, stopToken, [this, &seenGeneration] { return _generation != seenGeneration; })) { return; }
+
+				seenGeneration = _generation;
+			}
+
+			RecordJobs(workerIndex);
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (--_numBusyWorkers == 0) { _workDone.notify_one(); }
+			}
+		}
+	}
+
+	void ParallelCommandRecorder::RecordJobs(const uint32_t workerIndex)
+	{
+		for (uint32_t jobIndex = _nextJob++; jobIndex < _numJobs; jobIndex = _nextJob++)
+		{
+			try
+			{
+				vk::CommandBuffer commandBuffer = BeginSecondary(workerIndex);
+
+				(*_recordFunction)(jobIndex, commandBuffer);
+
+				commandBuffer.end();
+
+				_jobCommandBuffers[jobIndex] = commandBuffer;
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (_exception == nullptr) { _exception = std::current_exception(); }
+			}
+		}
+	}
+
+	vk::CommandBuffer ParallelCommandRecorder::BeginSecondary(const uint32_t workerIndex)
+	{
+		WorkerFrame& workerFrame = _workerFrames[workerIndex].Get();
+
+		// Every pool only ever gets touched by its own thread so allocating here is fine
+		if (workerFrame.NumUsed == workerFrame.CommandBuffers.size())
+		{
+			workerFrame.CommandBuffers.push_back(GetDevice()->GetQueueFamily(QueueType::Graphics).AllocateCommandBuffer(QueueType::Graphics,
+			                                                                                                           vk::CommandBufferLevel::eSecondary,
+			                                                                                                           true,
+			                                                                                                           workerFrame.CommandPool));
+		}
+
+		vk::CommandBuffer commandBuffer = workerFrame.CommandBuffers[workerFrame.NumUsed++].GetVkCommandBuffer();
+
+		const vk::CommandBufferBeginInfo beginInfo = vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+		                                                                        &_inheritanceInfo);
+
+		commandBuffer.begin(beginInfo);
+
+		// Dynamic state isn't inherited from the primary command buffer
+		commandBuffer.setViewport(0, 1, &_viewport);
+		commandBuffer.setScissor(0, 1, &_scissor);
+
+		return commandBuffer;
+	}
+
+	void ParallelCommandRecorder::BeginInlineSegment()
+	{
+		_inlineCommandBuffer.GetVkCommandBufferRaw().Get() = BeginSecondary(static_cast<uint32_t>(_workers.size()));
+	}
+
+	void ParallelCommandRecorder::EndInlineSegment()
+	{
+		vk::CommandBuffer& commandBuffer = _inlineCommandBuffer.GetVkCommandBufferRaw().Get();
+
+		commandBuffer.end();
+		_executionOrder.push_back(commandBuffer);
+	}
+}
@@ -6,12 +6,33 @@
 #include "SplitEngine/Debug/Log.hpp"
 
 #include <set>
+#include <string_view>
 #include <utility>
 
 #include "SplitEngine/Rendering/Vulkan/Instance.hpp"
 
 namespace SplitEngine::Rendering::Vulkan
 {
+	namespace
+	{
+		std::vector<vk::SurfaceFormatKHR> GetOffscreenFormats(const vk::PhysicalDevice& physicalDevice)
+		{
+			// Offscreen images get rendered to and copied from for readbacks
+			constexpr vk::FormatFeatureFlags requiredFeatures = vk::FormatFeatureFlagBits::eColorAttachment | vk::FormatFeatureFlagBits::eTransferSrc;
+
+			std::vector<vk::SurfaceFormatKHR> formats{};
+			for (const vk::Format format: { vk::Format::eB8G8R8A8Srgb, vk::Format::eR8G8B8A8Srgb })
+			{
+				if ((physicalDevice.getFormatProperties(format).optimalTilingFeatures & requiredFeatures) == requiredFeatures)
+				{
+					formats.emplace_back(format, vk::ColorSpaceKHR::eSrgbNonlinear);
+				}
+			}
+
+			return formats;
+		}
+	}
+
 	bool PhysicalDevice::IsQueueFamilyIndicesCompleted()
 	{
 		return std::ranges::all_of(_queueFamilyInfos, [](const QueueFamilyInfo& family) { return family.Index != std::numeric_limits<uint32_t>::max() && family.QueueCount != 0; });
@@ -21,6 +42,8 @@ namespace SplitEngine::Rendering::Vulkan
 	{
 		const std::vector<vk::QueueFamilyProperties> queueFamilyProperties = physicalDevice.getQueueFamilyProperties();
 
+		const bool headless = instance.GetRenderingSettings().Headless;
+
 		// in the first iteration try to fit every command type into a seperate queue, in the second Iteration fill out the remaining queues
 		for (int tryIteration = 0; tryIteration < 2; ++tryIteration)
 		{
@@ -50,8 +73,9 @@ namespace SplitEngine::Rendering::Vulkan
 					if (tryIteration == 0) { continue; }
 				}
 
-				// Present queue
-				if (physicalDevice.getSurfaceSupportKHR(i, instance.GetVkSurface()) && _queueFamilyInfos[static_cast<size_t>(QueueType::Present)].Index == std::numeric_limits<
+				// Present queue, nothing gets presented in headless mode so any graphics queue will do to keep the lookups valid
+				const bool supportsPresent = headless ? static_cast<bool>(queueFamily.queueFlags & vk::QueueFlagBits::eGraphics) : physicalDevice.getSurfaceSupportKHR(i, instance.GetVkSurface());
+				if (supportsPresent && _queueFamilyInfos[static_cast<size_t>(QueueType::Present)].Index == std::numeric_limits<
 					    uint32_t>::max())
 				{
 					LOG("Present Family Index: {0}", i);
@@ -77,7 +101,10 @@ namespace SplitEngine::Rendering::Vulkan
 		}
 	}
 
-	PhysicalDevice::PhysicalDevice(Instance& instance, std::vector<const char*> _requiredExtensions, std::vector<const char*> _requiredValidationLayers) :
+	PhysicalDevice::PhysicalDevice(Instance&                       instance,
+	                               std::vector<const char*>        _requiredExtensions,
+	                               std::vector<const char*>        _requiredValidationLayers,
+	                               const std::vector<const char*>& optionalExtensions) :
 		_instance(instance),
 		_extensions(_requiredExtensions),
 		_validationLayers(std::move(_requiredValidationLayers))
@@ -119,14 +146,20 @@ namespace SplitEngine::Rendering::Vulkan
 
 				if (!IsQueueFamilyIndicesCompleted()) { continue; }
 
-				// Check swap chain support
+				// Check swap chain support, in headless mode only the formats of the offscreen images matter
 				_swapchainSupportDetails = SwapchainSupportDetails();
 
-				_swapchainSupportDetails.Capabilities = physicalDevice.getSurfaceCapabilitiesKHR(instance.GetVkSurface());
-				_swapchainSupportDetails.Formats      = physicalDevice.getSurfaceFormatsKHR(instance.GetVkSurface());
-				_swapchainSupportDetails.PresentModes = physicalDevice.getSurfacePresentModesKHR(instance.GetVkSurface());
+				if (_instance.GetRenderingSettings().Headless) { _swapchainSupportDetails.Formats = GetOffscreenFormats(physicalDevice); }
+				else
+				{
+					_swapchainSupportDetails.Capabilities = physicalDevice.getSurfaceCapabilitiesKHR(instance.GetVkSurface());
+					_swapchainSupportDetails.Formats      = physicalDevice.getSurfaceFormatsKHR(instance.GetVkSurface());
+					_swapchainSupportDetails.PresentModes = physicalDevice.getSurfacePresentModesKHR(instance.GetVkSurface());
+
+					if (_swapchainSupportDetails.PresentModes.empty()) { continue; }
+				}
 
-				if (_swapchainSupportDetails.Formats.empty() || _swapchainSupportDetails.PresentModes.empty()) { continue; }
+				if (_swapchainSupportDetails.Formats.empty()) { continue; }
 
 				size_t points = 0;
 				if (_properties.deviceType == vk::PhysicalDeviceType::eDiscreteGpu) { points += 100; }
@@ -148,12 +181,26 @@ namespace SplitEngine::Rendering::Vulkan
 
 			// Select top GPU
 			_vkPhysicalDevice = physicalDeviceRating.rbegin()->second;
+			_properties       = _vkPhysicalDevice.getProperties();
 
 			break;
 		}
 
 		LOG("Selected physical device: {0}", _vkPhysicalDevice.getProperties().deviceName.data());
 
+		const std::vector<vk::ExtensionProperties> availableExtensions = _vkPhysicalDevice.enumerateDeviceExtensionProperties();
+		for (const char* optionalExtension: optionalExtensions)
+		{
+			const bool isAvailable = std::ranges::any_of(availableExtensions,
+			                                             [optionalExtension](const vk::ExtensionProperties& extension)
+			                                             {
+				                                             return std::string_view(extension.extensionName.data()) == optionalExtension;
+			                                             });
+
+			if (isAvailable) { _extensions.push_back(optionalExtension); }
+			else { LOG_WARNING("Optional device extension {0} isn't supported", optionalExtension); }
+		}
+
 		// Select image format
 		_imageFormat = _swapchainSupportDetails.Formats[0];
 		for (const auto& availableFormat: _swapchainSupportDetails.Formats)
@@ -194,6 +241,11 @@ namespace SplitEngine::Rendering::Vulkan
 
 	const std::vector<const char*>& PhysicalDevice::GetExtensions() const { return _extensions; }
 
+	bool PhysicalDevice::IsExtensionEnabled(const std::string_view extension) const
+	{
+		return std::ranges::any_of(_extensions, [extension](const char* enabledExtension) { return enabledExtension == extension; });
+	}
+
 	const std::vector<const char*>& PhysicalDevice::GetValidationLayers() const { return _validationLayers; }
 
 	const vk::SurfaceFormatKHR& PhysicalDevice::GetImageFormat() const { return _imageFormat; }
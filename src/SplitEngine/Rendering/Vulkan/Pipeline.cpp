@@ -1,9 +1,10 @@
 #include "SplitEngine/Rendering/Vulkan/Pipeline.hpp"
 
-#include "spirv_cross/spirv_cross.hpp"
 #include "SplitEngine/Application.hpp"
 #include "SplitEngine/ErrorHandler.hpp"
 #include "SplitEngine/IO/Stream.hpp"
+#include "SplitEngine/Rendering/Vulkan/BindlessTextureTable.hpp"
+#include "SplitEngine/Rendering/Vulkan/ShaderReflection.hpp"
 #include "SplitEngine/Rendering/Vulkan/Utility.hpp"
 #include "SplitEngine/Utility/String.hpp"
 
@@ -13,7 +14,8 @@ namespace SplitEngine::Rendering::Vulkan
 {
 	DescriptorSetAllocator             Pipeline::_globalDescriptorManager{};
 	DescriptorSetAllocator::Allocation Pipeline::_globalDescriptorSetAllocation;
-	bool                               Pipeline::_globalDescriptorsProcessed = false;
+	std::atomic<bool>                  Pipeline::_globalDescriptorsProcessed = false;
+	std::mutex                         Pipeline::_descriptorSetupMutex{};
 
 	Pipeline::Pipeline(Device* device, const std::string& name, const std::vector<ShaderInfo>& shaderInfos, PipelineCreateInfo createInfo) :
 		DeviceObject(device)
@@ -48,177 +50,221 @@ namespace SplitEngine::Rendering::Vulkan
 			std::vector<uint32_t>   shaderCode = IO::Stream::ReadRawAndClose<uint32_t>(shaderInfos[i].path, IO::Binary);
 			vk::ShaderStageFlagBits stageFlag  = GetShaderStageFromShaderType(shaderInfos[i].shaderStage);
 
-			// Reflect shader and create Descriptor resources
-			spirv_cross::Compiler spirvCompiler = spirv_cross::Compiler(shaderCode);
-
-			spirv_cross::ShaderResources shaderResources = spirvCompiler.get_shader_resources();
-
-			// Uniform Buffers
-			std::unordered_map<vk::DescriptorType, const spirv_cross::SmallVector<spirv_cross::Resource>&> resourceMap = {
-				{ vk::DescriptorType::eUniformBuffer, shaderResources.uniform_buffers },
-				{ vk::DescriptorType::eStorageBuffer, shaderResources.storage_buffers },
-				{ vk::DescriptorType::eCombinedImageSampler, shaderResources.sampled_images },
-			};
+			// Reflect shader (or load the cached reflection) and create Descriptor resources
+			const ShaderReflection reflection = ShaderReflection::LoadOrReflect(shaderInfos[i].path, shaderCode, shaderParserSettings.ShaderReflectionFileExtension);
 
 			// Setup descriptor layout
-			for (const auto& [type, resources]: resourceMap)
+			for (const ShaderReflection::Resource& resource: reflection.Resources)
 			{
-				for (const spirv_cross::Resource& resource: resources)
-				{
-					// Check if we already have a layout binding with the same binding index if true add the current shader stage to its shader stage mask
-					uint32_t binding = spirvCompiler.get_decoration(resource.id, spv::DecorationBinding);
-					uint32_t set     = spirvCompiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+				const vk::DescriptorType type = resource.Type;
 
-					// Exit if a set higher than 2 is specified (it isn't supported)
-					if (set > 2)
-					{
-						ErrorHandler::ThrowRuntimeError(std::format("set decoration in shader {0} can't be higher than 2 (0 = global set, 1 = pipeline set, 2 = material set)",
-						                                            shaderInfos[i].path.string()));
-					}
+				// Check if we already have a layout binding with the same binding index if true add the current shader stage to its shader stage mask
+				uint32_t binding = resource.Binding;
+				uint32_t set     = resource.Set;
+
+				// Exit if a set higher than 2 is specified (it isn't supported)
+				if (set > 2)
+				{
+					ErrorHandler::ThrowRuntimeError(std::format("set decoration in shader {0} can't be higher than 2 (0 = global set, 1 = pipeline set, 2 = material set)",
+					                                            shaderInfos[i].path.string()));
+				}
 
-					// Skip global descriptor if we've already processed it
-					if (set == 0 && _globalDescriptorsProcessed) { continue; }
+				// Skip global descriptor if we've already processed it
+				if (set == 0 && _globalDescriptorsProcessed) { continue; }
 
-					DescriptorSetAllocator::CreateInfo& descriptorSetInfo = _descriptorSetInfos[set];
+				DescriptorSetAllocator::CreateInfo& descriptorSetInfo = _descriptorSetInfos[set];
 
-					// If we already processed the binding we just add the shader stage to it and move on to the next resource
-					if (descriptorSetInfo.Bindings.contains(binding))
+				// If we already processed the binding we just add the shader stage to it and move on to the next resource
+				if (descriptorSetInfo.Bindings.contains(binding))
+				{
+					for (vk::DescriptorSetLayoutBinding& descriptorLayoutBinding: descriptorSetInfo.DescriptorLayoutBindings)
 					{
-						for (vk::DescriptorSetLayoutBinding& descriptorLayoutBinding: descriptorSetInfo.DescriptorLayoutBindings)
+						if (descriptorLayoutBinding.binding == binding)
 						{
-							if (descriptorLayoutBinding.binding == binding)
-							{
-								descriptorLayoutBinding.stageFlags |= stageFlag;
-								break;
-							}
+							descriptorLayoutBinding.stageFlags |= stageFlag;
+							break;
 						}
-						continue;
 					}
+					continue;
+				}
 
-					DescriptorSetAllocator::DescriptorCreateInfo descriptorCreateInfo{};
-
-					const spirv_cross::SPIRType& resourceBaseType = spirvCompiler.get_type(resource.base_type_id);
-					const spirv_cross::SPIRType& resourceType     = spirvCompiler.get_type(resource.type_id);
+				DescriptorSetAllocator::DescriptorCreateInfo descriptorCreateInfo{};
 
-					// Parse name to find modifiers
-					descriptorCreateInfo.Name          = resource.name;
-					std::vector<std::string> splitName = SplitEngine::Utility::String::Split(descriptorCreateInfo.Name, shaderParserSettings.ShaderBufferModDelimiter, 0);
+				// Parse name to find modifiers
+				descriptorCreateInfo.Name          = resource.Name;
+				std::vector<std::string> splitName = SplitEngine::Utility::String::Split(descriptorCreateInfo.Name, shaderParserSettings.ShaderBufferModDelimiter, 0);
 
-					for (std::string& split: splitName)
+				for (std::string& split: splitName)
+				{
+					if (!descriptorCreateInfo.SingleInstance)
 					{
-						if (!descriptorCreateInfo.SingleInstance)
-						{
-							descriptorCreateInfo.SingleInstance = std::ranges::find(shaderParserSettings.ShaderPropertySingleInstanceModPrefixes, split) != shaderParserSettings.
-							                                      ShaderPropertySingleInstanceModPrefixes.end();
-						}
+						descriptorCreateInfo.SingleInstance = std::ranges::find(shaderParserSettings.ShaderPropertySingleInstanceModPrefixes, split) != shaderParserSettings.
+						                                      ShaderPropertySingleInstanceModPrefixes.end();
+					}
 
-						if (!descriptorCreateInfo.DeviceLocal)
-						{
-							descriptorCreateInfo.DeviceLocal = std::ranges::find(shaderParserSettings.ShaderBufferDeviceLocalModPrefixes, split) != shaderParserSettings.
-							                                   ShaderBufferDeviceLocalModPrefixes.end();
-						}
+					if (!descriptorCreateInfo.DeviceLocal)
+					{
+						descriptorCreateInfo.DeviceLocal = std::ranges::find(shaderParserSettings.ShaderBufferDeviceLocalModPrefixes, split) != shaderParserSettings.
+						                                   ShaderBufferDeviceLocalModPrefixes.end();
+					}
 
-						if (!descriptorCreateInfo.DeviceLocalHostVisible)
-						{
-							descriptorCreateInfo.DeviceLocalHostVisible =
-									std::ranges::find(shaderParserSettings.ShaderBufferDeviceLocalHostVisibleModPrefixes, split) != shaderParserSettings.
-									ShaderBufferDeviceLocalHostVisibleModPrefixes.end();
-						}
+					if (!descriptorCreateInfo.DeviceLocalHostVisible)
+					{
+						descriptorCreateInfo.DeviceLocalHostVisible =
+								std::ranges::find(shaderParserSettings.ShaderBufferDeviceLocalHostVisibleModPrefixes, split) != shaderParserSettings.
+								ShaderBufferDeviceLocalHostVisibleModPrefixes.end();
+					}
 
-						if (!descriptorCreateInfo.Cached)
-						{
-							descriptorCreateInfo.Cached = std::ranges::find(shaderParserSettings.ShaderBufferCacheModPrefixes, split) != shaderParserSettings.
-							                              ShaderBufferCacheModPrefixes.end();
-						}
+					if (!descriptorCreateInfo.Cached)
+					{
+						descriptorCreateInfo.Cached = std::ranges::find(shaderParserSettings.ShaderBufferCacheModPrefixes, split) != shaderParserSettings.
+						                              ShaderBufferCacheModPrefixes.end();
+					}
 
-						if (!descriptorCreateInfo.Shared)
-						{
-							descriptorCreateInfo.Shared = std::ranges::find(shaderParserSettings.ShaderPropertySharedModPrefixes, split) != shaderParserSettings.
-							                              ShaderPropertySharedModPrefixes.end();
-						}
+					if (!descriptorCreateInfo.Shared)
+					{
+						descriptorCreateInfo.Shared = std::ranges::find(shaderParserSettings.ShaderPropertySharedModPrefixes, split) != shaderParserSettings.
+						                              ShaderPropertySharedModPrefixes.end();
+					}
 
-						if (!descriptorCreateInfo.NoAllocation)
-						{
-							descriptorCreateInfo.NoAllocation = std::ranges::find(shaderParserSettings.ShaderBufferNoAllocModPrefixes, split) != shaderParserSettings.
-							                                    ShaderBufferNoAllocModPrefixes.end();
-						}
+					if (!descriptorCreateInfo.NoAllocation)
+					{
+						descriptorCreateInfo.NoAllocation = std::ranges::find(shaderParserSettings.ShaderBufferNoAllocModPrefixes, split) != shaderParserSettings.
+						                                    ShaderBufferNoAllocModPrefixes.end();
+					}
 
-						if (!descriptorCreateInfo.NoCoherant)
-						{
-							descriptorCreateInfo.NoCoherant = std::ranges::find(shaderParserSettings.ShaderBufferNoCoherantModPrefixes, split) != shaderParserSettings.
-							                                  ShaderBufferNoCoherantModPrefixes.end();
-						}
+					if (!descriptorCreateInfo.NoCoherant)
+					{
+						descriptorCreateInfo.NoCoherant = std::ranges::find(shaderParserSettings.ShaderBufferNoCoherantModPrefixes, split) != shaderParserSettings.
+						                                  ShaderBufferNoCoherantModPrefixes.end();
+					}
 
-						if (!descriptorCreateInfo.TransferSrc)
-						{
-							descriptorCreateInfo.TransferSrc = std::ranges::find(shaderParserSettings.ShaderBufferTransferSrcModPrefixes, split) != shaderParserSettings.
-							                                   ShaderBufferTransferSrcModPrefixes.end();
-						}
+					if (!descriptorCreateInfo.TransferSrc)
+					{
+						descriptorCreateInfo.TransferSrc = std::ranges::find(shaderParserSettings.ShaderBufferTransferSrcModPrefixes, split) != shaderParserSettings.
+						                                   ShaderBufferTransferSrcModPrefixes.end();
+					}
 
-						if (!descriptorCreateInfo.TransferDst)
-						{
-							descriptorCreateInfo.TransferDst = std::ranges::find(shaderParserSettings.ShaderBufferTransferDstModPrefixes, split) != shaderParserSettings.
-							                                   ShaderBufferTransferDstModPrefixes.end();
-						}
+					if (!descriptorCreateInfo.TransferDst)
+					{
+						descriptorCreateInfo.TransferDst = std::ranges::find(shaderParserSettings.ShaderBufferTransferDstModPrefixes, split) != shaderParserSettings.
+						                                   ShaderBufferTransferDstModPrefixes.end();
 					}
 
-					// Create binding
-					uint32_t descriptorCount = 1;
-					if (!resourceType.array.empty()) { descriptorCount = resourceType.array[0]; }
+					if (!descriptorCreateInfo.Dynamic)
+					{
+						descriptorCreateInfo.Dynamic = std::ranges::find(shaderParserSettings.ShaderBufferDynamicModPrefixes, split) != shaderParserSettings.
+						                               ShaderBufferDynamicModPrefixes.end();
+					}
 
-					// Bind everywhere if set is global or if property is shared
-					vk::ShaderStageFlagBits        shaderStageFlagBits = descriptorCreateInfo.Shared || set == 0 ? vk::ShaderStageFlagBits::eAll : stageFlag;
-					vk::DescriptorSetLayoutBinding layoutBinding       = vk::DescriptorSetLayoutBinding(binding, type, descriptorCount, shaderStageFlagBits);
+					if (!descriptorCreateInfo.Bindless)
+					{
+						descriptorCreateInfo.Bindless = std::ranges::find(shaderParserSettings.ShaderPropertyBindlessModPrefixes, split) != shaderParserSettings.
+						                                ShaderPropertyBindlessModPrefixes.end();
+					}
+				}
 
+				// Dynamic buffers get their memory from a transient allocator at bind time, so nothing needs to be allocated up front
+				vk::DescriptorType descriptorType = type;
+				if (descriptorCreateInfo.Dynamic)
+				{
 					switch (type)
 					{
-						case vk::DescriptorType::eStorageBuffer:
 						case vk::DescriptorType::eUniformBuffer:
-						{
-							vk::DeviceSize uniformSize = spirvCompiler.get_declared_struct_size(resourceBaseType);
+							descriptorType = vk::DescriptorType::eUniformBufferDynamic;
+							break;
+						case vk::DescriptorType::eStorageBuffer:
+							descriptorType = vk::DescriptorType::eStorageBufferDynamic;
+							break;
+						default:
+							ErrorHandler::ThrowRuntimeError(std::format("Only uniform and storage buffers can be dynamic ({0})", descriptorCreateInfo.Name));
+					}
+
+					descriptorCreateInfo.NoAllocation = true;
+				}
 
-							descriptorSetInfo.WriteDescriptorSets.emplace_back();
+				// Create binding
+				uint32_t descriptorCount = resource.DescriptorCount;
 
-							size_t offset = 0;
-							for (int j = 0; j < Device::MAX_FRAMES_IN_FLIGHT; ++j)
-							{
-								vk::DeviceSize minAlignment = type == vk::DescriptorType::eStorageBuffer
-									                              ? device->GetPhysicalDevice().GetProperties().limits.minStorageBufferOffsetAlignment
-									                              : device->GetPhysicalDevice().GetProperties().limits.minUniformBufferOffsetAlignment;
+				// The bindless table gets written by the BindlessTextureTable, so the size of the array comes from there
+				if (descriptorCreateInfo.Bindless)
+				{
+					const BindlessTextureTable& bindlessTextureTable = GetDevice()->GetPhysicalDevice().GetInstance().GetBindlessTextureTable();
 
-								vk::DeviceSize padding = minAlignment - (uniformSize % minAlignment);
-								padding                = padding == minAlignment ? 0 : padding;
+					if (type != vk::DescriptorType::eCombinedImageSampler || set != 0)
+					{
+						ErrorHandler::ThrowRuntimeError(std::format("Only sampler arrays in the global set can be bindless ({0})", descriptorCreateInfo.Name));
+					}
 
-								descriptorSetInfo.WriteDescriptorSets.back().emplace_back(VK_NULL_HANDLE, binding, 0, descriptorCount, type, nullptr, nullptr, nullptr);
-								descriptorSetInfo.WriteDescriptorSets.back().back().pBufferInfo = new vk::DescriptorBufferInfo(VK_NULL_HANDLE, offset, uniformSize + padding);
+					if (!bindlessTextureTable.IsSupported())
+					{
+						ErrorHandler::ThrowRuntimeError(std::format("{0} is bindless but the device doesn't support bindless textures", descriptorCreateInfo.Name));
+					}
 
-								if (!descriptorCreateInfo.SingleInstance) { offset += uniformSize + padding; }
-							}
-							break;
+					descriptorCount                   = bindlessTextureTable.GetCapacity();
+					descriptorCreateInfo.NoAllocation = true;
+				}
+				else if (descriptorCount == 0)
+				{
+					ErrorHandler::ThrowRuntimeError(std::format("Unsized arrays need to be marked as bindless ({0})", descriptorCreateInfo.Name));
+				}
+
+				// Bind everywhere if set is global or if property is shared
+				vk::ShaderStageFlagBits        shaderStageFlagBits = descriptorCreateInfo.Shared || set == 0 ? vk::ShaderStageFlagBits::eAll : stageFlag;
+				vk::DescriptorSetLayoutBinding layoutBinding       = vk::DescriptorSetLayoutBinding(binding, descriptorType, descriptorCount, shaderStageFlagBits);
+
+				switch (descriptorType)
+				{
+					case vk::DescriptorType::eStorageBuffer:
+					case vk::DescriptorType::eUniformBuffer:
+					case vk::DescriptorType::eStorageBufferDynamic:
+					case vk::DescriptorType::eUniformBufferDynamic:
+					{
+						vk::DeviceSize uniformSize = resource.SizeInBytes;
+
+						descriptorSetInfo.WriteDescriptorSets.emplace_back();
+
+						size_t offset = 0;
+						for (uint32_t j = 0; j < device->GetNumFramesInFlight(); ++j)
+						{
+							vk::DeviceSize minAlignment = type == vk::DescriptorType::eStorageBuffer
+								                              ? device->GetPhysicalDevice().GetProperties().limits.minStorageBufferOffsetAlignment
+								                              : device->GetPhysicalDevice().GetProperties().limits.minUniformBufferOffsetAlignment;
+
+							vk::DeviceSize padding = minAlignment - (uniformSize % minAlignment);
+							padding                = padding == minAlignment ? 0 : padding;
+
+							descriptorSetInfo.WriteDescriptorSets.back().emplace_back(VK_NULL_HANDLE, binding, 0, descriptorCount, descriptorType, nullptr, nullptr, nullptr);
+
+							// The range of dynamic buffers is relative to the dynamic offset, so it can't include the padding
+							descriptorSetInfo.WriteDescriptorSets.back().back().pBufferInfo = new vk::DescriptorBufferInfo(VK_NULL_HANDLE,
+							                                                                                               offset,
+							                                                                                               descriptorCreateInfo.Dynamic ? uniformSize : uniformSize + padding);
+
+							if (!descriptorCreateInfo.SingleInstance && !descriptorCreateInfo.Dynamic) { offset += uniformSize + padding; }
 						}
-						case vk::DescriptorType::eCombinedImageSampler:
-							descriptorSetInfo.WriteDescriptorSets.emplace_back();
-							for (int j = 0; j < Device::MAX_FRAMES_IN_FLIGHT; ++j)
-							{
-								descriptorSetInfo.WriteDescriptorSets.back().emplace_back(VK_NULL_HANDLE, binding, 0, descriptorCount, type, nullptr, nullptr, nullptr);
-							}
-							break;
+						break;
 					}
-
-					descriptorSetInfo.Bindings.insert(binding);
-					descriptorSetInfo.DescriptorPoolSizes.emplace_back(type, descriptorCount * Device::MAX_FRAMES_IN_FLIGHT);
-					descriptorSetInfo.DescriptorLayoutBindings.push_back(layoutBinding);
-					descriptorSetInfo.DescriptorCreateInfos.push_back(descriptorCreateInfo);
+					case vk::DescriptorType::eCombinedImageSampler:
+						descriptorSetInfo.WriteDescriptorSets.emplace_back();
+						for (uint32_t j = 0; j < device->GetNumFramesInFlight(); ++j)
+						{
+							descriptorSetInfo.WriteDescriptorSets.back().emplace_back(VK_NULL_HANDLE, binding, 0, descriptorCount, type, nullptr, nullptr, nullptr);
+						}
+						break;
 				}
-			}
 
+				descriptorSetInfo.Bindings.insert(binding);
+				descriptorSetInfo.DescriptorPoolSizes.emplace_back(descriptorType, descriptorCount * device->GetNumFramesInFlight());
+				descriptorSetInfo.DescriptorLayoutBindings.push_back(layoutBinding);
+				descriptorSetInfo.DescriptorCreateInfos.push_back(descriptorCreateInfo);
+			}
 
 			// Create push constant ranges
-			for (const spirv_cross::Resource& pushConstantBuffer: shaderResources.push_constant_buffers)
+			for (const ShaderReflection::PushConstantBlock& pushConstantBlock: reflection.PushConstantBlocks)
 			{
-				const spirv_cross::SPIRType pushConstantBufferType = spirvCompiler.get_type(pushConstantBuffer.base_type_id);
-				size_t                      firstOffset            = spirvCompiler.type_struct_member_offset(pushConstantBufferType, 0);
-				size_t                      size                   = spirvCompiler.get_declared_struct_size(pushConstantBufferType);
+				size_t firstOffset = pushConstantBlock.FirstOffset;
+				size_t size        = pushConstantBlock.SizeInBytes;
 
 				bool alreadyExists = false;
 				if (pushConstantRanges.contains(firstOffset))
@@ -227,14 +273,9 @@ namespace SplitEngine::Rendering::Vulkan
 					alreadyExists = true;
 				}
 
-				for (int memberIndex = 0; memberIndex < pushConstantBufferType.member_types.size(); ++memberIndex)
+				for (const ShaderReflection::PushConstantMember& member: pushConstantBlock.Members)
 				{
-					spirv_cross::TypeID memberTypeID = pushConstantBufferType.member_types[memberIndex];
-
-					size_t memberSize   = spirvCompiler.get_declared_struct_member_size(pushConstantBufferType, memberIndex);
-					size_t memberOffset = spirvCompiler.type_struct_member_offset(pushConstantBufferType, memberIndex);
-
-					_pushConstantInfos[static_cast<size_t>(shaderInfos[i].shaderStage)].emplace_back(memberOffset, memberSize);
+					_pushConstantInfos[static_cast<size_t>(shaderInfos[i].shaderStage)].emplace_back(member.Offset, member.SizeInBytes);
 				}
 
 				if (!alreadyExists) { pushConstantRanges[firstOffset] = vk::PushConstantRange(stageFlag, firstOffset, size); }
@@ -256,18 +297,13 @@ namespace SplitEngine::Rendering::Vulkan
 			{
 				// Setup vertex input attributes
 				uint32_t offset = 0;
-				for (const auto& stageInput: spirvCompiler.get_shader_resources().stage_inputs)
+				for (const ShaderReflection::StageInput& stageInput: reflection.StageInputs)
 				{
-					uint32_t                     location = spirvCompiler.get_decoration(stageInput.id, spv::DecorationLocation);
-					uint32_t                     binding  = spirvCompiler.get_decoration(stageInput.id, spv::DecorationBinding);
-					const spirv_cross::SPIRType& type     = spirvCompiler.get_type(stageInput.base_type_id);
-					vk::Format                   format   = GetFormatFromType(type);
-
-					vk::VertexInputAttributeDescription vertexInputAttributeDescription = vk::VertexInputAttributeDescription(location, binding, format, offset);
+					vk::VertexInputAttributeDescription vertexInputAttributeDescription = vk::VertexInputAttributeDescription(stageInput.Location, stageInput.Binding, stageInput.Format, offset);
 
 					vertexInputAttributeDescriptions.push_back(vertexInputAttributeDescription);
 
-					offset += (type.width * type.vecsize) / 8;
+					offset += stageInput.SizeInBytes;
 				}
 
 				// Setup pipeline vertex input state
@@ -280,21 +316,39 @@ namespace SplitEngine::Rendering::Vulkan
 			}
 		}
 
-		if (!_globalDescriptorsProcessed)
 		{
-			_globalDescriptorManager       = DescriptorSetAllocator(GetDevice(), _descriptorSetInfos[0], 1);
-			_globalDescriptorSetAllocation = _globalDescriptorManager.AllocateDescriptorSet();
-			_globalDescriptorsProcessed    = true;
-		}
+			// The global set and shared descriptors are static, everything before and after this block can run in parallel
+			std::lock_guard<std::mutex> lock(_descriptorSetupMutex);
+
+			// Another pipeline might have created the global set since we checked during reflection, in that case our global infos are just ignored.
+			// Shader::CreateBatch creates its first pipeline before starting any workers, so within a batch the global set always comes from the first shader
+			if (!_globalDescriptorsProcessed)
+			{
+				uint32_t bindlessBinding = -1u;
+				for (size_t i = 0; i < _descriptorSetInfos[0].DescriptorCreateInfos.size(); ++i)
+				{
+					if (_descriptorSetInfos[0].DescriptorCreateInfos[i].Bindless) { bindlessBinding = _descriptorSetInfos[0].DescriptorLayoutBindings[i].binding; }
+				}
 
-		_perPipelineDescriptorSetManager    = DescriptorSetAllocator(GetDevice(), _descriptorSetInfos[1], 1);
-		_perPipelineDescriptorSetAllocation = _perPipelineDescriptorSetManager.AllocateDescriptorSet();
+				_globalDescriptorManager       = DescriptorSetAllocator(GetDevice(), _descriptorSetInfos[0], 1);
+				_globalDescriptorSetAllocation = _globalDescriptorManager.AllocateDescriptorSet();
+				_globalDescriptorsProcessed    = true;
 
-		_perInstanceDescriptorSetManager = DescriptorSetAllocator(GetDevice(), _descriptorSetInfos[2], 10);
+				if (bindlessBinding != -1u)
+				{
+					GetDevice()->GetPhysicalDevice().GetInstance().GetBindlessTextureTable().Attach(_globalDescriptorSetAllocation.DescriptorSets.GetDataVector(), bindlessBinding);
+				}
+			}
 
-		_descriptorSetLayouts.push_back(_globalDescriptorManager.GetDescriptorSetLayout());
-		_descriptorSetLayouts.push_back(_perPipelineDescriptorSetManager.GetDescriptorSetLayout());
-		_descriptorSetLayouts.push_back(_perInstanceDescriptorSetManager.GetDescriptorSetLayout());
+			_perPipelineDescriptorSetManager    = DescriptorSetAllocator(GetDevice(), _descriptorSetInfos[1], 1);
+			_perPipelineDescriptorSetAllocation = _perPipelineDescriptorSetManager.AllocateDescriptorSet();
+
+			_perInstanceDescriptorSetManager = DescriptorSetAllocator(GetDevice(), _descriptorSetInfos[2], 10);
+
+			_descriptorSetLayouts.push_back(_globalDescriptorManager.GetDescriptorSetLayout());
+			_descriptorSetLayouts.push_back(_perPipelineDescriptorSetManager.GetDescriptorSetLayout());
+			_descriptorSetLayouts.push_back(_perInstanceDescriptorSetManager.GetDescriptorSetLayout());
+		}
 
 		std::vector<vk::PushConstantRange> pushConstantRangesVector = std::vector<vk::PushConstantRange>();
 		pushConstantRangesVector.reserve(pushConstantRanges.size());
@@ -310,7 +364,7 @@ namespace SplitEngine::Rendering::Vulkan
 
 			vk::PipelineDynamicStateCreateInfo dynamicStateCreateInfo = vk::PipelineDynamicStateCreateInfo({}, dynamicStates);
 
-			const vk::Extent2D& extent = device->GetSwapchain().GetExtend();
+			const vk::Extent2D extent = device->GetRenderExtent();
 
 			vk::Viewport viewport = GetDevice()->GetPhysicalDevice().GetInstance().CreateViewport(extent);
 
@@ -338,7 +392,7 @@ namespace SplitEngine::Rendering::Vulkan
 			                                                                                           VK_NULL_HANDLE,
 			                                                                                           -1);
 
-			vk::ResultValue<vk::Pipeline> graphicsPipelineResult = device->GetVkDevice().createGraphicsPipeline(VK_NULL_HANDLE, graphicsPipelineCreateInfo);
+			vk::ResultValue<vk::Pipeline> graphicsPipelineResult = device->GetVkDevice().createGraphicsPipeline(device->GetPipelineCache(), graphicsPipelineCreateInfo);
 			if (graphicsPipelineResult.result != vk::Result::eSuccess) { ErrorHandler::ThrowRuntimeError("Failed to create graphics pipeline!"); }
 
 			_vkPipeline = graphicsPipelineResult.value;
@@ -347,7 +401,7 @@ namespace SplitEngine::Rendering::Vulkan
 		{
 			vk::ComputePipelineCreateInfo computePipelineCreateInfo = vk::ComputePipelineCreateInfo({}, _shaderStages[0], _layout);
 
-			vk::ResultValue<vk::Pipeline> computePipelineResult = device->GetVkDevice().createComputePipeline(VK_NULL_HANDLE, computePipelineCreateInfo);
+			vk::ResultValue<vk::Pipeline> computePipelineResult = device->GetVkDevice().createComputePipeline(device->GetPipelineCache(), computePipelineCreateInfo);
 			if (computePipelineResult.result != vk::Result::eSuccess) { ErrorHandler::ThrowRuntimeError("Failed to create graphics pipeline!"); }
 
 			_vkPipeline = computePipelineResult.value;
@@ -373,66 +427,31 @@ namespace SplitEngine::Rendering::Vulkan
 	                                  uint32_t*                           dynamicOffsets,
 	                                  uint32_t                            frameInFlight) const
 	{
+		const vk::DescriptorSet& descriptorSet = frameInFlight == -1 ? descriptorSetAllocation->DescriptorSets.Get() : descriptorSetAllocation->DescriptorSets[frameInFlight];
+
+		// Writes to the set have to land before it gets bound, in the common case everything has already been flushed at the start of the frame and this does nothing.
+		// Only this set is written, other sets with pending writes might already be bound in the command buffer that's being recorded
+		DescriptorWriteBatch& descriptorWriteBatch = GetDevice()->GetPhysicalDevice().GetInstance().GetDescriptorWriteBatch();
+		if (descriptorWriteBatch.HasPendingWrites()) { descriptorWriteBatch.Flush(descriptorSet); }
+
+		// Every dynamic binding needs an offset, so without explicit ones the offsets set on the allocation are used
+		const bool useAllocationOffsets = dynamicOffsets == nullptr;
+
 		commandBuffer.bindDescriptorSets(_bindPoint,
 		                                 _layout,
 		                                 firstSet,
 		                                 1,
-		                                 frameInFlight == -1 ? &descriptorSetAllocation->DescriptorSets.Get() : &descriptorSetAllocation->DescriptorSets[frameInFlight],
-		                                 dynamicOffsetCount,
-		                                 dynamicOffsets);
-	}
-
-	vk::Format Pipeline::GetFormatFromType(const spirv_cross::SPIRType& type)
-	{
-		switch (type.basetype)
-		{
-			case spirv_cross::SPIRType::Float:
-				switch (type.vecsize)
-				{
-					case 1:
-						return vk::Format::eR32Sfloat;
-					case 2:
-						return vk::Format::eR32G32Sfloat;
-					case 3:
-						return vk::Format::eR32G32B32Sfloat;
-					case 4:
-						return vk::Format::eR32G32B32A32Sfloat;
-				}
-				break;
-			case spirv_cross::SPIRType::Int:
-				switch (type.vecsize)
-				{
-					case 1:
-						return vk::Format::eR32Sint;
-					case 2:
-						return vk::Format::eR32G32Sint;
-					case 3:
-						return vk::Format::eR32G32B32Sint;
-					case 4:
-						return vk::Format::eR32G32B32A32Sint;
-				}
-				break;
-			case spirv_cross::SPIRType::UInt:
-				switch (type.vecsize)
-				{
-					case 1:
-						return vk::Format::eR32Uint;
-					case 2:
-						return vk::Format::eR32G32Uint;
-					case 3:
-						return vk::Format::eR32G32B32Uint;
-					case 4:
-						return vk::Format::eR32G32B32A32Uint;
-				}
-		}
-
-		return vk::Format::eUndefined;
+		                                 &descriptorSet,
+		                                 useAllocationOffsets ? static_cast<uint32_t>(descriptorSetAllocation->DynamicOffsets.size()) : dynamicOffsetCount,
+		                                 useAllocationOffsets ? descriptorSetAllocation->DynamicOffsets.data() : dynamicOffsets);
 	}
 
 	const vk::Pipeline& Pipeline::GetVkPipeline() const { return _vkPipeline; }
 
 	const vk::PipelineLayout& Pipeline::GetLayout() const { return _layout; }
 
+	vk::PipelineBindPoint Pipeline::GetBindPoint() const { return _bindPoint; }
+
 	void Pipeline::Destroy()
 	{
 		_perPipelineDescriptorSetManager.DeallocateDescriptorSet(_perPipelineDescriptorSetAllocation);
@@ -456,6 +475,11 @@ namespace SplitEngine::Rendering::Vulkan
 
 	DescriptorSetAllocator::Allocation Pipeline::AllocatePerInstanceDescriptorSet() { return _perInstanceDescriptorSetManager.AllocateDescriptorSet(); }
 
+	std::vector<DescriptorSetAllocator::Allocation> Pipeline::AllocatePerInstanceDescriptorSets(const uint32_t count)
+	{
+		return _perInstanceDescriptorSetManager.AllocateDescriptorSets(count);
+	}
+
 	vk::ShaderStageFlagBits Pipeline::GetShaderStageFromShaderType(ShaderType shaderType) { return _shaderTypeLookup[static_cast<int>(shaderType)]; }
 
 	void Pipeline::DeallocatePerInstanceDescriptorSet(DescriptorSetAllocator::Allocation& descriptorSetAllocation)
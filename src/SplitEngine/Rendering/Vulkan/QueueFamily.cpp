@@ -23,6 +23,7 @@ namespace SplitEngine::Rendering::Vulkan
 
 	const vk::Queue&       QueueFamily::GetVkQueue(uint32_t index) const { return _vkQueues[index]; }
 	const vk::CommandPool& QueueFamily::GetCommandPool() const { return _commandPool; }
+	uint32_t               QueueFamily::GetIndex() const { return _index; }
 
 	vk::CommandBuffer& QueueFamily::BeginOneshotCommands()
 	{
@@ -52,19 +53,26 @@ namespace SplitEngine::Rendering::Vulkan
 		GetDevice()->GetVkDevice().freeCommandBuffers(_commandPool, 1, &_currentOneshotCommandBuffer);
 	}
 
-	CommandBuffer QueueFamily::AllocateCommandBuffer(QueueType type, vk::CommandBufferLevel commandBufferLevel, bool singleInstance)
+	CommandBuffer QueueFamily::AllocateCommandBuffer(QueueType type, vk::CommandBufferLevel commandBufferLevel, bool singleInstance, vk::CommandPool commandPool)
 	{
-		const vk::CommandBufferAllocateInfo commandBufferAllocateInfo = vk::CommandBufferAllocateInfo(_commandPool,
+		if (commandPool == VK_NULL_HANDLE) { commandPool = _commandPool; }
+
+		const vk::CommandBufferAllocateInfo commandBufferAllocateInfo = vk::CommandBufferAllocateInfo(commandPool,
 		                                                                                              commandBufferLevel,
-		                                                                                              singleInstance ? 1 : Device::MAX_FRAMES_IN_FLIGHT);
+		                                                                                              singleInstance ? 1 : GetDevice()->GetNumFramesInFlight());
 
 		std::vector<vk::CommandBuffer> commandBuffers = GetDevice()->GetVkDevice().allocateCommandBuffers(commandBufferAllocateInfo);
 		
-		return CommandBuffer(GetDevice(), type, GetDevice()->CreateInFlightResource<vk::CommandBuffer>(std::move(commandBuffers), singleInstance));
+		return CommandBuffer(GetDevice(), type, GetDevice()->CreateInFlightResource<vk::CommandBuffer>(std::move(commandBuffers), singleInstance), commandPool);
+	}
+
+	vk::CommandPool QueueFamily::CreateCommandPool(const vk::CommandPoolCreateFlags flags) const
+	{
+		return GetDevice()->GetVkDevice().createCommandPool(vk::CommandPoolCreateInfo(flags, _index));
 	}
 
 	void QueueFamily::DeallocateCommandBuffer(CommandBuffer& commandBuffer) const
 	{
-		GetDevice()->GetVkDevice().freeCommandBuffers(_commandPool, commandBuffer.GetVkCommandBufferRaw().GetDataVector());
+		GetDevice()->GetVkDevice().freeCommandBuffers(commandBuffer.GetCommandPool(), commandBuffer.GetVkCommandBufferRaw().GetDataVector());
 	}
 }
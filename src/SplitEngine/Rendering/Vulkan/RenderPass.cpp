@@ -1,5 +1,6 @@
 #include "SplitEngine/Rendering/Vulkan/RenderPass.hpp"
 
+#include "SplitEngine/Rendering/Vulkan/Instance.hpp"
 #include "SplitEngine/Rendering/Vulkan/PhysicalDevice.hpp"
 #include "SplitEngine/Rendering/Vulkan/Utility.hpp"
 
@@ -8,6 +9,10 @@ namespace SplitEngine::Rendering::Vulkan
 	RenderPass::RenderPass(Device* device) :
 		DeviceObject(device)
 	{
+		// Headless frames aren't presented, they end up ready to be copied into their readback buffer instead
+		const bool            headless         = device->GetPhysicalDevice().GetInstance().GetRenderingSettings().Headless;
+		const vk::ImageLayout colorFinalLayout = headless ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR;
+
 		const vk::AttachmentDescription colorAttachment = vk::AttachmentDescription({},
 		                                                                            device->GetPhysicalDevice().GetImageFormat().format,
 		                                                                            vk::SampleCountFlagBits::e1,
@@ -16,7 +21,7 @@ namespace SplitEngine::Rendering::Vulkan
 		                                                                            vk::AttachmentLoadOp::eDontCare,
 		                                                                            vk::AttachmentStoreOp::eDontCare,
 		                                                                            vk::ImageLayout::eUndefined,
-		                                                                            vk::ImageLayout::ePresentSrcKHR);
+		                                                                            colorFinalLayout);
 
 
 		const vk::AttachmentDescription depthAttachment = vk::AttachmentDescription({},
@@ -42,8 +47,21 @@ namespace SplitEngine::Rendering::Vulkan
 		                                                                {},
 		                                                                vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite);
 
+		std::vector<vk::SubpassDependency> subpassDependencies = { subpassDependency };
+
+		// Readback copies are recorded right after the render pass, they need to wait for the color writes and the transition to the transfer layout
+		if (headless)
+		{
+			subpassDependencies.emplace_back(0,
+			                                 vk::SubpassExternal,
+			                                 vk::PipelineStageFlagBits::eColorAttachmentOutput,
+			                                 vk::PipelineStageFlagBits::eTransfer,
+			                                 vk::AccessFlagBits::eColorAttachmentWrite,
+			                                 vk::AccessFlagBits::eTransferRead);
+		}
+
 		std::vector<vk::AttachmentDescription> attachments          = { colorAttachment, depthAttachment };
-		const vk::RenderPassCreateInfo         renderPassCreateInfo = vk::RenderPassCreateInfo({}, attachments, subpass, subpassDependency);
+		const vk::RenderPassCreateInfo         renderPassCreateInfo = vk::RenderPassCreateInfo({}, attachments, subpass, subpassDependencies);
 
 		_vkRenderPass = device->GetVkDevice().createRenderPass(renderPassCreateInfo);
 	}
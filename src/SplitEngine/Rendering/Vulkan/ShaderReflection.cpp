@@ -0,0 +1,323 @@
+#include "SplitEngine/Rendering/Vulkan/ShaderReflection.hpp"
+
+#include "spirv_cross/spirv_cross.hpp"
+#include "SplitEngine/Debug/Log.hpp"
+#include "SplitEngine/IO/Stream.hpp"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <thread>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	namespace
+	{
+		constexpr uint32_t SIDECAR_MAGIC   = 0x4C464552; // "REFL"
+		constexpr uint32_t SIDECAR_VERSION = 1;
+
+		struct SidecarWriter
+		{
+			std::vector<std::byte> Data{};
+
+			template<typename T>
+			void Write(const T& value)
+			{
+				const size_t offset = Data.size();
+				Data.resize(offset + sizeof(T));
+				memcpy(Data.data() + offset, &value, sizeof(T));
+			}
+
+			void Write(const std::string& value)
+			{
+				Write(static_cast<uint32_t>(value.size()));
+
+				const size_t offset = Data.size();
+				Data.resize(offset + value.size());
+				memcpy(Data.data() + offset, value.data(), value.size());
+			}
+		};
+
+		struct SidecarReader
+		{
+			const std::vector<std::byte>& Data;
+			size_t                        Offset = 0;
+
+			template<typename T>
+			bool Read(T& value)
+			{
+				if (Offset + sizeof(T) > Data.size()) { return false; }
+
+				memcpy(&value, Data.data() + Offset, sizeof(T));
+				Offset += sizeof(T);
+				return true;
+			}
+
+			bool Read(std::string& value)
+			{
+				uint32_t size = 0;
+				if (!Read(size) || Offset + size > Data.size()) { return false; }
+
+				value.assign(reinterpret_cast<const char*>(Data.data() + Offset), size);
+				Offset += size;
+				return true;
+			}
+
+			/**
+			 * Reads the element count of a vector, the count is checked against the remaining bytes so a corrupt file can't trigger a huge allocation
+			 */
+			bool ReadCount(uint32_t& count, const size_t minElementSize)
+			{
+				return Read(count) && static_cast<uint64_t>(count) * minElementSize <= Data.size() - Offset;
+			}
+		};
+
+		vk::Format GetFormatFromType(const spirv_cross::SPIRType& type)
+		{
+			switch (type.basetype)
+			{
+				case spirv_cross::SPIRType::Float:
+					switch (type.vecsize)
+					{
+						case 1:
+							return vk::Format::eR32Sfloat;
+						case 2:
+							return vk::Format::eR32G32Sfloat;
+						case 3:
+							return vk::Format::eR32G32B32Sfloat;
+						case 4:
+							return vk::Format::eR32G32B32A32Sfloat;
+					}
+					break;
+				case spirv_cross::SPIRType::Int:
+					switch (type.vecsize)
+					{
+						case 1:
+							return vk::Format::eR32Sint;
+						case 2:
+							return vk::Format::eR32G32Sint;
+						case 3:
+							return vk::Format::eR32G32B32Sint;
+						case 4:
+							return vk::Format::eR32G32B32A32Sint;
+					}
+					break;
+				case spirv_cross::SPIRType::UInt:
+					switch (type.vecsize)
+					{
+						case 1:
+							return vk::Format::eR32Uint;
+						case 2:
+							return vk::Format::eR32G32Uint;
+						case 3:
+							return vk::Format::eR32G32B32Uint;
+						case 4:
+							return vk::Format::eR32G32B32A32Uint;
+					}
+			}
+
+			return vk::Format::eUndefined;
+		}
+
+		bool LoadSidecar(const std::filesystem::path& path, const uint64_t spirvHash, ShaderReflection& reflection)
+		{
+			if (!std::filesystem::exists(path)) { return false; }
+
+			const std::vector<std::byte> data   = IO::Stream::ReadRawAndClose<std::byte>(path, IO::Binary);
+			SidecarReader                reader = { data };
+
+			uint32_t magic   = 0;
+			uint32_t version = 0;
+			uint64_t hash    = 0;
+			if (!reader.Read(magic) || !reader.Read(version) || !reader.Read(hash)) { return false; }
+			if (magic != SIDECAR_MAGIC || version != SIDECAR_VERSION || hash != spirvHash) { return false; }
+
+			uint32_t numResources = 0;
+			if (!reader.ReadCount(numResources, sizeof(uint32_t) * 5)) { return false; }
+
+			reflection.Resources.resize(numResources);
+			for (ShaderReflection::Resource& resource: reflection.Resources)
+			{
+				if (!reader.Read(resource.Type) ||
+				    !reader.Read(resource.Set) ||
+				    !reader.Read(resource.Binding) ||
+				    !reader.Read(resource.DescriptorCount) ||
+				    !reader.Read(resource.SizeInBytes) ||
+				    !reader.Read(resource.Name)) { return false; }
+			}
+
+			uint32_t numPushConstantBlocks = 0;
+			if (!reader.ReadCount(numPushConstantBlocks, sizeof(uint32_t) * 3)) { return false; }
+
+			reflection.PushConstantBlocks.resize(numPushConstantBlocks);
+			for (ShaderReflection::PushConstantBlock& block: reflection.PushConstantBlocks)
+			{
+				uint32_t numMembers = 0;
+				if (!reader.Read(block.FirstOffset) || !reader.Read(block.SizeInBytes) || !reader.ReadCount(numMembers, sizeof(ShaderReflection::PushConstantMember)))
+				{
+					return false;
+				}
+
+				block.Members.resize(numMembers);
+				for (ShaderReflection::PushConstantMember& member: block.Members) { if (!reader.Read(member)) { return false; } }
+			}
+
+			uint32_t numStageInputs = 0;
+			if (!reader.ReadCount(numStageInputs, sizeof(ShaderReflection::StageInput))) { return false; }
+
+			reflection.StageInputs.resize(numStageInputs);
+			for (ShaderReflection::StageInput& stageInput: reflection.StageInputs) { if (!reader.Read(stageInput)) { return false; } }
+
+			return reader.Offset == data.size();
+		}
+
+		void SaveSidecar(const std::filesystem::path& path, const uint64_t spirvHash, const ShaderReflection& reflection)
+		{
+			SidecarWriter writer{};
+
+			writer.Write(SIDECAR_MAGIC);
+			writer.Write(SIDECAR_VERSION);
+			writer.Write(spirvHash);
+
+			writer.Write(static_cast<uint32_t>(reflection.Resources.size()));
+			for (const ShaderReflection::Resource& resource: reflection.Resources)
+			{
+				writer.Write(resource.Type);
+				writer.Write(resource.Set);
+				writer.Write(resource.Binding);
+				writer.Write(resource.DescriptorCount);
+				writer.Write(resource.SizeInBytes);
+				writer.Write(resource.Name);
+			}
+
+			writer.Write(static_cast<uint32_t>(reflection.PushConstantBlocks.size()));
+			for (const ShaderReflection::PushConstantBlock& block: reflection.PushConstantBlocks)
+			{
+				writer.Write(block.FirstOffset);
+				writer.Write(block.SizeInBytes);
+				writer.Write(static_cast<uint32_t>(block.Members.size()));
+				for (const ShaderReflection::PushConstantMember& member: block.Members) { writer.Write(member); }
+			}
+
+			writer.Write(static_cast<uint32_t>(reflection.StageInputs.size()));
+			for (const ShaderReflection::StageInput& stageInput: reflection.StageInputs) { writer.Write(stageInput); }
+
+			// Shaders might live in a read only location, in that case we just reflect every time.
+			// The same module can be reflected by multiple pipelines created in parallel so every thread needs its own temporary file
+			std::filesystem::path temporaryPath = path;
+			temporaryPath += std::format(".{0}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+			std::ofstream stream = std::ofstream(temporaryPath, std::ios::binary | std::ios::trunc);
+			if (!stream.is_open())
+			{
+				LOG_WARNING("Failed to write shader reflection {0}", path.string());
+				return;
+			}
+
+			stream.write(reinterpret_cast<const char*>(writer.Data.data()), static_cast<std::streamsize>(writer.Data.size()));
+			stream.close();
+
+			std::error_code errorCode;
+			std::filesystem::rename(temporaryPath, path, errorCode);
+			if (errorCode) { LOG_WARNING("Failed to replace shader reflection {0}: {1}", path.string(), errorCode.message()); }
+		}
+	}
+
+	ShaderReflection ShaderReflection::Reflect(const std::vector<uint32_t>& spirv)
+	{
+		ShaderReflection reflection{};
+
+		const spirv_cross::Compiler        spirvCompiler   = spirv_cross::Compiler(spirv);
+		const spirv_cross::ShaderResources shaderResources = spirvCompiler.get_shader_resources();
+
+		const std::pair<vk::DescriptorType, const spirv_cross::SmallVector<spirv_cross::Resource>&> resourceMap[] = {
+			{ vk::DescriptorType::eUniformBuffer, shaderResources.uniform_buffers },
+			{ vk::DescriptorType::eStorageBuffer, shaderResources.storage_buffers },
+			{ vk::DescriptorType::eCombinedImageSampler, shaderResources.sampled_images },
+		};
+
+		for (const auto& [type, resources]: resourceMap)
+		{
+			for (const spirv_cross::Resource& spirvResource: resources)
+			{
+				const spirv_cross::SPIRType& resourceType = spirvCompiler.get_type(spirvResource.type_id);
+
+				Resource& resource = reflection.Resources.emplace_back();
+				resource.Type      = type;
+				resource.Set       = spirvCompiler.get_decoration(spirvResource.id, spv::DecorationDescriptorSet);
+				resource.Binding   = spirvCompiler.get_decoration(spirvResource.id, spv::DecorationBinding);
+				resource.Name      = spirvResource.name;
+
+				if (!resourceType.array.empty()) { resource.DescriptorCount = resourceType.array[0]; }
+
+				if (type != vk::DescriptorType::eCombinedImageSampler)
+				{
+					resource.SizeInBytes = spirvCompiler.get_declared_struct_size(spirvCompiler.get_type(spirvResource.base_type_id));
+				}
+			}
+		}
+
+		for (const spirv_cross::Resource& pushConstantBuffer: shaderResources.push_constant_buffers)
+		{
+			const spirv_cross::SPIRType& pushConstantBufferType = spirvCompiler.get_type(pushConstantBuffer.base_type_id);
+
+			PushConstantBlock& block = reflection.PushConstantBlocks.emplace_back();
+			block.FirstOffset        = spirvCompiler.type_struct_member_offset(pushConstantBufferType, 0);
+			block.SizeInBytes        = static_cast<uint32_t>(spirvCompiler.get_declared_struct_size(pushConstantBufferType));
+
+			for (uint32_t memberIndex = 0; memberIndex < pushConstantBufferType.member_types.size(); ++memberIndex)
+			{
+				block.Members.push_back({
+					spirvCompiler.type_struct_member_offset(pushConstantBufferType, memberIndex),
+					static_cast<uint32_t>(spirvCompiler.get_declared_struct_member_size(pushConstantBufferType, memberIndex))
+				});
+			}
+		}
+
+		for (const spirv_cross::Resource& spirvStageInput: shaderResources.stage_inputs)
+		{
+			const spirv_cross::SPIRType& type = spirvCompiler.get_type(spirvStageInput.base_type_id);
+
+			reflection.StageInputs.push_back({
+				spirvCompiler.get_decoration(spirvStageInput.id, spv::DecorationLocation),
+				spirvCompiler.get_decoration(spirvStageInput.id, spv::DecorationBinding),
+				GetFormatFromType(type),
+				(type.width * type.vecsize) / 8
+			});
+		}
+
+		return reflection;
+	}
+
+	ShaderReflection ShaderReflection::LoadOrReflect(const std::filesystem::path& spirvPath, const std::vector<uint32_t>& spirv, const std::string& sidecarExtension)
+	{
+		if (sidecarExtension.empty()) { return Reflect(spirv); }
+
+		std::filesystem::path sidecarPath = spirvPath;
+		sidecarPath += sidecarExtension;
+
+		const uint64_t spirvHash = HashSpirv(spirv);
+
+		ShaderReflection reflection{};
+		if (LoadSidecar(sidecarPath, spirvHash, reflection)) { return reflection; }
+
+		reflection = Reflect(spirv);
+		SaveSidecar(sidecarPath, spirvHash, reflection);
+
+		return reflection;
+	}
+
+	uint64_t ShaderReflection::HashSpirv(const std::vector<uint32_t>& spirv)
+	{
+		uint64_t hash = 14695981039346656037ull;
+
+		const auto* bytes = reinterpret_cast<const uint8_t*>(spirv.data());
+		for (size_t i = 0; i < spirv.size() * sizeof(uint32_t); ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+}
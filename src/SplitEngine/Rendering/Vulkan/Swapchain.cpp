@@ -1,5 +1,7 @@
 #include "SplitEngine/Rendering/Vulkan/Swapchain.hpp"
 
+#include "SplitEngine/Debug/Log.hpp"
+#include "SplitEngine/Rendering/Vulkan/Instance.hpp"
 #include "SplitEngine/Rendering/Vulkan/PhysicalDevice.hpp"
 #include "SplitEngine/Rendering/Vulkan/Utility.hpp"
 
@@ -13,16 +15,15 @@ namespace SplitEngine::Rendering::Vulkan
 		// Select surface format
 		const PhysicalDevice::SwapchainSupportDetails& swapchainSupportDetails = physicalDevice.GetSwapchainSupportDetails();
 
-		// Select present mode
+		const RenderingSettings& renderingSettings = physicalDevice.GetInstance().GetRenderingSettings();
+
+		// Select present mode, FIFO is the only one that's always supported
 		vk::PresentModeKHR presentMode = vk::PresentModeKHR::eFifo;
-		for (const auto& availablePresentMode: swapchainSupportDetails.PresentModes)
+		if (std::ranges::find(swapchainSupportDetails.PresentModes, renderingSettings.PresentMode) != swapchainSupportDetails.PresentModes.end())
 		{
-			if (availablePresentMode == vk::PresentModeKHR::eMailbox)
-			{
-				presentMode = vk::PresentModeKHR::eMailbox;
-				break;
-			}
+			presentMode = renderingSettings.PresentMode;
 		}
+		else { LOG_WARNING("Present mode {0} isn't supported, falling back to FIFO", vk::to_string(renderingSettings.PresentMode)); }
 
 		// Select swap extend
 		const vk::SurfaceCapabilitiesKHR& capabilities = swapchainSupportDetails.Capabilities;
@@ -34,11 +35,11 @@ namespace SplitEngine::Rendering::Vulkan
 		}
 
 		// Select image count
-		uint32_t imageCount = swapchainSupportDetails.Capabilities.minImageCount + 1;
-		if (swapchainSupportDetails.Capabilities.maxImageCount > 0 && imageCount > swapchainSupportDetails.Capabilities.maxImageCount)
-		{
-			imageCount = swapchainSupportDetails.Capabilities.maxImageCount;
-		}
+		uint32_t imageCount = renderingSettings.SwapchainImageCount == 0 ? capabilities.minImageCount + 1 : renderingSettings.SwapchainImageCount;
+		imageCount          = std::max(imageCount, capabilities.minImageCount);
+		if (capabilities.maxImageCount > 0 && imageCount > capabilities.maxImageCount) { imageCount = capabilities.maxImageCount; }
+
+		LOG("Creating swapchain with {0} images in {1} mode", imageCount, vk::to_string(presentMode));
 
 		// Create swap chain
 		vk::SwapchainCreateInfoKHR swapChainCreateInfo = vk::SwapchainCreateInfoKHR({},
@@ -0,0 +1,110 @@
+#include "SplitEngine/Rendering/Vulkan/TransientBufferAllocator.hpp"
+
+#include "SplitEngine/ErrorHandler.hpp"
+#include "SplitEngine/Rendering/Vulkan/Device.hpp"
+#include "SplitEngine/Rendering/Vulkan/PhysicalDevice.hpp"
+
+#include <bit>
+#include <format>
+#include <limits>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	TransientBufferAllocator::TransientBufferAllocator(Device* device, const vk::DeviceSize sizeInBytesPerFrame) :
+		DeviceObject(device)
+	{
+		const vk::PhysicalDeviceLimits& limits = device->GetPhysicalDevice().GetProperties().limits;
+
+		_minUniformAlignment = std::max<vk::DeviceSize>(limits.minUniformBufferOffsetAlignment, 1);
+		_minStorageAlignment = std::max<vk::DeviceSize>(limits.minStorageBufferOffsetAlignment, 1);
+
+		_frameBuffers = device->CreateInFlightResource<FrameBuffer>();
+		for (FrameBuffer& frameBuffer: _frameBuffers.GetDataVector()) { frameBuffer.Buffer = CreateFrameBuffer(sizeInBytesPerFrame); }
+	}
+
+	TransientBufferAllocator::Allocation TransientBufferAllocator::Allocate(const vk::DeviceSize sizeInBytes, const vk::BufferUsageFlagBits usage)
+	{
+		vk::DeviceSize alignment = 16;
+		switch (usage)
+		{
+			case vk::BufferUsageFlagBits::eUniformBuffer:
+				alignment = std::max(alignment, _minUniformAlignment);
+				break;
+			case vk::BufferUsageFlagBits::eStorageBuffer:
+				alignment = std::max(alignment, _minStorageAlignment);
+				break;
+			default:
+				break;
+		}
+
+		FrameBuffer& frameBuffer = _frameBuffers.Get();
+
+		// Alignments reported by the device are always a power of two
+		vk::DeviceSize offset = (frameBuffer.Offset + alignment - 1) & ~(alignment - 1);
+
+		// Previous allocations of this frame still point into the current buffer, so it can only be retired and destroyed once the frame comes around again
+		if (offset + sizeInBytes > frameBuffer.Buffer.GetSizeInBytes())
+		{
+			const vk::DeviceSize newSizeInBytes = std::bit_ceil(std::max(frameBuffer.Buffer.GetSizeInBytes() * 2, sizeInBytes));
+
+			LOG_WARNING("Transient buffer ran out of space, growing from {0} to {1} bytes", frameBuffer.Buffer.GetSizeInBytes(), newSizeInBytes);
+
+			frameBuffer.Buffer.Flush(0, frameBuffer.Offset);
+			frameBuffer.RetiredBuffers.push_back(std::move(frameBuffer.Buffer));
+			frameBuffer.Buffer = CreateFrameBuffer(newSizeInBytes);
+
+			offset = 0;
+		}
+
+		if (offset + sizeInBytes > std::numeric_limits<uint32_t>::max())
+		{
+			ErrorHandler::ThrowRuntimeError(std::format("Transient allocation at offset {0} can't be addressed by a dynamic offset", offset));
+		}
+
+		frameBuffer.Offset = offset + sizeInBytes;
+
+		return { frameBuffer.Buffer.GetVkBuffer(), static_cast<uint32_t>(offset), sizeInBytes, frameBuffer.Buffer.GetMappedData<std::byte>() + offset };
+	}
+
+	void TransientBufferAllocator::Reset()
+	{
+		FrameBuffer& frameBuffer = _frameBuffers.Get();
+
+		for (Buffer& retiredBuffer: frameBuffer.RetiredBuffers) { retiredBuffer.Destroy(); }
+		frameBuffer.RetiredBuffers.clear();
+
+		frameBuffer.Offset = 0;
+	}
+
+	void TransientBufferAllocator::Flush()
+	{
+		const FrameBuffer& frameBuffer = _frameBuffers.Get();
+		if (frameBuffer.Offset > 0) { frameBuffer.Buffer.Flush(0, frameBuffer.Offset); }
+	}
+
+	void TransientBufferAllocator::Destroy()
+	{
+		for (FrameBuffer& frameBuffer: _frameBuffers.GetDataVector())
+		{
+			for (Buffer& retiredBuffer: frameBuffer.RetiredBuffers) { retiredBuffer.Destroy(); }
+			frameBuffer.RetiredBuffers.clear();
+
+			frameBuffer.Buffer.Destroy();
+		}
+	}
+
+	const Buffer& TransientBufferAllocator::GetBuffer() const { return _frameBuffers.Get().Buffer; }
+
+	vk::DeviceSize TransientBufferAllocator::GetUsedSizeInBytes() const { return _frameBuffers.Get().Offset; }
+
+	Buffer TransientBufferAllocator::CreateFrameBuffer(const vk::DeviceSize sizeInBytes) const
+	{
+		return Buffer(GetDevice(),
+		              USAGE,
+		              vk::SharingMode::eExclusive,
+		              { Allocator::Auto, vk::Flags<Allocator::MemoryAllocationCreateFlagBits>(Allocator::WriteSequentially | Allocator::PersistentMap) },
+		              nullptr,
+		              sizeInBytes,
+		              sizeInBytes);
+	}
+}
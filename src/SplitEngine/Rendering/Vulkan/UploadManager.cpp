@@ -0,0 +1,446 @@
+#include "SplitEngine/Rendering/Vulkan/UploadManager.hpp"
+
+#include "SplitEngine/Rendering/Vulkan/Device.hpp"
+#include "SplitEngine/Rendering/Vulkan/Image.hpp"
+#include "SplitEngine/Rendering/Vulkan/Utility.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vulkan/vulkan_format_traits.hpp>
+
+namespace SplitEngine::Rendering::Vulkan
+{
+	UploadManager::UploadManager(Device* device, const vk::DeviceSize stagingBufferSizeInBytes) :
+		DeviceObject(device),
+		_transferQueueFamilyIndex(device->GetQueueFamily(QueueType::Transfer).GetIndex()),
+		_graphicsQueueFamilyIndex(device->GetQueueFamily(QueueType::Graphics).GetIndex()),
+		_stagingCapacity(stagingBufferSizeInBytes)
+	{
+		const vk::CommandPoolCreateInfo commandPoolCreateInfo = vk::CommandPoolCreateInfo(vk::CommandPoolCreateFlagBits::eResetCommandBuffer | vk::CommandPoolCreateFlagBits::eTransient,
+		                                                                                  _transferQueueFamilyIndex);
+
+		_commandPool = device->GetVkDevice().createCommandPool(commandPoolCreateInfo);
+
+		_stagingBuffer = Buffer(device,
+		                        vk::BufferUsageFlagBits::eTransferSrc,
+		                        vk::SharingMode::eExclusive,
+		                        { Allocator::Auto, vk::Flags<Allocator::MemoryAllocationCreateFlagBits>(Allocator::WriteSequentially | Allocator::PersistentMap) },
+		                        nullptr,
+		                        _stagingCapacity,
+		                        _stagingCapacity);
+
+		_stagingData = _stagingBuffer.GetMappedData<std::byte>();
+	}
+
+	UploadManager::Ticket UploadManager::UploadBuffer(const Buffer& destinationBuffer, const std::byte* data, const vk::DeviceSize sizeInBytes, const vk::DeviceSize destinationOffsetInBytes)
+	{
+		std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+		vk::Buffer     stagingBuffer        = VK_NULL_HANDLE;
+		vk::DeviceSize stagingOffsetInBytes = 0;
+		memcpy(AllocateStaging(sizeInBytes, stagingBuffer, stagingOffsetInBytes), data, sizeInBytes);
+
+		Batch& batch = GetRecordingBatch();
+
+		const vk::BufferCopy copyRegion = vk::BufferCopy(stagingOffsetInBytes, destinationOffsetInBytes, sizeInBytes);
+		batch.CommandBuffer.copyBuffer(stagingBuffer, destinationBuffer.GetVkBuffer(), 1, &copyRegion);
+
+		if (!IsSameQueueFamily())
+		{
+			const vk::BufferMemoryBarrier releaseBarrier = vk::BufferMemoryBarrier(vk::AccessFlagBits::eTransferWrite,
+			                                                                       {},
+			                                                                       _transferQueueFamilyIndex,
+			                                                                       _graphicsQueueFamilyIndex,
+			                                                                       destinationBuffer.GetVkBuffer(),
+			                                                                       destinationOffsetInBytes,
+			                                                                       sizeInBytes);
+
+			batch.CommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {}, nullptr, releaseBarrier, nullptr);
+
+			batch.BufferAcquireBarriers.push_back(releaseBarrier);
+			batch.BufferAcquireBarriers.back().srcAccessMask = {};
+			batch.BufferAcquireBarriers.back().dstAccessMask = vk::AccessFlagBits::eMemoryRead;
+		}
+
+		return { batch.ID };
+	}
+
+	UploadManager::Ticket UploadManager::UploadImage(Image&                     destinationImage,
+	                                                 const std::byte*           pixels,
+	                                                 const vk::DeviceSize       pixelsSizeInBytes,
+	                                                 const vk::Extent3D         extent,
+	                                                 const vk::ImageAspectFlags aspectMask,
+	                                                 const vk::ImageLayout      finalLayout,
+	                                                 const bool                 generateMipmaps)
+	{
+		std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+		vk::Buffer     stagingBuffer        = VK_NULL_HANDLE;
+		vk::DeviceSize stagingOffsetInBytes = 0;
+		memcpy(AllocateStaging(pixelsSizeInBytes, stagingBuffer, stagingOffsetInBytes), pixels, pixelsSizeInBytes);
+
+		Batch& batch = GetRecordingBatch();
+
+		destinationImage.TransitionLayout(batch.CommandBuffer, vk::ImageLayout::eTransferDstOptimal);
+
+		const uint32_t mipLevels         = destinationImage.GetMipLevels();
+		const uint32_t uploadedMipLevels = generateMipmaps ? 1 : mipLevels;
+
+		// Every level of the chain is copied out of the same staging allocation in one go, block compressed levels are rounded up to whole blocks
+		const vk::DeviceSize         blockSizeInBytes = vk::blockSize(destinationImage.GetFormat());
+		const std::array<uint8_t, 3> blockExtent      = vk::blockExtent(destinationImage.GetFormat());
+
+		std::vector<vk::BufferImageCopy> bufferImageCopies{};
+		bufferImageCopies.reserve(uploadedMipLevels);
+
+		vk::DeviceSize levelOffsetInBytes = stagingOffsetInBytes;
+		for (uint32_t level = 0; level < uploadedMipLevels; ++level)
+		{
+			const vk::Extent3D levelExtent = vk::Extent3D(std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u), std::max(extent.depth >> level, 1u));
+
+			bufferImageCopies.emplace_back(levelOffsetInBytes, 0, 0, vk::ImageSubresourceLayers(aspectMask, level, 0, 1), vk::Offset3D(0, 0, 0), levelExtent);
+
+			const vk::DeviceSize numBlocks = static_cast<vk::DeviceSize>((levelExtent.width + blockExtent[0] - 1) / blockExtent[0]) *
+			                                 ((levelExtent.height + blockExtent[1] - 1) / blockExtent[1]) *
+			                                 ((levelExtent.depth + blockExtent[2] - 1) / blockExtent[2]);
+
+			levelOffsetInBytes += numBlocks * blockSizeInBytes;
+		}
+
+		batch.CommandBuffer.copyBufferToImage(stagingBuffer, destinationImage.GetVkImage(), vk::ImageLayout::eTransferDstOptimal, bufferImageCopies);
+
+		const bool             needsGeneration  = generateMipmaps && mipLevels > 1;
+		const MipmapGeneration mipmapGeneration = { destinationImage.GetVkImage(), extent, mipLevels, aspectMask, finalLayout };
+
+		if (IsSameQueueFamily())
+		{
+			// The transfer queue is part of the graphics family here, so it can blit as well
+			if (needsGeneration)
+			{
+				RecordMipmapGeneration(batch.CommandBuffer, mipmapGeneration);
+				destinationImage._layout = finalLayout;
+			}
+			else { destinationImage.TransitionLayout(batch.CommandBuffer, finalLayout); }
+
+			return { batch.ID };
+		}
+
+		// The layout transition happens as part of the ownership transfer, unless mipmaps still need to be generated on the graphics queue
+		const vk::ImageMemoryBarrier releaseBarrier = vk::ImageMemoryBarrier(vk::AccessFlagBits::eTransferWrite,
+		                                                                     {},
+		                                                                     vk::ImageLayout::eTransferDstOptimal,
+		                                                                     needsGeneration ? vk::ImageLayout::eTransferDstOptimal : finalLayout,
+		                                                                     _transferQueueFamilyIndex,
+		                                                                     _graphicsQueueFamilyIndex,
+		                                                                     destinationImage.GetVkImage(),
+		                                                                     vk::ImageSubresourceRange(aspectMask, 0, mipLevels, 0, 1));
+
+		batch.CommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {}, nullptr, nullptr, releaseBarrier);
+
+		batch.ImageAcquireBarriers.push_back(releaseBarrier);
+		batch.ImageAcquireBarriers.back().srcAccessMask = {};
+		batch.ImageAcquireBarriers.back().dstAccessMask = needsGeneration ? vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite : vk::AccessFlagBits::eShaderRead;
+
+		if (needsGeneration) { batch.MipmapGenerations.push_back(mipmapGeneration); }
+
+		destinationImage._layout = finalLayout;
+
+		return { batch.ID };
+	}
+
+	UploadManager::Ticket UploadManager::Submit()
+	{
+		std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+		if (!_isRecording) { return { _nextBatchID - 1 }; }
+
+		// Same queue family means the copies and the later reads can end up on the same queue, so make the writes visible to everything submitted after
+		if (IsSameQueueFamily())
+		{
+			const vk::MemoryBarrier memoryBarrier = vk::MemoryBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead);
+			_recordingBatch.CommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, memoryBarrier, nullptr, nullptr);
+		}
+
+		_recordingBatch.CommandBuffer.end();
+		_recordingBatch.StagingEnd = _stagingHead;
+
+		const vk::SubmitInfo submitInfo = vk::SubmitInfo(nullptr, nullptr, _recordingBatch.CommandBuffer, nullptr);
+		GetDevice()->GetQueueFamily(QueueType::Transfer).GetVkQueue().submit(submitInfo, _recordingBatch.Fence);
+
+		const Ticket ticket = { _recordingBatch.ID };
+
+		_submittedBatches.push_back(std::move(_recordingBatch));
+		_recordingBatch = {};
+		_isRecording    = false;
+
+		return ticket;
+	}
+
+	void UploadManager::RequireForFrame(const Ticket ticket)
+	{
+		std::lock_guard<std::recursive_mutex> lock(_mutex);
+		_requiredBatchID = std::max(_requiredBatchID, ticket.BatchID);
+	}
+
+	bool UploadManager::IsComplete(const Ticket ticket) const
+	{
+		std::lock_guard<std::recursive_mutex> lock(_mutex);
+		return ticket.BatchID <= _completedBatchID;
+	}
+
+	bool UploadManager::IsIdle() const
+	{
+		std::lock_guard<std::recursive_mutex> lock(_mutex);
+		return !_isRecording && _submittedBatches.empty() && !HasPendingAcquires();
+	}
+
+	void UploadManager::Wait(const Ticket ticket)
+	{
+		std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+		if (IsComplete(ticket)) { return; }
+
+		if (_isRecording && ticket.BatchID >= _recordingBatch.ID) { Submit(); }
+
+		while (!_submittedBatches.empty() && _submittedBatches.front().ID <= ticket.BatchID) { RetireOldestBatch(true); }
+
+		if (!HasPendingAcquires()) { return; }
+
+		QueueFamily& graphicsQueueFamily = GetDevice()->GetQueueFamily(QueueType::Graphics);
+
+		RecordPendingAcquires(graphicsQueueFamily.BeginOneshotCommands());
+		graphicsQueueFamily.EndOneshotCommands();
+	}
+
+	void UploadManager::Update(const vk::CommandBuffer& graphicsCommandBuffer)
+	{
+		std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+		Submit();
+
+		while (!_submittedBatches.empty())
+		{
+			if (!RetireOldestBatch(_submittedBatches.front().ID <= _requiredBatchID)) { break; }
+		}
+
+		RecordPendingAcquires(graphicsCommandBuffer);
+	}
+
+	void UploadManager::Destroy()
+	{
+		std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+		if (_isRecording)
+		{
+			_recordingBatch.CommandBuffer.end();
+			_freeBatches.push_back(std::move(_recordingBatch));
+		}
+
+		for (Batch& batch: _submittedBatches) { _freeBatches.push_back(std::move(batch)); }
+
+		for (Batch& batch: _freeBatches)
+		{
+			for (Buffer& buffer: batch.DedicatedStagingBuffers) { buffer.Destroy(); }
+			Utility::DeleteDeviceHandle(GetDevice(), batch.Fence);
+		}
+
+		_submittedBatches.clear();
+		_freeBatches.clear();
+		_recordingBatch = {};
+		_isRecording    = false;
+
+		// Destroying the pool also frees all command buffers allocated from it
+		Utility::DeleteDeviceHandle(GetDevice(), _commandPool);
+
+		_stagingBuffer.Destroy();
+	}
+
+	std::unique_lock<std::recursive_mutex> UploadManager::Lock() { return std::unique_lock<std::recursive_mutex>(_mutex); }
+
+	bool UploadManager::IsSameQueueFamily() const { return _transferQueueFamilyIndex == _graphicsQueueFamilyIndex; }
+
+	UploadManager::Batch& UploadManager::GetRecordingBatch()
+	{
+		if (_isRecording) { return _recordingBatch; }
+
+		if (!_freeBatches.empty())
+		{
+			_recordingBatch = std::move(_freeBatches.back());
+			_freeBatches.pop_back();
+		}
+		else
+		{
+			const vk::CommandBufferAllocateInfo commandBufferAllocateInfo = vk::CommandBufferAllocateInfo(_commandPool, vk::CommandBufferLevel::ePrimary, 1);
+
+			_recordingBatch.CommandBuffer = GetDevice()->GetVkDevice().allocateCommandBuffers(commandBufferAllocateInfo)[0];
+			_recordingBatch.Fence         = GetDevice()->GetVkDevice().createFence(vk::FenceCreateInfo());
+		}
+
+		_recordingBatch.ID = _nextBatchID++;
+
+		constexpr vk::CommandBufferBeginInfo beginInfo = vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+		_recordingBatch.CommandBuffer.begin(beginInfo);
+
+		_isRecording = true;
+
+		return _recordingBatch;
+	}
+
+	std::byte* UploadManager::AllocateStaging(const vk::DeviceSize sizeInBytes, vk::Buffer& stagingBuffer, vk::DeviceSize& stagingOffsetInBytes)
+	{
+		// Too big for the ring, this upload gets its own buffer
+		if (sizeInBytes > _stagingCapacity)
+		{
+			Batch& batch = GetRecordingBatch();
+
+			batch.DedicatedStagingBuffers.push_back(Buffer(GetDevice(),
+			                                               vk::BufferUsageFlagBits::eTransferSrc,
+			                                               vk::SharingMode::eExclusive,
+			                                               { Allocator::Auto, vk::Flags<Allocator::MemoryAllocationCreateFlagBits>(Allocator::WriteSequentially | Allocator::PersistentMap) },
+			                                               nullptr,
+			                                               sizeInBytes,
+			                                               sizeInBytes));
+
+			const Buffer& dedicatedBuffer = batch.DedicatedStagingBuffers.back();
+
+			stagingBuffer        = dedicatedBuffer.GetVkBuffer();
+			stagingOffsetInBytes = 0;
+
+			return dedicatedBuffer.GetMappedData<std::byte>();
+		}
+
+		uint64_t position = 0;
+		while (true)
+		{
+			// Nothing of the ring is in use, so start at the beginning of it
+			if (_stagingHead == _stagingTail) { _stagingHead = _stagingTail = (_stagingHead + _stagingCapacity - 1) / _stagingCapacity * _stagingCapacity; }
+
+			position = (_stagingHead + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+
+			// Allocations can't wrap around the end of the ring
+			if (position % _stagingCapacity + sizeInBytes > _stagingCapacity) { position = (position / _stagingCapacity + 1) * _stagingCapacity; }
+
+			if (position + sizeInBytes - _stagingTail <= _stagingCapacity) { break; }
+
+			// Ring is full, wait for the oldest batch to free up space
+			if (_submittedBatches.empty()) { Submit(); }
+
+			RetireOldestBatch(true);
+		}
+
+		_stagingHead = position + sizeInBytes;
+
+		stagingBuffer        = _stagingBuffer.GetVkBuffer();
+		stagingOffsetInBytes = position % _stagingCapacity;
+
+		return _stagingData + stagingOffsetInBytes;
+	}
+
+	bool UploadManager::RetireOldestBatch(const bool wait)
+	{
+		Batch& batch = _submittedBatches.front();
+
+		const vk::Device& device = GetDevice()->GetVkDevice();
+
+		if (wait) { device.waitForFences(batch.Fence, vk::True, UINT64_MAX); }
+		else if (device.getFenceStatus(batch.Fence) != vk::Result::eSuccess) { return false; }
+
+		device.resetFences(batch.Fence);
+
+		_stagingTail    = std::max(_stagingTail, batch.StagingEnd);
+		_retiredBatchID = batch.ID;
+
+		for (Buffer& buffer: batch.DedicatedStagingBuffers) { buffer.Destroy(); }
+		batch.DedicatedStagingBuffers.clear();
+
+		_pendingImageAcquireBarriers.insert(_pendingImageAcquireBarriers.end(), batch.ImageAcquireBarriers.begin(), batch.ImageAcquireBarriers.end());
+		_pendingBufferAcquireBarriers.insert(_pendingBufferAcquireBarriers.end(), batch.BufferAcquireBarriers.begin(), batch.BufferAcquireBarriers.end());
+		_pendingMipmapGenerations.insert(_pendingMipmapGenerations.end(), batch.MipmapGenerations.begin(), batch.MipmapGenerations.end());
+		batch.ImageAcquireBarriers.clear();
+		batch.BufferAcquireBarriers.clear();
+		batch.MipmapGenerations.clear();
+
+		if (!HasPendingAcquires()) { _completedBatchID = _retiredBatchID; }
+
+		_freeBatches.push_back(std::move(batch));
+		_submittedBatches.pop_front();
+
+		return true;
+	}
+
+	bool UploadManager::HasPendingAcquires() const { return !_pendingImageAcquireBarriers.empty() || !_pendingBufferAcquireBarriers.empty(); }
+
+	void UploadManager::RecordPendingAcquires(const vk::CommandBuffer& graphicsCommandBuffer)
+	{
+		if (HasPendingAcquires())
+		{
+			graphicsCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+			                                      vk::PipelineStageFlagBits::eAllCommands,
+			                                      {},
+			                                      nullptr,
+			                                      _pendingBufferAcquireBarriers,
+			                                      _pendingImageAcquireBarriers);
+
+			_pendingImageAcquireBarriers.clear();
+			_pendingBufferAcquireBarriers.clear();
+		}
+
+		for (const MipmapGeneration& mipmapGeneration: _pendingMipmapGenerations) { RecordMipmapGeneration(graphicsCommandBuffer, mipmapGeneration); }
+		_pendingMipmapGenerations.clear();
+
+		_completedBatchID = _retiredBatchID;
+	}
+
+	void UploadManager::RecordMipmapGeneration(const vk::CommandBuffer& commandBuffer, const MipmapGeneration& mipmapGeneration)
+	{
+		vk::ImageMemoryBarrier imageMemoryBarrier = vk::ImageMemoryBarrier({},
+		                                                                   {},
+		                                                                   {},
+		                                                                   {},
+		                                                                   vk::QueueFamilyIgnored,
+		                                                                   vk::QueueFamilyIgnored,
+		                                                                   mipmapGeneration.Image,
+		                                                                   vk::ImageSubresourceRange(mipmapGeneration.AspectMask, 0, 1, 0, 1));
+
+		vk::Offset3D levelSize = vk::Offset3D(static_cast<int32_t>(mipmapGeneration.Extent.width), static_cast<int32_t>(mipmapGeneration.Extent.height), static_cast<int32_t>(mipmapGeneration.Extent.depth));
+
+		// Each level is downsampled from the previous one, which is done being written to and can move to its final layout afterwards
+		for (uint32_t level = 1; level < mipmapGeneration.MipLevels; ++level)
+		{
+			imageMemoryBarrier.subresourceRange.baseMipLevel = level - 1;
+			imageMemoryBarrier.oldLayout                     = vk::ImageLayout::eTransferDstOptimal;
+			imageMemoryBarrier.newLayout                     = vk::ImageLayout::eTransferSrcOptimal;
+			imageMemoryBarrier.srcAccessMask                 = vk::AccessFlagBits::eTransferWrite;
+			imageMemoryBarrier.dstAccessMask                 = vk::AccessFlagBits::eTransferRead;
+
+			commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {}, nullptr, nullptr, imageMemoryBarrier);
+
+			const vk::Offset3D nextLevelSize = vk::Offset3D(std::max(levelSize.x / 2, 1), std::max(levelSize.y / 2, 1), std::max(levelSize.z / 2, 1));
+
+			const vk::ImageBlit imageBlit = vk::ImageBlit(vk::ImageSubresourceLayers(mipmapGeneration.AspectMask, level - 1, 0, 1),
+			                                              { vk::Offset3D(0, 0, 0), levelSize },
+			                                              vk::ImageSubresourceLayers(mipmapGeneration.AspectMask, level, 0, 1),
+			                                              { vk::Offset3D(0, 0, 0), nextLevelSize });
+
+			commandBuffer.blitImage(mipmapGeneration.Image, vk::ImageLayout::eTransferSrcOptimal, mipmapGeneration.Image, vk::ImageLayout::eTransferDstOptimal, imageBlit, vk::Filter::eLinear);
+
+			imageMemoryBarrier.oldLayout     = vk::ImageLayout::eTransferSrcOptimal;
+			imageMemoryBarrier.newLayout     = mipmapGeneration.FinalLayout;
+			imageMemoryBarrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
+			imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+
+			commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, nullptr, nullptr, imageMemoryBarrier);
+
+			levelSize = nextLevelSize;
+		}
+
+		imageMemoryBarrier.subresourceRange.baseMipLevel = mipmapGeneration.MipLevels - 1;
+		imageMemoryBarrier.oldLayout                     = vk::ImageLayout::eTransferDstOptimal;
+		imageMemoryBarrier.newLayout                     = mipmapGeneration.FinalLayout;
+		imageMemoryBarrier.srcAccessMask                 = vk::AccessFlagBits::eTransferWrite;
+		imageMemoryBarrier.dstAccessMask                 = vk::AccessFlagBits::eShaderRead;
+
+		commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, nullptr, nullptr, imageMemoryBarrier);
+	}
+}
@@ -4,7 +4,9 @@
 #include "SplitEngine/Input.hpp"
 
 #include "SplitEngine/Application.hpp"
+#include "SplitEngine/EventBus.hpp"
 #include "SplitEngine/Stages.hpp"
+#include "SplitEngine/Rendering/Renderer.hpp"
 
 #include <SDL2/SDL_timer.h>
 
@@ -20,6 +22,30 @@ namespace SplitEngine
 
 		_accumulatedFrames++;
 
+		Rendering::Renderer* renderer = contextProvider.GetContext<RenderingContext>()->Renderer;
+
+		_accumulatedGpuWaitTimeMs += renderer->GetGpuWaitTimeMs();
+
+		// Gpu results only change when a frame has been read back, which doesn't happen while rendering is skipped
+		const Rendering::GpuProfiler::FrameResults& gpuResults = renderer->GetGpuProfiler().GetResults();
+		if (gpuResults.FrameNumber != _lastGpuFrameNumber)
+		{
+			_lastGpuFrameNumber = gpuResults.FrameNumber;
+			_accumulatedGpuFrames++;
+
+			_accumulatedGpuFrameTimeMs += gpuResults.FrameTimeMs;
+			_accumulatedGpuRenderPassTimeMs += gpuResults.RenderPassTimeMs;
+
+			for (const Rendering::GpuProfiler::ZoneResult& zone: gpuResults.Zones) { _accumulatedGpuZoneTimeMs[zone.Name] += zone.TimeMs; }
+
+			_accumulatedGpuPipelineStatistics.InputAssemblyVertices += gpuResults.PipelineStatistics.InputAssemblyVertices;
+			_accumulatedGpuPipelineStatistics.InputAssemblyPrimitives += gpuResults.PipelineStatistics.InputAssemblyPrimitives;
+			_accumulatedGpuPipelineStatistics.VertexShaderInvocations += gpuResults.PipelineStatistics.VertexShaderInvocations;
+			_accumulatedGpuPipelineStatistics.ClippingPrimitives += gpuResults.PipelineStatistics.ClippingPrimitives;
+			_accumulatedGpuPipelineStatistics.FragmentShaderInvocations += gpuResults.PipelineStatistics.FragmentShaderInvocations;
+			_accumulatedGpuPipelineStatistics.ComputeShaderInvocations += gpuResults.PipelineStatistics.ComputeShaderInvocations;
+		}
+
 		if (_accumulatedDeltaTime >= 0.5f)
 		{
 			float averageDeltaTime = _accumulatedDeltaTime / static_cast<float>(_accumulatedFrames);
@@ -29,6 +55,36 @@ namespace SplitEngine
 
 			_accumulatedDeltaTime = 0.0f;
 
+			statistics.AverageGpuWaitTimeMs = _accumulatedGpuWaitTimeMs / static_cast<float>(_accumulatedFrames);
+			_accumulatedGpuWaitTimeMs       = 0.0f;
+
+			statistics.GpuMemoryHeaps = renderer->GetVulkanInstance().GetAllocator().GetMemoryHeapStatistics();
+
+			if (_accumulatedGpuFrames > 0)
+			{
+				const float numGpuFrames = static_cast<float>(_accumulatedGpuFrames);
+
+				statistics.AverageGpuFrameTimeMs      = _accumulatedGpuFrameTimeMs / numGpuFrames;
+				statistics.AverageGpuRenderPassTimeMs = _accumulatedGpuRenderPassTimeMs / numGpuFrames;
+
+				statistics.AverageGpuZoneTimeMs.clear();
+				for (const auto& [name, timeMs]: _accumulatedGpuZoneTimeMs) { statistics.AverageGpuZoneTimeMs[std::string(name)] = timeMs / numGpuFrames; }
+
+				GpuPipelineStatistics& pipelineStatistics = statistics.AverageGpuPipelineStatistics;
+				pipelineStatistics.InputAssemblyVertices     = _accumulatedGpuPipelineStatistics.InputAssemblyVertices / _accumulatedGpuFrames;
+				pipelineStatistics.InputAssemblyPrimitives   = _accumulatedGpuPipelineStatistics.InputAssemblyPrimitives / _accumulatedGpuFrames;
+				pipelineStatistics.VertexShaderInvocations   = _accumulatedGpuPipelineStatistics.VertexShaderInvocations / _accumulatedGpuFrames;
+				pipelineStatistics.ClippingPrimitives        = _accumulatedGpuPipelineStatistics.ClippingPrimitives / _accumulatedGpuFrames;
+				pipelineStatistics.FragmentShaderInvocations = _accumulatedGpuPipelineStatistics.FragmentShaderInvocations / _accumulatedGpuFrames;
+				pipelineStatistics.ComputeShaderInvocations  = _accumulatedGpuPipelineStatistics.ComputeShaderInvocations / _accumulatedGpuFrames;
+
+				_accumulatedGpuFrameTimeMs        = 0.0f;
+				_accumulatedGpuRenderPassTimeMs   = 0.0f;
+				_accumulatedGpuFrames             = 0;
+				_accumulatedGpuPipelineStatistics = {};
+				_accumulatedGpuZoneTimeMs.clear();
+			}
+
 			std::vector<uint8_t>& activeStages           = contextProvider.Registry->GetActiveStages();
 			std::vector<float>&   accumulatedStageTimeMs = contextProvider.Registry->GetAccumulatedStageTimeMs();
 
@@ -39,6 +95,11 @@ namespace SplitEngine
 				accumulatedStageTimeMs[activeStage] = 0;
 			}
 
+			std::vector<uint64_t>& accumulatedBudgetOverruns = contextProvider.Registry->GetAccumulatedBudgetOverruns();
+
+			statistics.ECSSystemBudgetOverruns = accumulatedBudgetOverruns;
+			std::ranges::fill(accumulatedBudgetOverruns, 0);
+
 			_accumulatedFrames = 0;
 		}
 	}
@@ -55,6 +116,8 @@ namespace SplitEngine
 		contextProvider.GetContext<TimeContext>()->DeltaTime = deltaTime;
 	}
 
+	void EventBusSystem::RunExecute(ECS::ContextProvider& contextProvider, uint8_t stage) { contextProvider.GetContext<EngineContext>()->EventBus->Flush(); }
+
 	void SDLEventSystem::RunExecute(ECS::ContextProvider& contextProvider, uint8_t stage)
 	{
 		Input::Reset();
@@ -73,6 +136,8 @@ namespace SplitEngine
 		}
 	}
 
+	void FramePacingSystem::RunExecute(ECS::ContextProvider& contextProvider, uint8_t stage) { contextProvider.GetContext<RenderingContext>()->Renderer->WaitForFrame(); }
+
 	void RenderingSystem::RunExecute(ECS::ContextProvider& contextProvider, uint8_t stage)
 	{
 		if (stage == EngineStage::BeginRendering) { contextProvider.GetContext<RenderingContext>()->Renderer->BeginRender(); }
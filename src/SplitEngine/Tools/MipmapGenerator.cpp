@@ -0,0 +1,82 @@
+#include "SplitEngine/Tools/MipmapGenerator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace SplitEngine::Tools
+{
+	namespace
+	{
+		float SrgbToLinear(const float value) { return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f); }
+
+		float LinearToSrgb(const float value) { return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f; }
+
+		std::byte ToByte(const float value) { return static_cast<std::byte>(std::clamp(value * 255.0f + 0.5f, 0.0f, 255.0f)); }
+	}
+
+	void MipmapGenerator::Generate(IO::Image& image)
+	{
+		if (image.MipLevels > 1 || image.Compression != IO::Image::BlockCompression::None || image.Width == 0 || image.Height == 0) { return; }
+
+		const uint32_t channels  = image.Channels;
+		const uint32_t mipLevels = std::bit_width(std::max(image.Width, image.Height));
+
+		// Alpha and non color images are stored linearly
+		const auto isSrgbChannel = [channels](const uint32_t channel) { return channels == 4 && channel < 3; };
+
+		std::array<float, 256> srgbToLinear{};
+		for (size_t i = 0; i < srgbToLinear.size(); ++i) { srgbToLinear[i] = SrgbToLinear(static_cast<float>(i) / 255.0f); }
+
+		// Levels are downsampled from the unquantized previous level so rounding errors don't add up along the chain
+		std::vector<float> level(image.Pixels.size());
+		for (size_t i = 0; i < image.Pixels.size(); ++i)
+		{
+			const uint8_t value = static_cast<uint8_t>(image.Pixels[i]);
+			level[i]            = isSrgbChannel(i % channels) ? srgbToLinear[value] : static_cast<float>(value) / 255.0f;
+		}
+
+		std::vector<float> nextLevel{};
+
+		uint32_t width  = image.Width;
+		uint32_t height = image.Height;
+
+		for (uint32_t mipLevel = 1; mipLevel < mipLevels; ++mipLevel)
+		{
+			const uint32_t nextWidth  = std::max(width / 2, 1u);
+			const uint32_t nextHeight = std::max(height / 2, 1u);
+
+			nextLevel.resize(static_cast<size_t>(nextWidth) * nextHeight * channels);
+
+			for (uint32_t y = 0; y < nextHeight; ++y)
+			{
+				// Odd sizes and 1 pixel wide levels reuse the last row or column
+				const float* row0 = level.data() + static_cast<size_t>(std::min(y * 2, height - 1)) * width * channels;
+				const float* row1 = level.data() + static_cast<size_t>(std::min(y * 2 + 1, height - 1)) * width * channels;
+				float*       out  = nextLevel.data() + static_cast<size_t>(y) * nextWidth * channels;
+
+				for (uint32_t x = 0; x < nextWidth; ++x)
+				{
+					const size_t x0 = static_cast<size_t>(std::min(x * 2, width - 1)) * channels;
+					const size_t x1 = static_cast<size_t>(std::min(x * 2 + 1, width - 1)) * channels;
+
+					for (uint32_t channel = 0; channel < channels; ++channel) { out[x * channels + channel] = (row0[x0 + channel] + row0[x1 + channel] + row1[x0 + channel] + row1[x1 + channel]) * 0.25f; }
+				}
+			}
+
+			const size_t levelOffset = image.Pixels.size();
+			image.Pixels.resize(levelOffset + nextLevel.size());
+
+			for (size_t i = 0; i < nextLevel.size(); ++i) { image.Pixels[levelOffset + i] = ToByte(isSrgbChannel(i % channels) ? LinearToSrgb(nextLevel[i]) : nextLevel[i]); }
+
+			std::swap(level, nextLevel);
+			width  = nextWidth;
+			height = nextHeight;
+		}
+
+		image.MipLevels = mipLevels;
+	}
+}
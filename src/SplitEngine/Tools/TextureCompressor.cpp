@@ -0,0 +1,475 @@
+#include "SplitEngine/Tools/TextureCompressor.hpp"
+
+#include "SplitEngine/ErrorHandler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace SplitEngine::Tools
+{
+	namespace
+	{
+		using Texel = std::array<float, 4>;
+		using Block = std::array<Texel, 16>;
+
+		constexpr std::array<uint32_t, 16> BC7_WEIGHTS = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		class BitWriter
+		{
+			public:
+				void Write(const uint64_t value, const uint32_t numBits)
+				{
+					for (uint32_t i = 0; i < numBits; ++i, ++_position) { _bytes[_position / 8] |= static_cast<std::byte>(((value >> i) & 1) << (_position % 8)); }
+				}
+
+				[[nodiscard]] const std::array<std::byte, 16>& GetBytes() const { return _bytes; }
+
+			private:
+				std::array<std::byte, 16> _bytes{};
+				uint32_t                  _position = 0;
+		};
+
+		float SquaredDistance(const Texel& a, const Texel& b, const size_t numChannels)
+		{
+			float distance = 0.0f;
+			for (size_t c = 0; c < numChannels; ++c) { distance += (a[c] - b[c]) * (a[c] - b[c]); }
+			return distance;
+		}
+
+		/**
+		 * Fits a line through the texels along their principal axis, the endpoints are where the outermost texels project onto it
+		 */
+		void FitEndpoints(const Block& block, const size_t numChannels, Texel& endpoint0, Texel& endpoint1)
+		{
+			Texel mean{};
+			for (const Texel& texel: block) { for (size_t c = 0; c < numChannels; ++c) { mean[c] += texel[c] / 16.0f; } }
+
+			std::array<std::array<float, 4>, 4> covariance{};
+			for (const Texel& texel: block)
+			{
+				for (size_t i = 0; i < numChannels; ++i) { for (size_t j = 0; j < numChannels; ++j) { covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]); } }
+			}
+
+			// Power iteration converges on the dominant eigenvector quickly enough for 16 texels
+			Texel axis = { 1.0f, 1.0f, 1.0f, 1.0f };
+			for (int iteration = 0; iteration < 8; ++iteration)
+			{
+				Texel next{};
+				for (size_t i = 0; i < numChannels; ++i) { for (size_t j = 0; j < numChannels; ++j) { next[i] += covariance[i][j] * axis[j]; } }
+
+				const float length = std::sqrt(SquaredDistance(next, {}, numChannels));
+				if (length < 1e-6f)
+				{
+					endpoint0 = endpoint1 = mean;
+					return;
+				}
+
+				for (size_t c = 0; c < numChannels; ++c) { axis[c] = next[c] / length; }
+			}
+
+			float minProjection = 0.0f;
+			float maxProjection = 0.0f;
+			for (const Texel& texel: block)
+			{
+				float projection = 0.0f;
+				for (size_t c = 0; c < numChannels; ++c) { projection += (texel[c] - mean[c]) * axis[c]; }
+
+				minProjection = std::min(minProjection, projection);
+				maxProjection = std::max(maxProjection, projection);
+			}
+
+			for (size_t c = 0; c < numChannels; ++c)
+			{
+				endpoint0[c] = std::clamp(mean[c] + axis[c] * minProjection, 0.0f, 255.0f);
+				endpoint1[c] = std::clamp(mean[c] + axis[c] * maxProjection, 0.0f, 255.0f);
+			}
+		}
+
+		uint16_t PackRgb565(const Texel& color)
+		{
+			const auto r = static_cast<uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+			const auto g = static_cast<uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+			const auto b = static_cast<uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+
+			return static_cast<uint16_t>(r << 11 | g << 5 | b);
+		}
+
+		Texel UnpackRgb565(const uint16_t color)
+		{
+			const uint32_t r = color >> 11 & 31;
+			const uint32_t g = color >> 5 & 63;
+			const uint32_t b = color & 31;
+
+			return { static_cast<float>(r << 3 | r >> 2), static_cast<float>(g << 2 | g >> 4), static_cast<float>(b << 3 | b >> 2), 255.0f };
+		}
+
+		void EncodeBC1(const Block& block, std::byte* output)
+		{
+			const bool hasTransparency = std::ranges::any_of(block, [](const Texel& texel) { return texel[3] < 128.0f; });
+
+			Texel endpoint0{};
+			Texel endpoint1{};
+			FitEndpoints(block, 3, endpoint0, endpoint1);
+
+			uint16_t color0 = PackRgb565(endpoint1);
+			uint16_t color1 = PackRgb565(endpoint0);
+
+			// The order of the endpoints selects the mode, the three color mode is the one with a transparent index
+			if (hasTransparency ? color0 > color1 : color0 < color1) { std::swap(color0, color1); }
+
+			const Texel          texel0    = UnpackRgb565(color0);
+			const Texel          texel1    = UnpackRgb565(color1);
+			std::array<Texel, 4> palette   = { texel0, texel1 };
+			const uint32_t       numColors = hasTransparency || color0 == color1 ? 3 : 4;
+
+			for (size_t c = 0; c < 3; ++c)
+			{
+				if (numColors == 4)
+				{
+					palette[2][c] = (2.0f * texel0[c] + texel1[c]) / 3.0f;
+					palette[3][c] = (texel0[c] + 2.0f * texel1[c]) / 3.0f;
+				}
+				else { palette[2][c] = (texel0[c] + texel1[c]) / 2.0f; }
+			}
+
+			uint32_t indices = 0;
+			for (size_t i = 0; i < block.size(); ++i)
+			{
+				uint32_t bestIndex = 3;
+				if (!hasTransparency || block[i][3] >= 128.0f)
+				{
+					float bestDistance = FLT_MAX;
+					for (uint32_t index = 0; index < numColors; ++index)
+					{
+						const float distance = SquaredDistance(block[i], palette[index], 3);
+						if (distance < bestDistance)
+						{
+							bestDistance = distance;
+							bestIndex    = index;
+						}
+					}
+				}
+
+				indices |= bestIndex << (i * 2);
+			}
+
+			memcpy(output, &color0, sizeof(uint16_t));
+			memcpy(output + 2, &color1, sizeof(uint16_t));
+			memcpy(output + 4, &indices, sizeof(uint32_t));
+		}
+
+		/**
+		 * Picks the 7 bit endpoint and shared p bit that reconstruct the endpoint best
+		 */
+		void QuantizeBC7Endpoint(const Texel& endpoint, std::array<uint32_t, 4>& quantized, uint32_t& pBit)
+		{
+			float bestError = FLT_MAX;
+			for (uint32_t p = 0; p < 2; ++p)
+			{
+				std::array<uint32_t, 4> candidate{};
+				float                   error = 0.0f;
+				for (size_t c = 0; c < 4; ++c)
+				{
+					candidate[c]              = static_cast<uint32_t>(std::clamp(std::lround((endpoint[c] - static_cast<float>(p)) / 2.0f), 0l, 127l));
+					const float reconstructed = static_cast<float>(candidate[c] << 1 | p);
+					error += (reconstructed - endpoint[c]) * (reconstructed - endpoint[c]);
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					quantized = candidate;
+					pBit      = p;
+				}
+			}
+		}
+
+		void EncodeBC7(const Block& block, std::byte* output)
+		{
+			Texel endpoint0{};
+			Texel endpoint1{};
+			FitEndpoints(block, 4, endpoint0, endpoint1);
+
+			std::array<std::array<uint32_t, 4>, 2> endpoints{};
+			std::array<uint32_t, 2>                pBits{};
+			QuantizeBC7Endpoint(endpoint0, endpoints[0], pBits[0]);
+			QuantizeBC7Endpoint(endpoint1, endpoints[1], pBits[1]);
+
+			std::array<Texel, 16> palette{};
+			for (size_t index = 0; index < palette.size(); ++index)
+			{
+				for (size_t c = 0; c < 4; ++c)
+				{
+					const uint32_t value0 = endpoints[0][c] << 1 | pBits[0];
+					const uint32_t value1 = endpoints[1][c] << 1 | pBits[1];
+					palette[index][c]     = static_cast<float>(((64 - BC7_WEIGHTS[index]) * value0 + BC7_WEIGHTS[index] * value1 + 32) >> 6);
+				}
+			}
+
+			std::array<uint32_t, 16> indices{};
+			for (size_t i = 0; i < block.size(); ++i)
+			{
+				float bestDistance = FLT_MAX;
+				for (uint32_t index = 0; index < palette.size(); ++index)
+				{
+					const float distance = SquaredDistance(block[i], palette[index], 4);
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						indices[i]   = index;
+					}
+				}
+			}
+
+			// The most significant bit of the first index is implied to be zero, swapping the endpoints flips all indices
+			if (indices[0] >= 8)
+			{
+				std::swap(endpoints[0], endpoints[1]);
+				std::swap(pBits[0], pBits[1]);
+				for (uint32_t& index: indices) { index = 15 - index; }
+			}
+
+			BitWriter bitWriter{};
+			bitWriter.Write(1 << 6, 7);
+			for (size_t c = 0; c < 4; ++c)
+			{
+				bitWriter.Write(endpoints[0][c], 7);
+				bitWriter.Write(endpoints[1][c], 7);
+			}
+			bitWriter.Write(pBits[0], 1);
+			bitWriter.Write(pBits[1], 1);
+			for (size_t i = 0; i < indices.size(); ++i) { bitWriter.Write(indices[i], i == 0 ? 3 : 4); }
+
+			memcpy(output, bitWriter.GetBytes().data(), bitWriter.GetBytes().size());
+		}
+
+		uint32_t GetVkFormat(const IO::Image::BlockCompression compression, const bool srgb)
+		{
+			// The sRGB variant always directly follows the UNORM one
+			switch (compression)
+			{
+				case IO::Image::BlockCompression::BC1:
+					return srgb ? 134 : 133; // VK_FORMAT_BC1_RGBA_SRGB_BLOCK, VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+				case IO::Image::BlockCompression::BC7:
+					return srgb ? 146 : 145; // VK_FORMAT_BC7_SRGB_BLOCK, VK_FORMAT_BC7_UNORM_BLOCK
+				case IO::Image::BlockCompression::ASTC4x4:
+					return srgb ? 158 : 157; // VK_FORMAT_ASTC_4x4_SRGB_BLOCK, VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+				default:
+					return 0;
+			}
+		}
+
+		std::vector<std::byte> CreateDataFormatDescriptor(const IO::Image::BlockCompression compression, const bool srgb)
+		{
+			// Basic descriptor block of the Khronos data format specification, every block is treated as one opaque sample
+			uint8_t  colorModel = 0;
+			uint8_t  blockBytes = 16;
+			uint32_t numSamples = 1;
+			switch (compression)
+			{
+				case IO::Image::BlockCompression::BC1:
+					colorModel = 128; // KHR_DF_MODEL_BC1A
+					blockBytes = 8;
+					numSamples = 2;
+					break;
+				case IO::Image::BlockCompression::BC7:
+					colorModel = 134; // KHR_DF_MODEL_BC7
+					break;
+				default:
+					colorModel = 162; // KHR_DF_MODEL_ASTC
+					break;
+			}
+
+			const uint32_t blockSize = 24 + 16 * numSamples;
+			const uint32_t totalSize = 4 + blockSize;
+
+			std::vector<std::byte> descriptor(totalSize);
+			std::byte*             data = descriptor.data();
+
+			const uint32_t vendorAndType       = 0;
+			const uint32_t versionAndBlockSize = 2 | blockSize << 16;
+			const uint8_t  modelAndTransfer[4] = { colorModel, 1, static_cast<uint8_t>(srgb ? 2 : 1), 0 }; // BT.709 primaries, sRGB or linear transfer, straight alpha
+			const uint8_t  blockDimensions[4]  = { 3, 3, 0, 0 };
+
+			memcpy(data, &totalSize, 4);
+			memcpy(data + 4, &vendorAndType, 4);
+			memcpy(data + 8, &versionAndBlockSize, 4);
+			memcpy(data + 12, modelAndTransfer, 4);
+			memcpy(data + 16, blockDimensions, 4);
+			memcpy(data + 20, &blockBytes, 1);
+
+			for (uint32_t sample = 0; sample < numSamples; ++sample)
+			{
+				std::byte* sampleData = data + 28 + sample * 16;
+
+				const uint32_t bitOffsetLengthAndChannel = static_cast<uint32_t>(blockBytes * 8 - 1) << 16 | (sample == 0 ? 0u : 15u) << 24; // Second BC1 sample is the alpha channel
+				const uint32_t sampleUpper               = UINT32_MAX;
+
+				memcpy(sampleData, &bitOffsetLengthAndChannel, 4);
+				memcpy(sampleData + 12, &sampleUpper, 4);
+			}
+
+			return descriptor;
+		}
+
+		template<typename T>
+		void Append(std::vector<std::byte>& data, const T& value)
+		{
+			const std::byte* bytes = reinterpret_cast<const std::byte*>(&value);
+			data.insert(data.end(), bytes, bytes + sizeof(T));
+		}
+	}
+
+	IO::Image TextureCompressor::Compress(const IO::Image& image, const IO::Image::BlockCompression compression)
+	{
+		if (image.Compression != IO::Image::BlockCompression::None || image.Channels != 4) { ErrorHandler::ThrowRuntimeError("Only uncompressed 4 channel images can be compressed!"); }
+
+		if (compression != IO::Image::BlockCompression::BC1 && compression != IO::Image::BlockCompression::BC7) { ErrorHandler::ThrowRuntimeError("Only BC1 and BC7 can be encoded!"); }
+
+		IO::Image compressedImage = IO::Image(std::vector<std::byte>(), image.Width, image.Height, 4, image.MipLevels, compression, image.Srgb);
+
+		const size_t blockSizeInBytes = compression == IO::Image::BlockCompression::BC1 ? 8 : 16;
+
+		size_t sourceOffset = 0;
+		for (uint32_t level = 0; level < image.MipLevels; ++level)
+		{
+			const uint32_t width          = std::max(image.Width >> level, 1u);
+			const uint32_t height         = std::max(image.Height >> level, 1u);
+			const uint32_t numBlocksX     = (width + 3) / 4;
+			const uint32_t numBlocksY     = (height + 3) / 4;
+			const std::byte* sourcePixels = image.Pixels.data() + sourceOffset;
+
+			const size_t destinationOffset = compressedImage.Pixels.size();
+			compressedImage.Pixels.resize(destinationOffset + compressedImage.GetMipLevelSizeInBytes(level));
+			std::byte* destinationBlocks = compressedImage.Pixels.data() + destinationOffset;
+
+			// Block rows are handed out to the workers one at a time
+			std::atomic<uint32_t> nextBlockRow = 0;
+			const auto            encodeRows   = [&]
+			{
+				for (uint32_t blockY = nextBlockRow++; blockY < numBlocksY; blockY = nextBlockRow++)
+				{
+					for (uint32_t blockX = 0; blockX < numBlocksX; ++blockX)
+					{
+						// Blocks hanging over the edge repeat the last row and column
+						Block block{};
+						for (uint32_t i = 0; i < 16; ++i)
+						{
+							const uint32_t   x     = std::min(blockX * 4 + i % 4, width - 1);
+							const uint32_t   y     = std::min(blockY * 4 + i / 4, height - 1);
+							const std::byte* pixel = sourcePixels + (static_cast<size_t>(y) * width + x) * 4;
+
+							for (size_t c = 0; c < 4; ++c) { block[i][c] = static_cast<float>(static_cast<uint8_t>(pixel[c])); }
+						}
+
+						std::byte* output = destinationBlocks + (static_cast<size_t>(blockY) * numBlocksX + blockX) * blockSizeInBytes;
+
+						if (compression == IO::Image::BlockCompression::BC1) { EncodeBC1(block, output); }
+						else { EncodeBC7(block, output); }
+					}
+				}
+			};
+
+			{
+				const size_t              numThreads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), numBlocksY);
+				std::vector<std::jthread> workers{};
+				workers.reserve(numThreads - 1);
+
+				for (size_t i = 1; i < numThreads; ++i) { workers.emplace_back(encodeRows); }
+				encodeRows();
+			}
+
+			sourceOffset += image.GetMipLevelSizeInBytes(level);
+		}
+
+		return compressedImage;
+	}
+
+	void TextureCompressor::Compress(ImagePacker::PackingData& packingData, const IO::Image::BlockCompression compression)
+	{
+		for (IO::Image& pageImage: packingData.PageImages) { pageImage = Compress(pageImage, compression); }
+	}
+
+	void TextureCompressor::WriteKtx2(const IO::Image& image, const std::filesystem::path& filePath)
+	{
+		static constexpr std::array<uint8_t, 12> IDENTIFIER = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+		if (image.Compression == IO::Image::BlockCompression::None) { ErrorHandler::ThrowRuntimeError("Only compressed images can be written to ktx2!"); }
+
+		const std::vector<std::byte> dataFormatDescriptor = CreateDataFormatDescriptor(image.Compression, image.Srgb);
+
+		const size_t levelAlignment  = image.Compression == IO::Image::BlockCompression::BC1 ? 8 : 16;
+		const size_t levelIndexSize  = image.MipLevels * 3 * sizeof(uint64_t);
+		const size_t descriptorStart = 80 + levelIndexSize;
+
+		std::vector<std::byte> data{};
+		data.insert(data.end(), reinterpret_cast<const std::byte*>(IDENTIFIER.data()), reinterpret_cast<const std::byte*>(IDENTIFIER.data()) + IDENTIFIER.size());
+
+		Append<uint32_t>(data, GetVkFormat(image.Compression, image.Srgb));
+		Append<uint32_t>(data, 1); // Type size
+		Append<uint32_t>(data, image.Width);
+		Append<uint32_t>(data, image.Height);
+		Append<uint32_t>(data, 0); // Depth
+		Append<uint32_t>(data, 0); // Layer count
+		Append<uint32_t>(data, 1); // Face count
+		Append<uint32_t>(data, image.MipLevels);
+		Append<uint32_t>(data, 0); // Supercompression scheme
+
+		Append<uint32_t>(data, static_cast<uint32_t>(descriptorStart));
+		Append<uint32_t>(data, static_cast<uint32_t>(dataFormatDescriptor.size()));
+		Append<uint32_t>(data, 0); // Key value data
+		Append<uint32_t>(data, 0);
+		Append<uint64_t>(data, 0); // Supercompression global data
+		Append<uint64_t>(data, 0);
+
+		// Levels are stored from the smallest to the biggest one
+		std::vector<size_t> levelOffsets(image.MipLevels);
+		std::vector<size_t> sourceOffsets(image.MipLevels);
+
+		size_t sourceOffset = 0;
+		for (uint32_t level = 0; level < image.MipLevels; ++level)
+		{
+			sourceOffsets[level] = sourceOffset;
+			sourceOffset += image.GetMipLevelSizeInBytes(level);
+		}
+
+		size_t offset = descriptorStart + dataFormatDescriptor.size();
+
+		for (uint32_t level = image.MipLevels; level-- > 0;)
+		{
+			offset              = (offset + levelAlignment - 1) / levelAlignment * levelAlignment;
+			levelOffsets[level] = offset;
+			offset += image.GetMipLevelSizeInBytes(level);
+		}
+
+		for (uint32_t level = 0; level < image.MipLevels; ++level)
+		{
+			Append<uint64_t>(data, levelOffsets[level]);
+			Append<uint64_t>(data, image.GetMipLevelSizeInBytes(level));
+			Append<uint64_t>(data, image.GetMipLevelSizeInBytes(level));
+		}
+
+		data.insert(data.end(), dataFormatDescriptor.begin(), dataFormatDescriptor.end());
+
+		data.resize(offset);
+		for (uint32_t level = 0; level < image.MipLevels; ++level)
+		{
+			memcpy(data.data() + levelOffsets[level], image.Pixels.data() + sourceOffsets[level], image.GetMipLevelSizeInBytes(level));
+		}
+
+		std::ofstream file = std::ofstream(filePath, std::ios::binary);
+		if (!file.is_open()) { ErrorHandler::ThrowRuntimeError(std::format("failed to write image {0}!", filePath.string())); }
+
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	}
+}
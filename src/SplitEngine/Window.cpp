@@ -7,8 +7,15 @@
 
 namespace SplitEngine
 {
-	Window::Window(const std::string& windowTitle, uint32_t width, uint32_t height)
+	Window::Window(const std::string& windowTitle, uint32_t width, uint32_t height, const bool headless)
 	{
+		if (headless)
+		{
+			LOG("Running headless, no window will be opened");
+			_headlessSize = { static_cast<int>(width), static_cast<int>(height) };
+			return;
+		}
+
 		LOG("Initializing Window...");
 		if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) { ErrorHandler::ThrowRuntimeError(std::format("SDL could not initialize! SDL_Error: {0}\n", SDL_GetError())); }
 
@@ -25,7 +32,7 @@ namespace SplitEngine
 
 	void Window::Close()
 	{
-		SDL_DestroyWindow(_window);
+		if (_window != nullptr) { SDL_DestroyWindow(_window); }
 		SDL_Quit();
 	}
 
@@ -33,6 +40,8 @@ namespace SplitEngine
 
 	glm::ivec2 Window::GetSize() const
 	{
+		if (_window == nullptr) { return _headlessSize; }
+
 		glm::ivec2 size;
 
 		SDL_GetWindowSize(_window, &size.x, &size.y);
@@ -42,6 +51,8 @@ namespace SplitEngine
 
 	bool Window::IsMinimized() const { return _isMinimized; }
 
+	bool Window::IsHeadless() const { return _window == nullptr; }
+
 	void Window::HandleEvents(SDL_Event event)
 	{
 		switch (event.window.event)
@@ -60,12 +71,16 @@ namespace SplitEngine
 
 	void Window::SetSize(uint32_t width, uint32_t height)
 	{
+		if (_window == nullptr) { return; }
+
 		SDL_SetWindowSize(_window, static_cast<int>(width), static_cast<int>(height));
 		SDL_SetWindowPosition(_window, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED);
 	}
 
 	void Window::SetFullscreen(bool fullscreen)
 	{
+		if (_window == nullptr) { return; }
+
 		SDL_SetWindowFullscreen(_window, fullscreen ? SDL_WINDOW_FULLSCREEN_DESKTOP : 0);
 		_isInFullscreen = fullscreen;
 	}